@@ -74,6 +74,25 @@ protected:
 
 
     virtual void setMembers_(const Config &);
+
+    /**
+     * Sets the schedule for the compute loop which uses schedule(runtime).
+     * By default, iterations are assigned dynamically. When built with
+     * NUMA support, stations are partitioned statically so that threads
+     * work on the stations whose memory they have first touched.
+     *
+     * The schedule is left untouched if the user has set OMP_SCHEDULE.
+     * Otherwise, the previous schedule is saved and should be put back with
+     * restoreLoopSchedule_ after the loop, so that other loops with
+     * schedule(runtime) in the process are not affected.
+     */
+    void setLoopSchedule_();
+    void restoreLoopSchedule_();
+
+private:
+    bool schedule_saved_ = false;
+    int saved_schedule_kind_ = 0;
+    int saved_schedule_chunk_ = 0;
 };
 
 #endif /* ANEN_H */
@@ -59,6 +59,14 @@ public:
     friend std::ostream& operator<<(std::ostream&, const AnEnIS &);
 
     AnEnIS & operator=(const AnEnIS & rhs);
+
+    /**
+     * Restores the original station order of results. This is used when
+     * stations of forecasts and observations are reordered before compute,
+     * for example, with Functions::spaceFillingOrder.
+     * @param order The original station index at each position
+     */
+    virtual void restoreStationOrder(const std::vector<std::size_t> & order);
     
     /*
      * Member variable getter functions
@@ -78,11 +86,21 @@ public:
     bool prevent_search_future() const;
     bool no_norm() const;
     const std::vector<double> & weights() const;
-    const Array4DPointer & sds() const;
-    const Array4DPointer & sims_metric() const;
-    const Array4DPointer & sims_time_index() const;
-    const Array4DPointer & analogs_value() const;
-    const Array4DPointer & analogs_time_index() const;
+    const Array4DPointer & sds() const &;
+    const Array4DPointer & sims_metric() const &;
+    const Array4DPointer & sims_time_index() const &;
+    const Array4DPointer & analogs_value() const &;
+    const Array4DPointer & analogs_time_index() const &;
+
+    /**
+     * When called on an rvalue, e.g. std::move(anen).analogs_value(), the
+     * result array is moved out of the object without copying values.
+     */
+    Array4DPointer sds() &&;
+    Array4DPointer sims_metric() &&;
+    Array4DPointer sims_time_index() &&;
+    Array4DPointer analogs_value() &&;
+    Array4DPointer analogs_time_index() &&;
     const Functions::Matrix & obs_time_index_table() const;
 
     /**
@@ -43,6 +43,12 @@ public:
     
     AnEnSSE & operator=(const AnEnSSE & rhs);
 
+    /**
+     * Also restores search stations and similarity station indices. Forecast
+     * stations should have been reordered in the same way as observations.
+     */
+    virtual void restoreStationOrder(const std::vector<std::size_t> & order) override;
+
     /*
      * Member variable getter functions
      */
@@ -51,8 +57,15 @@ public:
     bool extend_obs() const;
     bool save_sims_station_index() const;
     bool exclude_closest_location() const;
-    const Array4DPointer & sims_station_index() const;
-    const Functions::Matrix & search_stations_index() const;
+    const Array4DPointer & sims_station_index() const &;
+    Array4DPointer sims_station_index() &&;
+    const Neighbors & search_stations() const;
+
+    /**
+     * Gets search stations as a table. Each row has the search stations of
+     * a station, padded with NAN.
+     */
+    Functions::Matrix search_stations_index() const;
     
     /**
      * This variable defines the index of similarity station index in the
@@ -101,10 +114,11 @@ protected:
     Array4DPointer sims_station_index_;
 
     /**
-     * A table to record the search stations for each test station. Each row is
-     * a set of search station indices for a particular test station.
+     * The search stations for each test station, sorted by distances.
+     * Stations can have fewer search stations than num_nearest_ when
+     * a distance threshold is used.
      */
-    Functions::Matrix search_stations_index_;
+    Neighbors search_stations_;
 
     virtual void preprocess_(const Forecasts & forecasts,
             const Observations & observations,
@@ -11,17 +11,29 @@
 
 #include "Array4D.h"
 
+#include <memory>
+
 using vector4 = size_t[4];
 
 /**
  * \class Array4DPointer 
  * 
  * \brief Array4DPointer is an implementation of the abstract class Array4D.
+ * 
+ * The underlying memory is reference counted. Copies share the same memory
+ * until one of them is modified, at which point the modified copy gets its
+ * own memory (copy-on-write). Moving transfers the memory without copying.
+ * 
+ * Writes through setValue or the non-const getValuesPtr trigger the copy.
+ * The copy is not thread-safe, so a shared array should be detached by
+ * calling the non-const getValuesPtr once before it is written in a
+ * parallel loop. Pointers obtained before a copy is made are not tracked.
  */
 class Array4DPointer : virtual public Array4D {
 public:
     Array4DPointer();
     Array4DPointer(const Array4DPointer& orig);
+    Array4DPointer(Array4DPointer&& orig);
     Array4DPointer(std::size_t, std::size_t, std::size_t, std::size_t);
     virtual ~Array4DPointer();
 
@@ -36,6 +48,20 @@ public:
 
     virtual void initialize(double value) override;
 
+    /**
+     * Uses existing memory for values instead of allocating new memory, for
+     * example, a memory mapped file. The memory is released by the deleter
+     * of the shared pointer when no copies are referencing it. It is treated
+     * like any other shared memory, so copies are made on writes.
+     * @param dim0 The length of the first dimension
+     * @param dim1 The length of the second dimension
+     * @param dim2 The length of the third dimension
+     * @param dim3 The length of the fourth dimension
+     * @param values The memory holding values in column-major
+     */
+    void wrap(std::size_t dim0, std::size_t dim1, std::size_t dim2, std::size_t dim3,
+            const std::shared_ptr<double> & values);
+
     virtual double getValue(std::size_t, std::size_t, std::size_t, std::size_t) const override;
     virtual void setValue(double val, std::size_t, std::size_t, std::size_t, std::size_t) override;
 
@@ -46,24 +72,40 @@ public:
     friend std::ostream & operator<<(std::ostream &, const Array4DPointer &);
 
     Array4DPointer & operator=(const Array4DPointer &);
+    Array4DPointer & operator=(Array4DPointer &&);
     bool operator==(const Array4DPointer &) const;
 
     static const double _DEFAULT_VALUE;
 
+    // Views reference the memory of this class without copying
+    friend class Array4DView;
+
 protected:
     vector4 dims_;
     double * data_;
 
     /**
-     * This variable is used to keep track of whether the data memory is 
-     * allocated internally and whether the pointer should be deleted during
-     * the de-constructor.
+     * This variable owns the data memory. It can be shared by several copies.
      */
-    bool allocated_;
+    std::shared_ptr<double> buffer_;
 
     std::size_t toIndex_(std::size_t, std::size_t, std::size_t, std::size_t) const;
 
     void allocateMemory_();
+
+    /**
+     * Makes sure the data memory is not shared with other copies. If it is
+     * shared, values are copied to a new memory owned by this object only.
+     */
+    void detach_();
+
+    /**
+     * Initializes values in parallel with a static partition along a dimension.
+     * This is also where memory pages get placed on NUMA nodes (first-touch).
+     * @param value The value to fill
+     * @param dim The dimension to partition, usually the station dimension
+     */
+    void firstTouch_(double value, std::size_t dim);
 };
 
 #endif /* ARRAY4DPOINTER_H */
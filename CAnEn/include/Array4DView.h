@@ -0,0 +1,102 @@
+/*
+ * File:   Array4DView.h
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#ifndef ARRAY4DVIEW_H
+#define ARRAY4DVIEW_H
+
+#include "Array4DPointer.h"
+
+#include <memory>
+#include <vector>
+
+/**
+ * \class Array4DView
+ *
+ * \brief Array4DView is a read-only implementation of the abstract class
+ * Array4D. It references the memory of an Array4DPointer through index maps
+ * on each dimension, so creating a view only costs the size of the indices
+ * rather than a copy of values.
+ *
+ * If the indices on a dimension form a contiguous range, the dimension is
+ * collapsed to a stride and no index map is stored.
+ *
+ * The view keeps the referenced memory alive. Because Array4DPointer copies
+ * its memory on the first write when it is shared, modifying the parent
+ * after creating a view does not change values seen through the view.
+ *
+ * Values are not contiguous in a view, so getValuesPtr throws. Use subset
+ * to materialize values into a contiguous array.
+ */
+class Array4DView : virtual public Array4D {
+public:
+    Array4DView();
+    Array4DView(const Array4DView& orig);
+    Array4DView(const Array4DPointer & parent,
+            const std::vector<std::size_t> &, const std::vector<std::size_t> &,
+            const std::vector<std::size_t> &, const std::vector<std::size_t> &);
+    virtual ~Array4DView();
+
+    /**
+     * Points the view to a subset of the parent array.
+     * @param parent The array to be referenced
+     * @param dim0_indices Indices of the first dimension in the parent
+     * @param dim1_indices Indices of the second dimension in the parent
+     * @param dim2_indices Indices of the third dimension in the parent
+     * @param dim3_indices Indices of the fourth dimension in the parent
+     */
+    void view(const Array4DPointer & parent,
+            const std::vector<std::size_t> & dim0_indices,
+            const std::vector<std::size_t> & dim1_indices,
+            const std::vector<std::size_t> & dim2_indices,
+            const std::vector<std::size_t> & dim3_indices);
+
+    /**
+     * Whether a dimension has been collapsed to a stride.
+     * @param dim The dimension index
+     */
+    bool isStrided(std::size_t dim) const;
+
+    virtual const std::size_t* shape() const override;
+    virtual std::size_t num_elements() const override;
+
+    virtual const double* getValuesPtr() const override;
+    virtual double * getValuesPtr() override;
+
+    virtual void resize(std::size_t, std::size_t, std::size_t, std::size_t) override;
+    virtual void resize(const Array4D&) override;
+
+    virtual void initialize(double value) override;
+
+    virtual double getValue(std::size_t, std::size_t, std::size_t, std::size_t) const override;
+    virtual void setValue(double val, std::size_t, std::size_t, std::size_t, std::size_t) override;
+
+    virtual void subset(const std::vector<std::size_t>&, const std::vector<std::size_t>&,
+            const std::vector<std::size_t>&, const std::vector<std::size_t>&, Array4D&) const override;
+
+    virtual void print(std::ostream &) const override;
+    friend std::ostream & operator<<(std::ostream &, const Array4DView &);
+
+    Array4DView & operator=(const Array4DView &);
+
+protected:
+    vector4 dims_;
+
+    /**
+     * The referenced memory and the position of the first value in the view
+     */
+    std::shared_ptr<double> buffer_;
+    const double * base_;
+
+    /**
+     * For each dimension, the distance between two consecutive indices in the
+     * parent memory, and the offsets from base_ if the dimension is not strided.
+     */
+    vector4 strides_;
+    std::vector<std::size_t> offsets_[4];
+
+    std::size_t toIndex_(std::size_t, std::size_t, std::size_t, std::size_t) const;
+};
+
+#endif /* ARRAY4DVIEW_H */
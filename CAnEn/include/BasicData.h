@@ -23,6 +23,7 @@ public:
     BasicData();
     BasicData(const Parameters &, const Stations &, const Times &);
     BasicData(const BasicData& orig);
+    BasicData(BasicData&& orig);
     virtual ~BasicData();
 
     void setMembers(const Parameters &, const Stations &, const Times &);
@@ -40,6 +41,7 @@ public:
     std::size_t getTimeIndex(const Time &) const;
 
     BasicData & operator=(const BasicData &);
+    BasicData & operator=(BasicData &&);
     
     virtual void print(std::ostream &) const;
     friend std::ostream& operator<<(std::ostream&, BasicData const &);
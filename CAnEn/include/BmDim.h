@@ -1,4 +1,4 @@
-/* 
+/*
  * File:   BmDim.h
  * Author: Weiming Hu <weiming@psu.edu>
  *
@@ -16,13 +16,327 @@
 #define BOOST_NO_AUTO_PTR
 #endif
 
-#include <boost/bimap/vector_of.hpp>
-#include <boost/bimap/set_of.hpp>
-#include <boost/bimap.hpp>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+#include <functional>
 
+/**
+ * \class BmEntry
+ *
+ * \brief BmEntry is an element of a dimension. first is the index and
+ * second is the value.
+ */
 template <class T>
-using BmType = boost::bimap<boost::bimaps::vector_of<std::size_t>, T,
-        boost::bimaps::left_based>;
+struct BmEntry {
+    BmEntry() = default;
+    BmEntry(std::size_t index, const T & value) : first(index), second(value) {
+    }
 
-#endif /* BMDIM_H */
+    bool operator==(const BmEntry & rhs) const {
+        return first == rhs.first && second == rhs.second;
+    }
+
+    bool operator!=(const BmEntry & rhs) const {
+        return !(*this == rhs);
+    }
+
+    bool operator<(const BmEntry & rhs) const {
+        if (first != rhs.first) return first < rhs.first;
+        return second < rhs.second;
+    }
+
+    std::size_t first;
+    T second;
+};
+
+/**
+ * \class BmIndex
+ *
+ * \brief BmIndex stores dimension values in a contiguous vector and looks
+ * up their positions with an open addressing hash table. Values are unique.
+ * Pushing a value that already exists is ignored.
+ *
+ * The index of an entry is always its position. The index passed to
+ * push_back is ignored.
+ *
+ * Values are hashed with std::hash<T> and compared with T::operator==.
+ */
+template <class T>
+class BmIndex {
+public:
+    using value_type = BmEntry<T>;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+    using iterator = const_iterator;
+
+    BmIndex() : num_slots_(0) {
+    }
+
+    BmIndex(const BmIndex &) = default;
+    BmIndex & operator=(const BmIndex &) = default;
+
+    // The moved-from index is left empty so that it can still be used
+    BmIndex(BmIndex && rhs) : entries_(std::move(rhs.entries_)),
+    slots_(std::move(rhs.slots_)), num_slots_(rhs.num_slots_) {
+        rhs.clear();
+    }
+
+    BmIndex & operator=(BmIndex && rhs) {
+        if (this != &rhs) {
+            entries_ = std::move(rhs.entries_);
+            slots_ = std::move(rhs.slots_);
+            num_slots_ = rhs.num_slots_;
+            rhs.clear();
+        }
+
+        return *this;
+    }
+
+    const_iterator begin() const {
+        return entries_.begin();
+    }
+
+    const_iterator end() const {
+        return entries_.end();
+    }
+
+    const value_type & operator[](std::size_t index) const {
+        return entries_[index];
+    }
+
+    const value_type & at(std::size_t index) const {
+        return entries_.at(index);
+    }
+
+    std::size_t size() const {
+        return entries_.size();
+    }
+
+    bool empty() const {
+        return entries_.empty();
+    }
+
+    /**
+     * Appends a value if it does not exist yet
+     * @param entry The entry to append
+     * @return Whether the value is appended
+     */
+    bool push_back(const value_type & entry) {
+
+        // Keep the load factor under 0.5
+        if (2 * (entries_.size() + 1) > num_slots_) rehash_(2 * (entries_.size() + 1));
+
+        std::uint32_t hash = hash_(entry.second);
+        std::size_t slot = probe_(entry.second, hash);
+        if (slots_[slot].position != 0) return false;
+
+        entries_.push_back(value_type(entries_.size(), entry.second));
+        slots_[slot].position = entries_.size();
+        slots_[slot].hash = hash;
+        return true;
+    }
+
+    /**
+     * Finds the index of a value
+     * @param value The value to find
+     * @return The index, or _NPOS if the value does not exist
+     */
+    std::size_t find(const T & value) const {
+        if (entries_.empty()) return _NPOS;
+
+        std::size_t slot = probe_(value, hash_(value));
+        if (slots_[slot].position == 0) return _NPOS;
+        return slots_[slot].position - 1;
+    }
+
+    void reserve(std::size_t num) {
+        entries_.reserve(num);
+        if (2 * num > num_slots_) rehash_(2 * num);
+        return;
+    }
+
+    void clear() {
+        entries_.clear();
+        slots_.clear();
+        num_slots_ = 0;
+        return;
+    }
+
+    /**
+     * Keeps the first num entries. Dimensions can only be shrunk.
+     */
+    void resize(std::size_t num) {
+        if (num > entries_.size()) throw std::length_error("Dimensions can only be shrunk with resize. Use push_back to add values");
+
+        entries_.resize(num);
+        rehash_(num_slots_);
+        return;
+    }
+
+    bool operator==(const BmIndex & rhs) const {
+        return entries_ == rhs.entries_;
+    }
+
+    bool operator!=(const BmIndex & rhs) const {
+        return !(*this == rhs);
+    }
+
+    static constexpr std::size_t _NPOS = static_cast<std::size_t> (-1);
 
+private:
+    std::vector<value_type> entries_;
+
+    /**
+     * A slot in the hash table. The position is the index of the entry plus
+     * one, and zero marks an empty slot. The hash is kept so that values are
+     * not hashed again when the table grows and most mismatches are skipped
+     * without comparing values.
+     */
+    struct Slot {
+        std::uint32_t position;
+        std::uint32_t hash;
+    };
+
+    /**
+     * The number of slots is a power of two
+     */
+    std::vector<Slot> slots_;
+    std::size_t num_slots_;
+
+    /**
+     * Mixes bits of the hash so that regular values, like timestamps at
+     * hourly intervals, spread over slots.
+     */
+    static std::uint32_t hash_(const T & value) {
+        std::uint64_t x = std::hash<T>()(value);
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return static_cast<std::uint32_t> (x);
+    }
+
+    /**
+     * Returns the slot of the value, or the empty slot where it should go
+     */
+    std::size_t probe_(const T & value, std::uint32_t hash) const {
+        std::size_t mask = num_slots_ - 1;
+        std::size_t slot = hash & mask;
+
+        while (slots_[slot].position != 0 && (slots_[slot].hash != hash ||
+                !(entries_[slots_[slot].position - 1].second == value))) {
+            slot = (slot + 1) & mask;
+        }
+
+        return slot;
+    }
+
+    void rehash_(std::size_t min_slots) {
+        if (entries_.size() >= UINT32_MAX) throw std::length_error("Too many values in a dimension");
+
+        std::size_t num_slots = 16;
+        while (num_slots < min_slots) num_slots *= 2;
+
+        // Entries are unique, so they are placed in the first empty slot
+        std::vector<Slot> slots(num_slots, Slot{0, 0});
+        std::size_t mask = num_slots - 1;
+
+        for (std::size_t i = 0; i < num_slots_; ++i) {
+            const Slot & old_slot = slots_[i];
+            if (old_slot.position == 0 || old_slot.position > entries_.size()) continue;
+
+            std::size_t slot = old_slot.hash & mask;
+            while (slots[slot].position != 0) slot = (slot + 1) & mask;
+            slots[slot] = old_slot;
+        }
+
+        slots_.swap(slots);
+        num_slots_ = num_slots;
+
+        return;
+    }
+};
+
+template <class T>
+constexpr std::size_t BmIndex<T>::_NPOS;
+
+/**
+ * \class BmType
+ *
+ * \brief BmType is the base class for dimensions, including Parameters,
+ * Stations, and Times. Values are kept in the order of insertion with
+ * random access, and the index of a value is retrieved in constant time.
+ *
+ * Values are accessed from the member left, for example, left[i].second is
+ * the value at index i. find returns the index of a value without throwing.
+ */
+template <class T>
+class BmType {
+public:
+    using value_type = BmEntry<T>;
+    using left_const_iterator = typename BmIndex<T>::const_iterator;
+    using left_iterator = left_const_iterator;
+
+    BmType() = default;
+    BmType(const BmType &) = default;
+    BmType(BmType &&) = default;
+    virtual ~BmType() = default;
+
+    BmType & operator=(const BmType &) = default;
+    BmType & operator=(BmType &&) = default;
+
+    bool push_back(const value_type & entry) {
+        return left.push_back(entry);
+    }
+
+    /**
+     * Finds the index of a value
+     * @param value The value to find
+     * @return The index, or _NPOS if the value does not exist
+     */
+    std::size_t find(const T & value) const {
+        return left.find(value);
+    }
+
+    std::size_t size() const {
+        return left.size();
+    }
+
+    bool empty() const {
+        return left.empty();
+    }
+
+    void reserve(std::size_t num) {
+        left.reserve(num);
+        return;
+    }
+
+    void resize(std::size_t num) {
+        left.resize(num);
+        return;
+    }
+
+    void clear() {
+        left.clear();
+        return;
+    }
+
+    bool operator==(const BmType & rhs) const {
+        return left == rhs.left;
+    }
+
+    bool operator!=(const BmType & rhs) const {
+        return left != rhs.left;
+    }
+
+    static constexpr std::size_t _NPOS = BmIndex<T>::_NPOS;
+
+    BmIndex<T> left;
+};
+
+template <class T>
+constexpr std::size_t BmType<T>::_NPOS;
+
+#endif /* BMDIM_H */
@@ -61,6 +61,10 @@ public:
     std::size_t flt_radius;
     std::size_t num_nearest;
 
+    // The number of station chunks per worker for dynamic load balancing
+    // in AnEnISMPI. 0 partitions stations statically.
+    std::size_t dynamic_chunks;
+
     double distance;
     
     std::vector<double> weights;
@@ -34,6 +34,7 @@ class Forecasts : virtual public Array4D, public BasicData {
 public:
     Forecasts();
     Forecasts(Forecasts const & orig);
+    Forecasts(Forecasts && orig);
     Forecasts(const Parameters &, const Stations &,
             const Times &, const Times &);
     
@@ -116,6 +117,7 @@ public:
 #endif
 
     Forecasts & operator=(const Forecasts &);
+    Forecasts & operator=(Forecasts &&);
     
     virtual void print(std::ostream &) const;
     friend std::ostream& operator<<(std::ostream&, Forecasts const &);
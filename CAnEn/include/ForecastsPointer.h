@@ -23,13 +23,24 @@ class ForecastsPointer : virtual public Forecasts, virtual public Array4DPointer
 public:
     ForecastsPointer();
     ForecastsPointer(const ForecastsPointer& orig);
+    ForecastsPointer(ForecastsPointer&& orig);
     ForecastsPointer(const Parameters &, const Stations &, const Times &, const Times &);
     virtual ~ForecastsPointer();
 
     virtual void setDimensions(
             const Parameters & parameters, const Stations & stations,
             const Times & times, const Times & flts) override;
+
+    /**
+     * Sets dimensions and uses existing memory for values instead of
+     * allocating new memory. See Array4DPointer::wrap.
+     */
+    void wrap(const Parameters & parameters, const Stations & stations,
+            const Times & times, const Times & flts,
+            const std::shared_ptr<double> & values);
     
+    virtual void initialize(double value) override;
+
     virtual void windTransform(
             const std::string & name_u, const std::string & name_v,
             const std::string & name_spd, const std::string & name_dir) override;
@@ -40,6 +51,13 @@ public:
     virtual void print(std::ostream &) const override;
     friend std::ostream & operator<<(std::ostream &, const ForecastsPointer &);
 
+    /**
+     * Copies share the data values until either side is modified. Moves
+     * transfer the data values without copying.
+     */
+    ForecastsPointer & operator=(const ForecastsPointer &);
+    ForecastsPointer & operator=(ForecastsPointer &&);
+
     static const size_t _DIM_PARAMETER;
     static const size_t _DIM_STATION;
     static const size_t _DIM_TIME;
@@ -0,0 +1,63 @@
+/*
+ * File:   ForecastsView.h
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#ifndef FORECASTSVIEW_H
+#define FORECASTSVIEW_H
+
+#include "Forecasts.h"
+#include "Array4DView.h"
+#include "ForecastsPointer.h"
+
+/**
+ * \class ForecastsView
+ *
+ * \brief ForecastsView is a read-only subset of ForecastsPointer. It holds
+ * the subset dimensions and references values in the parent forecasts
+ * through Array4DView, so subsetting stations or times does not copy values.
+ *
+ * A view can be passed to AnEn::compute like any other Forecasts. Functions
+ * that modify values, like windTransform and setDimensions, throw.
+ */
+class ForecastsView : virtual public Forecasts, virtual public Array4DView {
+public:
+    ForecastsView();
+    ForecastsView(const ForecastsView& orig);
+    ForecastsView(const ForecastsPointer & parent, const Parameters &,
+            const Stations &, const Times &, const Times &);
+    virtual ~ForecastsView();
+
+    /**
+     * Points the view to a subset of the parent forecasts. Dimensions do not
+     * need to be sorted, but they must exist in the parent.
+     * @param parent The forecasts to be referenced
+     * @param parameters The parameters to view
+     * @param stations The stations to view
+     * @param times The times to view
+     * @param flts The lead times to view
+     */
+    void view(const ForecastsPointer & parent, const Parameters & parameters,
+            const Stations & stations, const Times & times, const Times & flts);
+
+    virtual void setDimensions(
+            const Parameters & parameters, const Stations & stations,
+            const Times & times, const Times & flts) override;
+
+    virtual void windTransform(
+            const std::string & name_u, const std::string & name_v,
+            const std::string & name_spd, const std::string & name_dir) override;
+
+    virtual void subset(Forecasts& forecasts_subset) const override;
+    virtual void subset(const Parameters &, const Stations &, const Times&, const Times&, Forecasts &) const override;
+
+    virtual void print(std::ostream &) const override;
+    friend std::ostream & operator<<(std::ostream &, const ForecastsView &);
+
+    ForecastsView & operator=(const ForecastsView &);
+
+private:
+    void subset_data_(const Parameters &, const Stations &, const Times &, const Times &, Forecasts &) const;
+};
+
+#endif /* FORECASTSVIEW_H */
@@ -31,6 +31,8 @@
 #include "Config.h"
 #include "Forecasts.h"
 #include "Observations.h"
+#include "Neighbors.h"
+#include "StationsIndex.h"
 
 #include <unordered_map> 
 #include <vector>
@@ -82,6 +84,22 @@ namespace Functions {
     void toValues(Array4D &, std::size_t, const Array4D&, const Observations&);
     void toValues(Array4D &, std::size_t, const Array4D&, const Array4D&, const Observations&);
 
+    /**
+     * Set the search stations based on distance and nearest neighbors.
+     * @param stations Stations to find neighbors
+     * @param neighbors Neighbor lists of all stations
+     * @param num_nearest The maximum number of neighbors for each station
+     * @param distance Distance threshold.
+     * @param exclude_closest_location Whether to exclude search from the closest station.
+     * @param metric The distance metric.
+     * @param save_distances Whether to store distances in neighbor lists.
+     */
+    void setSearchStations(const Stations & stations, Neighbors & neighbors,
+            std::size_t num_nearest, double distance,
+            bool exclude_closest_location = false,
+            StationsIndex::Metric metric = StationsIndex::Metric::Euclidean,
+            bool save_distances = false);
+
     /**
      * Set the search stations based on distance and nearest neighbors.
      * @param stations Stations to find neighbors
@@ -90,18 +108,69 @@ namespace Functions {
      * @param distance Distance threshold.
      * @param exclude_closest_location Whether to exclude search from the closest station.
      * This station is usually the current station itself.
+     * @param metric The distance metric. Neighbors are found with a StationsIndex.
+     */
+    void setSearchStations(const Stations & stations, Matrix & table, double distance,
+            bool exclude_closest_location = false,
+            StationsIndex::Metric metric = StationsIndex::Metric::Euclidean);
+
+    /**
+     * Copies neighbor lists to a table. Each row of the table has the
+     * neighbors of a station. Cells without neighbors are not changed.
+     * @param neighbors Neighbor lists
+     * @param table An index table with enough rows and columns
      */
-    void setSearchStations(const Stations & stations, Matrix & table, double distance, bool exclude_closest_location = false);
+    void toMatrix(const Neighbors & neighbors, Matrix & table);
 
     /**
-     * Find the index of the closest station.
+     * Find the index of the closest station. When distances are equal,
+     * the station with a smaller index is chosen.
+     * 
+     * The version for a single station computes all distances. The version
+     * for multiple target stations builds a StationsIndex from the pool.
+     * 
      * @param station The target station
      * @param stations The pool of stations to search from
      * @Param verbose Verbose level
+     * @param metric The distance metric
      * @return An index of the closest station from the pool
      */
     std::size_t findClosest(const Station & station, const Stations & stations);
-    std::vector<std::size_t> findClosest(const Stations & targets, const Stations & pool, Verbose verbose);
+    std::vector<std::size_t> findClosest(const Stations & targets, const Stations & pool, Verbose verbose,
+            StationsIndex::Metric metric = StationsIndex::Metric::Euclidean);
+
+    /**
+     * Orders stations along a Hilbert curve so that stations close in space
+     * are also close in memory. Coordinates are scaled to the bounding box
+     * of all stations. Stations with NAN coordinates are put at the end in
+     * their original order.
+     *
+     * @param stations Stations to order
+     * @param order The original station index at each new position
+     */
+    void spaceFillingOrder(const Stations & stations, std::vector<std::size_t> & order);
+
+    /**
+     * Moves values along a dimension of an array. Values at the position i
+     * are moved to the position order[i]. This restores the original order
+     * of values that were reordered with spaceFillingOrder.
+     *
+     * @param arr The array to reorder
+     * @param dim The dimension to reorder
+     * @param order A permutation of the dimension length
+     */
+    void permute(Array4D & arr, std::size_t dim, const std::vector<std::size_t> & order);
+
+    /**
+     * Reorders stations of forecasts or observations, including values.
+     * The station at the new position i is the station order[i].
+     *
+     * @param forecasts Forecasts to reorder
+     * @param observations Observations to reorder
+     * @param order The current station index at each new position
+     */
+    void reorderStations(Forecasts & forecasts, const std::vector<std::size_t> & order);
+    void reorderStations(Observations & observations, const std::vector<std::size_t> & order);
 
     /**
      * Convert an integer to Verbose and vice versa
@@ -113,6 +182,29 @@ namespace Functions {
     int vtoi(Verbose);
     std::string vtos(Verbose);
 
+    /**
+     * Maps combinations of forecast times and lead times to observation
+     * time indices in bulk. Combinations that are not found in observation
+     * times are marked with Times::_NPOS. No exceptions are used for misses.
+     *
+     * When both forecast times and observation times are in ascending order,
+     * each lead time is mapped with a merge join. Otherwise, indices are
+     * looked up from the hash index of observation times.
+     *
+     * @param fcst_times Forecast Times.
+     * @param fcst_times_index The indices to compute mapping.
+     * @param fcst_flts Forecast FLTs.
+     * @param obs_times Observation Times.
+     * @param mapping The observation time indices with forecast times in rows
+     * and forecast lead times in columns, stored in row-major.
+     */
+    void mapTimes(
+            const Times & fcst_times,
+            const std::vector<std::size_t> & fcst_times_index,
+            const Times & fcst_flts,
+            const Times & obs_times,
+            std::vector<std::size_t> & mapping);
+
     /**
      * Computes a lookup table which maps from forecast time and lead time
      * indices to observation time indices. If the observation time index is
@@ -268,6 +360,15 @@ namespace Functions {
     int getEndIndex(int total, int num_procs, int rank);
     int getSubTotal(int grand_total, int num_procs, int rank);
 
+    /**
+     * Advises the kernel to back a large buffer with transparent huge pages.
+     * Only the 2 MB aligned interior of the buffer is advised. This is a
+     * no-op on platforms without madvise(MADV_HUGEPAGE).
+     * @param ptr Start of the buffer
+     * @param bytes Length of the buffer in bytes
+     */
+    void adviseHugePages(void * ptr, std::size_t bytes);
+
     /**************************************************************************
      *                          Template Functions                            *
      **************************************************************************/
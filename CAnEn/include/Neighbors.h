@@ -0,0 +1,76 @@
+/*
+ * File:   Neighbors.h
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#ifndef NEIGHBORS_H
+#define NEIGHBORS_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * \class Neighbors
+ *
+ * \brief Neighbors stores the neighbor stations of each station in the
+ * compressed sparse row format. Neighbors of the station i are
+ * indices[offsets[i]] to indices[offsets[i + 1] - 1], sorted by distances.
+ * Stations can have different numbers of neighbors, so no padding is needed.
+ *
+ * Distances are stored alongside indices if they are requested when
+ * neighbors are computed. Otherwise, distances are empty.
+ */
+class Neighbors {
+public:
+    Neighbors() : offsets(1, 0) {
+    }
+
+    /**
+     * Gets the number of stations
+     */
+    std::size_t size() const {
+        return offsets.size() - 1;
+    }
+
+    /**
+     * Gets the number of neighbors of a station
+     */
+    std::size_t count(std::size_t station_i) const {
+        return offsets[station_i + 1] - offsets[station_i];
+    }
+
+    /**
+     * Gets the maximum number of neighbors over all stations
+     */
+    std::size_t maxCount() const {
+        std::size_t max_count = 0;
+        for (std::size_t i = 0; i < size(); ++i) if (count(i) > max_count) max_count = count(i);
+        return max_count;
+    }
+
+    const std::uint32_t * begin(std::size_t station_i) const {
+        return indices.data() + offsets[station_i];
+    }
+
+    const std::uint32_t * end(std::size_t station_i) const {
+        return indices.data() + offsets[station_i + 1];
+    }
+
+    void clear() {
+        offsets.assign(1, 0);
+        indices.clear();
+        distances.clear();
+        return;
+    }
+
+    bool operator==(const Neighbors & rhs) const {
+        return offsets == rhs.offsets && indices == rhs.indices && distances == rhs.distances;
+    }
+
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint32_t> indices;
+    std::vector<double> distances;
+};
+
+#endif /* NEIGHBORS_H */
@@ -21,10 +21,14 @@ class Observations : public BasicData {
 public:
     Observations();
     Observations(const Observations& orig);
+    Observations(Observations&& orig);
     Observations(const Parameters &, const Stations &, const Times &);
 
     virtual ~Observations();
 
+    Observations & operator=(const Observations &);
+    Observations & operator=(Observations &&);
+
     /**************************************************************************
      *                          Pure Virtual Functions                        *
      **************************************************************************/
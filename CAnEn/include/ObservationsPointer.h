@@ -11,6 +11,8 @@
 
 #include "Observations.h"
 
+#include <memory>
+
 using vector3 = size_t[3];
 
 /**
@@ -19,11 +21,15 @@ using vector3 = size_t[3];
  * \brief ObservationsPointer is an implementation of the abstract class
  * Observations. The underlying storage uses a pointer which is optimized 
  * for performance.
+ * 
+ * Like Array4DPointer, the memory is reference counted and copied on the
+ * first write when it is shared by several copies.
  */
 class ObservationsPointer : virtual public Observations {
 public:
     ObservationsPointer();
     ObservationsPointer(const ObservationsPointer& orig);
+    ObservationsPointer(ObservationsPointer&& orig);
     ObservationsPointer(const Parameters &, const Stations &, const Times &);
     virtual ~ObservationsPointer();
 
@@ -37,6 +43,13 @@ public:
 
     virtual void initialize(double) override;
 
+    /**
+     * Sets dimensions and uses existing memory for values instead of
+     * allocating new memory. See Array4DPointer::wrap.
+     */
+    void wrap(const Parameters & parameters, const Stations & stations,
+            const Times & times, const std::shared_ptr<double> & values);
+
     virtual double getValue(std::size_t parameter_index,
             std::size_t station_index, std::size_t time_index) const override;
     virtual void setValue(double val, std::size_t parameter_index,
@@ -49,6 +62,9 @@ public:
     virtual void print(std::ostream &) const override;
     friend std::ostream & operator<<(std::ostream &, const ObservationsPointer &);
 
+    ObservationsPointer & operator=(const ObservationsPointer &);
+    ObservationsPointer & operator=(ObservationsPointer &&);
+
     static const size_t _DIM_PARAMETER;
     static const size_t _DIM_STATION;
     static const size_t _DIM_TIME;
@@ -58,15 +74,14 @@ protected:
     double * data_;
 
     /**
-     * This variable is used to keep track of whether the data memory is 
-     * allocated internally and whether the pointer should be deleted during
-     * the de-constructor.
+     * This variable owns the data memory. It can be shared by several copies.
      */
-    bool allocated_;
+    std::shared_ptr<double> buffer_;
 
     size_t toIndex_(size_t dim0, size_t dim1, size_t dim2) const;
 
     void allocateMemory_();
+    void detach_();
 
     void subset_data_(const Parameters &, const Stations &, const Times &, Observations &) const;
     void subset_data_(const std::vector<std::size_t>&,
@@ -67,12 +67,21 @@ private:
     bool circular_;
 };
 
+namespace std {
+    template <>
+    struct hash<Parameter> {
+        std::size_t operator()(const Parameter & parameter) const {
+            return std::hash<std::string>()(parameter.getName());
+        }
+    };
+}
+
 /**
  * \class Parameters
  * 
- * \brief Parameters class stores Parameter objects. It is a bidirectional map
- * implemented from Boost so that it provides fast translation from and to 
- * its underlying Time object.
+ * \brief Parameters class stores Parameter objects. Values are stored in a
+ * contiguous vector with a hash table, so that it provides fast translation
+ * from and to its underlying Parameter object.
  * 
  * Parameters class support the following features:
  * 1. Parameter is unique.
@@ -82,8 +91,13 @@ private:
 class Parameters : public BmType<Parameter> {
 public:
     Parameters() = default;
+    Parameters(const Parameters &) = default;
+    Parameters(Parameters &&) = default;
     virtual ~Parameters() = default;
 
+    Parameters & operator=(const Parameters &) = default;
+    Parameters & operator=(Parameters &&) = default;
+
     void push_back(const Parameter &);
 
     std::size_t getIndex(const Parameter &) const;
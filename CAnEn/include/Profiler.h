@@ -46,6 +46,14 @@
 #define _UNKNOWN_OS_
 #endif
 
+/*
+ * Per NUMA node memory usage is read from /proc/self/numa_maps which is
+ * only available on Linux.
+ */
+#if defined(_ENABLE_NUMA) && (defined(__linux__) || defined(__linux) || defined(linux) || defined(__gnu_linux__))
+#define _NUMA_MAPS_
+#endif
+
 
 class Profiler {
 public:
@@ -56,6 +64,12 @@ public:
     void log_time_session(const std::string & session_name);
     void append_sessions(const Profiler &);
     void operator+=(const Profiler &);
+
+    /**
+     * Logs the busy and idle wall time in seconds of each rank, e.g. MPI
+     * processes. They are reported after sessions in the summary.
+     */
+    void log_rank_times(const std::vector<double> & busy, const std::vector<double> & idle);
     
     void summary(std::ostream &) const;
     
@@ -73,6 +87,16 @@ private:
     std::size_t getPeakRSS_();
 #endif
 
+#if defined(_NUMA_MAPS_)
+    // Resident bytes on each NUMA node for each session
+    std::vector< std::vector<std::size_t> > node_memory_;
+
+    void getNodeMemory_(std::vector<std::size_t> &);
+#endif
+
+    std::vector<double> rank_busy_;
+    std::vector<double> rank_idle_;
+
     int max_name_width_() const;
 };
 
@@ -26,11 +26,13 @@ class Station {
 public:
     Station();
     Station(Station const &);
+    Station(Station &&) = default;
     Station(double, double, std::string name = Config::_NAME);
 
     virtual ~Station();
 
     Station & operator=(const Station &);
+    Station & operator=(Station &&) = default;
     bool operator==(const Station &) const;
     bool operator!=(const Station &) const;
     bool operator<(const Station &) const;
@@ -49,12 +51,31 @@ private:
     std::string name_;
 };
 
+namespace std {
+    template <>
+    struct hash<Station> {
+        std::size_t operator()(const Station & station) const {
+            /*
+             * Only coordinates are hashed. Stations at the same location with
+             * different names are told apart by comparison. Positive and
+             * negative zeros are equal, so they have the same hash.
+             */
+            double x = station.getX() == 0 ? 0 : station.getX();
+            double y = station.getY() == 0 ? 0 : station.getY();
+
+            std::size_t h = std::hash<double>()(x);
+            h ^= std::hash<double>()(y) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+}
+
 /**
  * \class Stations
  * 
- * \brief Stations class stores Station objects. It is a bidirectional map
- * implemented from Boost so that it provides fast translation from and to
- * its underlying Station object.
+ * \brief Stations class stores Station objects. Values are stored in a
+ * contiguous vector with a hash table, so that it provides fast translation
+ * from and to its underlying Station object.
  * 
  * Stations class support the following features:
  * 1. Station is unique;
@@ -64,8 +85,13 @@ private:
 class Stations : public BmType<Station> {
 public:
     Stations() = default;
+    Stations(const Stations &) = default;
+    Stations(Stations &&) = default;
     virtual ~Stations() = default;
 
+    Stations & operator=(const Stations &) = default;
+    Stations & operator=(Stations &&) = default;
+
     void push_back(const Station &);
 
     /**
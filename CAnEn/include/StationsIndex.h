@@ -0,0 +1,125 @@
+/*
+ * File:   StationsIndex.h
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#ifndef STATIONSINDEX_H
+#define STATIONSINDEX_H
+
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+#include "Stations.h"
+
+/**
+ * \class StationsIndex
+ *
+ * \brief StationsIndex is a k-d tree built from station coordinates. It
+ * finds the nearest stations in logarithmic time, instead of computing
+ * distances to all stations.
+ *
+ * Two metrics are supported. The Euclidean metric uses x and y as planar
+ * coordinates and distances are in the same unit as coordinates. The great
+ * circle metric uses x as longitude and y as latitude in degrees, and
+ * distances are in kilometers.
+ *
+ * Stations with NAN coordinates are not indexed. When several stations are
+ * equally close, the station with a smaller index comes first.
+ */
+class StationsIndex {
+public:
+
+    enum class Metric {
+        Euclidean, GreatCircle
+    };
+
+    /**
+     * A neighbor is a pair of the distance and the station index
+     */
+    using Neighbor = std::pair<double, std::size_t>;
+
+    StationsIndex();
+    StationsIndex(const Stations & stations, Metric metric = Metric::Euclidean);
+    StationsIndex(const StationsIndex& orig) = default;
+    virtual ~StationsIndex();
+
+    StationsIndex & operator=(const StationsIndex & rhs) = default;
+
+    /**
+     * Builds the index from stations. The previous index is discarded.
+     * @param stations Stations to index
+     * @param metric The distance metric
+     */
+    void build(const Stations & stations, Metric metric = Metric::Euclidean);
+
+    /**
+     * Gets the number of indexed stations
+     * @return The number of stations with valid coordinates
+     */
+    std::size_t size() const;
+    Metric getMetric() const;
+
+    /**
+     * Finds the closest station
+     * @param station The target station
+     * @return The index of the closest station, or _NPOS if no station
+     * has been indexed.
+     */
+    std::size_t nearest(const Station & station) const;
+
+    /**
+     * Finds the k nearest stations
+     * @param station The target station
+     * @param k The number of nearest stations to find
+     * @param neighbors Neighbors sorted by distances in ascending order.
+     * There can be fewer than k neighbors.
+     * @param max_distance Neighbors further than this distance are not
+     * returned. NAN means no limit.
+     */
+    void nearest(const Station & station, std::size_t k,
+            std::vector<Neighbor> & neighbors, double max_distance = NAN) const;
+
+    static const std::size_t _NPOS;
+    static const double _EARTH_RADIUS;
+
+protected:
+    Metric metric_;
+
+    /**
+     * The number of coordinates for each station. This is 2 for planar
+     * coordinates and 3 for points on the unit sphere.
+     */
+    std::size_t num_dims_;
+
+    /**
+     * Nodes are stored in an implicit balanced tree. The root of a range
+     * [begin, end) is at the middle, with the left branch before it and
+     * the right branch after it. For each node, these are the coordinates,
+     * the original station index, and the splitting dimension.
+     */
+    std::vector<double> coords_;
+    std::vector<std::size_t> stations_index_;
+    std::vector<std::uint8_t> split_dims_;
+
+    /**
+     * Converts a station to coordinates used in the tree
+     * @return Whether the coordinates are valid
+     */
+    bool toCoords_(const Station & station, double * coords) const;
+
+    /**
+     * Converts between distances and the squared distances in the tree
+     */
+    double toTreeDistance_(double distance) const;
+    double fromTreeDistance_(double tree_distance) const;
+
+    void build_(std::size_t begin, std::size_t end, std::vector<std::size_t> & order,
+            const std::vector<double> & coords);
+
+    void search_(std::size_t begin, std::size_t end, const double * query,
+            std::size_t k, double max_dist_sq, std::vector<Neighbor> & heap) const;
+};
+
+#endif /* STATIONSINDEX_H */
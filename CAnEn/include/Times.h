@@ -52,12 +52,21 @@ public:
     static const std::string _origin;
 };
 
+namespace std {
+    template <>
+    struct hash<Time> {
+        std::size_t operator()(const Time & time) const {
+            return std::hash<std::size_t>()(time.timestamp);
+        }
+    };
+}
+
 /**
  * \class Times
  * 
- * \brief Times class is used to store Time. It is a bidirectional map
- * implemented from Boost so that it provides fast translation from and to
- * its underlying Time object.
+ * \brief Times class is used to store Time. Values are stored in a
+ * contiguous vector with a hash table, so that it provides fast translation
+ * from and to its underlying Time object.
  * 
  * Times class supports the following features:
  * 1. Time is unique;
@@ -70,12 +79,17 @@ class Times : public BmType<Time> {
 public:
     Times() = default;
     Times(const Times &) = default;
+    Times(Times &&) = default;
     virtual ~Times() = default;
+
+    Times & operator=(const Times &) = default;
+    Times & operator=(Times &&) = default;
     
     void push_back(const Time &);
 
     /**
-     * Retrieve the associated index with a Time object.
+     * Retrieve the associated index with a Time object. It throws
+     * range_error when the Time does not exist. Use find to get _NPOS instead.
      * @param time A Time object
      * @return an index
      */
@@ -6,9 +6,15 @@
  * Created on January 7, 2020, 2:07 PM
  */
 
+#include <cstdlib>
+
 #include "AnEn.h"
 #include "Functions.h"
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 using namespace std;
 
 AnEn::AnEn() {
@@ -63,3 +69,34 @@ AnEn::setMembers_(const Config & config) {
     verbose_ = config.verbose;
     return;
 }
+
+void
+AnEn::setLoopSchedule_() {
+#if defined(_OPENMP)
+    // Respect the schedule chosen by the user
+    if (getenv("OMP_SCHEDULE") != nullptr) return;
+
+    omp_sched_t kind;
+    omp_get_schedule(&kind, &saved_schedule_chunk_);
+    saved_schedule_kind_ = kind;
+    schedule_saved_ = true;
+
+#if defined(_ENABLE_NUMA)
+    omp_set_schedule(omp_sched_static, 0);
+#else
+    omp_set_schedule(omp_sched_dynamic, 1);
+#endif
+#endif
+    return;
+}
+
+void
+AnEn::restoreLoopSchedule_() {
+#if defined(_OPENMP)
+    if (schedule_saved_) {
+        omp_set_schedule((omp_sched_t) saved_schedule_kind_, saved_schedule_chunk_);
+        schedule_saved_ = false;
+    }
+#endif
+    return;
+}
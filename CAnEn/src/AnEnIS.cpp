@@ -145,8 +145,10 @@ AnEnIS::compute(const Forecasts & forecasts,
     size_t counter = 0, current_percent = 0;
     size_t pbar_threshold = total_count * 0.01;
 
+    setLoopSchedule_();
+
 #if defined(_OPENMP)
-#pragma omp parallel for default(none) schedule(dynamic) collapse(3) \
+#pragma omp parallel for default(none) schedule(runtime) collapse(3) \
 shared(num_stations, num_flts, num_test_times_index, num_search_times_index, \
 fcsts_test_index, fcsts_search_index, forecasts, observations, circulars, \
 total_count, counter, current_percent, pbar_threshold, std::cout) firstprivate(sims_arr)
@@ -272,6 +274,8 @@ total_count, counter, current_percent, pbar_threshold, std::cout) firstprivate(s
         } // End loop of lead times
     } // End loop of stations
 
+    restoreLoopSchedule_();
+
     if (verbose_ >= Verbose::Detail) cout << '\r' << "Progress: 100%" << endl;
     if (verbose_ >= Verbose::Progress) cout << "AnEnIS generation done!" << endl;
     profiler_.log_time_session("Generating analogs (AnEnIS)");
@@ -350,6 +354,8 @@ AnEnIS::operator=(const AnEnIS& rhs) {
         quick_sort_ = rhs.quick_sort_;
         prevent_search_future_ = rhs.prevent_search_future_;
         no_norm_ = rhs.no_norm_;
+
+        // Result arrays share memory with the right hand side until modified
         sds_ = rhs.sds_;
         sds_time_index_map_ = rhs.sds_time_index_map_;
         sims_metric_ = rhs.sims_metric_;
@@ -361,6 +367,19 @@ AnEnIS::operator=(const AnEnIS& rhs) {
     return *this;
 }
 
+void
+AnEnIS::restoreStationOrder(const vector<size_t> & order) {
+
+    // Stations are the first dimension of results and the second of sds
+    if (save_analogs_) Functions::permute(analogs_value_, 0, order);
+    if (save_analogs_time_index_) Functions::permute(analogs_time_index_, 0, order);
+    if (save_sims_) Functions::permute(sims_metric_, 0, order);
+    if (save_sims_time_index_) Functions::permute(sims_time_index_, 0, order);
+    if (sds_.num_elements() != 0) Functions::permute(sds_, 1, order);
+
+    return;
+}
+
 size_t AnEnIS::num_analogs() const {
     return num_analogs_;
 }
@@ -422,19 +441,19 @@ const vector<double>& AnEnIS::weights() const {
 }
 
 const Array4DPointer &
-AnEnIS::sds() const {
+AnEnIS::sds() const & {
     return sds_;
 }
 
 const Array4DPointer &
-AnEnIS::sims_metric() const {
+AnEnIS::sims_metric() const & {
     if (!save_sims_) throw runtime_error(
             "Similarity array is not saved. Please change your configuration (save_sims)");
     return sims_metric_;
 }
 
 const Array4DPointer &
-AnEnIS::sims_time_index() const {
+AnEnIS::sims_time_index() const & {
     if (!save_sims_time_index_) throw runtime_error(
             "Similarity times index array is not saved. Please change your configuration (save_sims_time_index)");
 
@@ -442,7 +461,7 @@ AnEnIS::sims_time_index() const {
 }
 
 const Array4DPointer &
-AnEnIS::analogs_value() const {
+AnEnIS::analogs_value() const & {
     if (!save_analogs_) throw runtime_error(
             "Analog array is not saved. Please change your configuration (save_analogs)");
 
@@ -450,13 +469,43 @@ AnEnIS::analogs_value() const {
 }
 
 const Array4DPointer &
-AnEnIS::analogs_time_index() const {
+AnEnIS::analogs_time_index() const & {
     if (!save_analogs_time_index_) throw runtime_error(
             "Analog times index array is not saved. Please change your configuration (save_analogs_time_index)");
 
     return analogs_time_index_;
 }
 
+Array4DPointer
+AnEnIS::sds() && {
+    return std::move(sds_);
+}
+
+Array4DPointer
+AnEnIS::sims_metric() && {
+    // Reuse the checks from the const version
+    static_cast<const AnEnIS &> (*this).sims_metric();
+    return std::move(sims_metric_);
+}
+
+Array4DPointer
+AnEnIS::sims_time_index() && {
+    static_cast<const AnEnIS &> (*this).sims_time_index();
+    return std::move(sims_time_index_);
+}
+
+Array4DPointer
+AnEnIS::analogs_value() && {
+    static_cast<const AnEnIS &> (*this).analogs_value();
+    return std::move(analogs_value_);
+}
+
+Array4DPointer
+AnEnIS::analogs_time_index() && {
+    static_cast<const AnEnIS &> (*this).analogs_time_index();
+    return std::move(analogs_time_index_);
+}
+
 const Functions::Matrix &
 AnEnIS::obs_time_index_table() const {
     return obs_time_index_table_;
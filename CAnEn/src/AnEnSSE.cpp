@@ -54,7 +54,10 @@ AnEnSSE::compute(const Forecasts & forecasts,
     vector<bool> circulars;
     forecasts.getParameters().getCirculars(circulars);
 
-    size_t num_stations = forecasts.getStations().size();
+    // Analogs are computed for stations with search stations. Forecasts can
+    // have more stations that are only searched, e.g. halo stations with MPI.
+    //
+    size_t num_stations = search_stations_.size();
     size_t num_flts = forecasts.getFLTs().size();
     size_t num_test_times_index = fcsts_test_index.size();
     size_t num_search_times_index = fcsts_search_index.size();
@@ -75,8 +78,10 @@ AnEnSSE::compute(const Forecasts & forecasts,
     if (verbose_ >= Verbose::Detail) print(cout);
     if (verbose_ >= Verbose::Progress) cout << "Computing analogs ..." << endl;
 
+    setLoopSchedule_();
+
 #if defined(_OPENMP)
-#pragma omp parallel for default(none) schedule(dynamic) collapse(3) \
+#pragma omp parallel for default(none) schedule(runtime) collapse(3) \
 shared(num_stations, num_flts, num_test_times_index, num_search_times_index, \
 fcsts_test_index, fcsts_search_index, forecasts, observations, circulars) \
 firstprivate(sims_arr)
@@ -101,18 +106,21 @@ firstprivate(sims_arr)
                 size_t search_entry_i = 0;
 
                 /*
-                 * Compute similarity for all search times and all search stations
+                 * Compute similarity for all search stations and all search times.
+                 * Search stations are in the outer loop so that forecasts of a
+                 * search station stay in cache for all search times.
                  */
-                for (size_t search_time_i = 0; search_time_i < num_search_times_index; ++search_time_i) {
-                    size_t current_search_index = fcsts_search_index[search_time_i];
+                const auto & search_stations_end = search_stations_.end(station_i);
+
+                for (auto it = search_stations_.begin(station_i); it != search_stations_end; ++it) {
+                    size_t current_search_station_index = *it;
 
-                    for (size_t search_station_i = 0; search_station_i < num_nearest_; ++search_station_i) {
-                        double current_search_station_index = search_stations_index_(station_i, search_station_i);
-                        if (std::isnan(current_search_station_index)) continue;
+                    size_t current_obs_station_index;
+                    if (extend_obs_) current_obs_station_index = current_search_station_index;
+                    else current_obs_station_index = station_i;
 
-                        size_t current_obs_station_index;
-                        if (extend_obs_) current_obs_station_index = current_search_station_index;
-                        else current_obs_station_index = station_i;
+                    for (size_t search_time_i = 0; search_time_i < num_search_times_index; ++search_time_i) {
+                        size_t current_search_index = fcsts_search_index[search_time_i];
 
                         /*
                          * Comparing to the test forecast itself is strictly forbidden
@@ -190,6 +198,8 @@ firstprivate(sims_arr)
         } // End of loop for flts
     } // End of loop for stations
 
+    restoreLoopSchedule_();
+
     if (verbose_ >= Verbose::Progress) cout << "AnEnSSE generation done!" << endl;
     profiler_.log_time_session("Genrating analogs (AnEnSSE)");
 
@@ -209,9 +219,8 @@ AnEnSSE::print(ostream & os) const {
             << Config::_SAVE_SIMS_STATION_IND << ": " << save_sims_station_index_ << endl;
 
     if (verbose_ >= Verbose::Debug) {
-        os << "search stations index table dimensions: ["
-                << search_stations_index_.size1() << ","
-                << search_stations_index_.size2() << "]" << endl;
+        os << "search stations: " << search_stations_.size() << " stations with "
+                << search_stations_.indices.size() << " neighbors" << endl;
 
         if (save_sims_station_index_) os << "similarity station index array dimensions: ["
                 << Functions::format(sims_station_index_.shape(), 4) << "]" << endl;
@@ -236,12 +245,61 @@ AnEnSSE &
         num_nearest_ = rhs.num_nearest_;
         distance_ = rhs.distance_;
         extend_obs_ = rhs.extend_obs_;
-        search_stations_index_ = rhs.search_stations_index_;
+        search_stations_ = rhs.search_stations_;
     }
 
     return *this;
 }
 
+void
+AnEnSSE::restoreStationOrder(const vector<size_t> & order) {
+
+    AnEnIS::restoreStationOrder(order);
+
+    if (save_sims_station_index_) {
+        Functions::permute(sims_station_index_, 0, order);
+
+        // Station indices are also converted back
+        double* ptr = sims_station_index_.getValuesPtr();
+        size_t num_elements = sims_station_index_.num_elements();
+
+        for (size_t i = 0; i < num_elements; ++i) {
+            if (!std::isnan(ptr[i])) ptr[i] = order[(size_t) ptr[i]];
+        }
+    }
+
+    // Move neighbor lists to their original stations
+    size_t num_stations = search_stations_.size();
+    if (num_stations == 0) return;
+
+    vector<size_t> position(num_stations);
+    for (size_t i = 0; i < num_stations; ++i) position[order[i]] = i;
+
+    Neighbors restored;
+    restored.offsets.reserve(num_stations + 1);
+    restored.indices.reserve(search_stations_.indices.size());
+    restored.distances.reserve(search_stations_.distances.size());
+
+    for (size_t station_i = 0; station_i < num_stations; ++station_i) {
+        size_t i = position[station_i];
+
+        for (auto it = search_stations_.begin(i); it != search_stations_.end(i); ++it) {
+            restored.indices.push_back(order[*it]);
+        }
+
+        if (!search_stations_.distances.empty()) {
+            restored.distances.insert(restored.distances.end(),
+                    search_stations_.distances.begin() + search_stations_.offsets[i],
+                    search_stations_.distances.begin() + search_stations_.offsets[i + 1]);
+        }
+
+        restored.offsets.push_back(restored.indices.size());
+    }
+
+    search_stations_ = std::move(restored);
+    return;
+}
+
 size_t
 AnEnSSE::num_nearest() const {
     return num_nearest_;
@@ -263,16 +321,29 @@ AnEnSSE::save_sims_station_index() const {
 }
 
 const Array4DPointer &
-AnEnSSE::sims_station_index() const {
+AnEnSSE::sims_station_index() const & {
     if (!save_sims_station_index_) throw runtime_error(
             "Similarity stations index array is not saved. Please change your configuration");
 
     return sims_station_index_;
 }
 
-const Functions::Matrix &
+Array4DPointer
+AnEnSSE::sims_station_index() && {
+    static_cast<const AnEnSSE &> (*this).sims_station_index();
+    return std::move(sims_station_index_);
+}
+
+const Neighbors &
+AnEnSSE::search_stations() const {
+    return search_stations_;
+}
+
+Functions::Matrix
 AnEnSSE::search_stations_index() const {
-    return search_stations_index_;
+    Functions::Matrix table(search_stations_.size(), num_nearest_, NAN);
+    Functions::toMatrix(search_stations_, table);
+    return table;
 }
 
 void
@@ -286,15 +357,8 @@ AnEnSSE::preprocess_(const Forecasts & forecasts,
 
     // Find search stations for each test stations
     if (verbose_ >= Verbose::Progress) cout << "Computing search stations ..." << endl;
-    const Stations & stations = forecasts.getStations();
-    search_stations_index_.resize(stations.size(), num_nearest_);
-
-    // Initialize the values to NAN
-    auto & storage = search_stations_index_.data();
-    fill_n(storage.begin(), storage.size(), NAN);
-
-    // Set search stations for each test stations
-    Functions::setSearchStations(stations, search_stations_index_, distance_, exclude_closest_location_);
+    Functions::setSearchStations(forecasts.getStations(), search_stations_,
+            num_nearest_, distance_, exclude_closest_location_);
 
     return;
 }
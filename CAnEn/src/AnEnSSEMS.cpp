@@ -100,8 +100,10 @@ AnEnSSEMS::compute(const Forecasts & forecasts,
     if (verbose_ >= Verbose::Detail) print(cout);
     if (verbose_ >= Verbose::Progress) cout << "Computing analogs ..." << endl;
 
+    setLoopSchedule_();
+
 #if defined(_OPENMP)
-#pragma omp parallel for default(none) schedule(dynamic) collapse(3) \
+#pragma omp parallel for default(none) schedule(runtime) collapse(3) \
 shared(num_obs_stations, num_flts, num_test_times_index, num_search_times_index, \
 fcsts_test_index, fcsts_search_index, forecasts, observations, circulars) \
 firstprivate(sims_arr)
@@ -127,14 +129,17 @@ firstprivate(sims_arr)
                 size_t search_entry_i = 0;
 
                 /*
-                 * Compute similarity for all search times and all search stations
+                 * Compute similarity for all search stations and all search times.
+                 * Search stations are in the outer loop so that forecasts of a
+                 * search station stay in cache for all search times.
                  */
-                for (size_t search_time_i = 0; search_time_i < num_search_times_index; ++search_time_i) {
-                    size_t current_search_index = fcsts_search_index[search_time_i];
+                const auto & search_stations_end = search_stations_.end(fcst_station_i);
+
+                for (auto it = search_stations_.begin(fcst_station_i); it != search_stations_end; ++it) {
+                    size_t current_search_station_index = *it;
 
-                    for (size_t search_station_i = 0; search_station_i < num_nearest_; ++search_station_i) {
-                        double current_search_station_index = search_stations_index_(fcst_station_i, search_station_i);
-                        if (std::isnan(current_search_station_index)) continue;
+                    for (size_t search_time_i = 0; search_time_i < num_search_times_index; ++search_time_i) {
+                        size_t current_search_index = fcsts_search_index[search_time_i];
 
                         /*
                          * Comparing to the test forecast itself is strictly forbidden
@@ -211,6 +216,8 @@ firstprivate(sims_arr)
         } // End of loop for flts
     } // End of loop for stations
 
+    restoreLoopSchedule_();
+
     if (verbose_ >= Verbose::Progress) cout << "AnEnSSEMS generation done!" << endl;
     profiler_.log_time_session("Genrating analogs (AnEnSSEMS)");
 
@@ -7,12 +7,17 @@
  */
 
 #include "Array4DPointer.h"
+#include "Functions.h"
 
 #include <cmath>
 #include <cstring>
 #include <stdexcept>
 #include <algorithm>
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 using namespace std;
 
 const double Array4DPointer::_DEFAULT_VALUE = NAN;
@@ -20,21 +25,22 @@ const double Array4DPointer::_DEFAULT_VALUE = NAN;
 Array4DPointer::Array4DPointer() : Array4D() {
     fill_n(dims_, 4, 0);
     data_ = nullptr;
-    allocated_ = false;
 }
 
 Array4DPointer::Array4DPointer(const Array4DPointer& rhs) : Array4D(rhs) {
     *this = rhs;
 }
 
+Array4DPointer::Array4DPointer(Array4DPointer&& rhs) : Array4D(rhs) {
+    *this = std::move(rhs);
+}
+
 Array4DPointer::Array4DPointer(size_t dim0, size_t dim1, size_t dim2, size_t dim3) :
 Array4D() {
-    allocated_ = false;
     resize(dim0, dim1, dim2, dim3);
 }
 
 Array4DPointer::~Array4DPointer() {
-    if (allocated_) delete [] data_;
 }
 
 const size_t*
@@ -54,6 +60,7 @@ Array4DPointer::getValuesPtr() const {
 
 double*
 Array4DPointer::getValuesPtr() {
+    detach_();
     return data_;
 }
 
@@ -81,7 +88,24 @@ Array4DPointer::resize(const Array4D& arr) {
 
 void
 Array4DPointer::initialize(double value) {
-    if (data_ != nullptr) fill_n(data_, num_elements(), value);
+    // Result arrays are organized as [stations, test times, lead times, members]
+    firstTouch_(value, 0);
+    return;
+}
+
+void
+Array4DPointer::wrap(size_t dim0, size_t dim1, size_t dim2, size_t dim3,
+        const shared_ptr<double> & values) {
+
+    dims_[0] = dim0;
+    dims_[1] = dim1;
+    dims_[2] = dim2;
+    dims_[3] = dim3;
+
+    buffer_ = values;
+    data_ = buffer_.get();
+
+    return;
 }
 
 double
@@ -92,6 +116,7 @@ Array4DPointer::getValue(size_t dim0, size_t dim1, size_t dim2, size_t dim3) con
 void
 Array4DPointer::setValue(double val,
         size_t dim0, size_t dim1, size_t dim2, size_t dim3) {
+    detach_();
     data_[toIndex_(dim0, dim1, dim2, dim3)] = val;
     return;
 }
@@ -159,13 +184,65 @@ Array4DPointer::toIndex_(size_t dim0, size_t dim1, size_t dim2, size_t dim3) con
 void
 Array4DPointer::allocateMemory_() {
 
-    // Allocate memory for underlying data structure
-    if (allocated_) delete [] data_;
-
+    // Allocate memory for underlying data structure. The previous memory
+    // is released when no other copies are sharing it.
+    //
     size_t total = num_elements();
-    data_ = new double [total];
+    buffer_.reset(new double [total], default_delete<double[]>());
+    data_ = buffer_.get();
+
+#if defined(_ENABLE_NUMA)
+    Functions::adviseHugePages(data_, total * sizeof (double));
+#endif
+
+    return;
+}
+
+void
+Array4DPointer::detach_() {
+
+    if (buffer_.use_count() <= 1) return;
+
+    // Keep a reference to the shared memory while making a private copy
+    shared_ptr<double> shared = buffer_;
+    allocateMemory_();
+    memcpy(data_, shared.get(), sizeof (double) * num_elements());
+
+    return;
+}
+
+void
+Array4DPointer::firstTouch_(double value, size_t dim) {
+
+    if (data_ == nullptr) return;
+
+    // All values are overwritten, so a shared memory is replaced without copying
+    if (buffer_.use_count() > 1) allocateMemory_();
+
+    /*
+     * The array is stored in column-major. For each index along the partition
+     * dimension, values are laid out in contiguous blocks of length stride,
+     * and there are num_blocks of them separated by len * stride.
+     */
+    size_t len = dims_[dim], stride = 1, num_blocks = 1;
+    for (size_t i = 0; i < dim; ++i) stride *= dims_[i];
+    for (size_t i = dim + 1; i < 4; ++i) num_blocks *= dims_[i];
+
+    /*
+     * Memory pages are placed on the NUMA node of the thread that first
+     * writes to them. The static schedule hands out the same ranges along
+     * the partition dimension as the static schedule in the compute loop, so
+     * each thread later works on memory local to its socket.
+     */
+#if defined(_OPENMP)
+#pragma omp parallel for default(none) schedule(static) shared(len, stride, num_blocks, value)
+#endif
+    for (size_t index = 0; index < len; ++index) {
+        for (size_t block_i = 0; block_i < num_blocks; ++block_i) {
+            fill_n(data_ + (block_i * len + index) * stride, stride, value);
+        }
+    }
 
-    allocated_ = true;
     return;
 }
 
@@ -212,11 +289,27 @@ Array4DPointer::operator=(const Array4DPointer & rhs) {
         // Copy dimensions
         memcpy(dims_, rhs.dims_, 4 * sizeof (size_t));
 
-        // Copy values
-        data_ = new double [rhs.num_elements()];
-        memcpy(data_, rhs.data_, sizeof (double) * rhs.num_elements());
+        // Share values. They will be copied when either side is modified.
+        buffer_ = rhs.buffer_;
+        data_ = rhs.data_;
+    }
+
+    return *this;
+}
+
+Array4DPointer &
+Array4DPointer::operator=(Array4DPointer && rhs) {
+
+    if (this != &rhs) {
+
+        // Take over dimensions and values
+        memcpy(dims_, rhs.dims_, 4 * sizeof (size_t));
+        buffer_ = std::move(rhs.buffer_);
+        data_ = rhs.data_;
 
-        allocated_ = true;
+        // Leave the right hand side empty
+        fill_n(rhs.dims_, 4, 0);
+        rhs.data_ = nullptr;
     }
 
     return *this;
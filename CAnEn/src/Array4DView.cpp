@@ -0,0 +1,232 @@
+/*
+ * File:   Array4DView.cpp
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#include "Array4DView.h"
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+
+using namespace std;
+
+static const string _READ_ONLY_MSG = "Array4DView is read-only. Use subset to materialize values";
+
+Array4DView::Array4DView() : Array4D() {
+    fill_n(dims_, 4, 0);
+    fill_n(strides_, 4, 0);
+    base_ = nullptr;
+}
+
+Array4DView::Array4DView(const Array4DView& orig) : Array4D(orig) {
+    *this = orig;
+}
+
+Array4DView::Array4DView(const Array4DPointer & parent,
+        const vector<size_t> & dim0_indices, const vector<size_t> & dim1_indices,
+        const vector<size_t> & dim2_indices, const vector<size_t> & dim3_indices) :
+Array4D() {
+    view(parent, dim0_indices, dim1_indices, dim2_indices, dim3_indices);
+}
+
+Array4DView::~Array4DView() {
+}
+
+void
+Array4DView::view(const Array4DPointer & parent,
+        const vector<size_t> & dim0_indices, const vector<size_t> & dim1_indices,
+        const vector<size_t> & dim2_indices, const vector<size_t> & dim3_indices) {
+
+    const vector<size_t> * indices[4] = {&dim0_indices, &dim1_indices, &dim2_indices, &dim3_indices};
+    const size_t * parent_dims = parent.shape();
+
+    // Strides of the parent memory in column-major
+    vector4 parent_strides;
+    parent_strides[0] = 1;
+    for (size_t dim = 1; dim < 4; ++dim) parent_strides[dim] = parent_strides[dim - 1] * parent_dims[dim - 1];
+
+    size_t base_offset = 0;
+
+    for (size_t dim = 0; dim < 4; ++dim) {
+
+        const vector<size_t> & dim_indices = *(indices[dim]);
+        offsets_[dim].clear();
+        dims_[dim] = dim_indices.size();
+        strides_[dim] = parent_strides[dim];
+
+        // Make sure indices are within the parent
+        for (auto index : dim_indices) {
+            if (index >= parent_dims[dim]) {
+                ostringstream msg;
+                msg << "Index " << index << " is out of bound on dimension #" << dim
+                        << " with length " << parent_dims[dim];
+                throw range_error(msg.str());
+            }
+        }
+
+        if (dim_indices.empty()) continue;
+
+        // Check whether the indices form a contiguous range
+        bool contiguous = true;
+        for (size_t i = 1; i < dim_indices.size() && contiguous; ++i) {
+            contiguous = (dim_indices[i] == dim_indices[i - 1] + 1);
+        }
+
+        if (contiguous) {
+            // Collapse this dimension to a stride from the first index
+            base_offset += dim_indices.front() * parent_strides[dim];
+
+        } else {
+            // Keep the offset of each index
+            offsets_[dim].resize(dim_indices.size());
+            for (size_t i = 0; i < dim_indices.size(); ++i) offsets_[dim][i] = dim_indices[i] * parent_strides[dim];
+        }
+    }
+
+    // Reference the parent memory
+    buffer_ = parent.buffer_;
+    base_ = parent.data_ == nullptr ? nullptr : parent.data_ + base_offset;
+
+    return;
+}
+
+bool
+Array4DView::isStrided(size_t dim) const {
+    if (dim >= 4) throw range_error("Dimension index should be less than 4");
+    return offsets_[dim].empty();
+}
+
+const size_t*
+Array4DView::shape() const {
+    return dims_;
+}
+
+size_t
+Array4DView::num_elements() const {
+    return dims_[0] * dims_[1] * dims_[2] * dims_[3];
+}
+
+const double*
+Array4DView::getValuesPtr() const {
+    throw runtime_error("Values in Array4DView are not contiguous. Use subset to materialize values");
+}
+
+double*
+Array4DView::getValuesPtr() {
+    throw runtime_error(_READ_ONLY_MSG);
+}
+
+void
+Array4DView::resize(size_t, size_t, size_t, size_t) {
+    throw runtime_error(_READ_ONLY_MSG);
+}
+
+void
+Array4DView::resize(const Array4D &) {
+    throw runtime_error(_READ_ONLY_MSG);
+}
+
+void
+Array4DView::initialize(double) {
+    throw runtime_error(_READ_ONLY_MSG);
+}
+
+double
+Array4DView::getValue(size_t dim0, size_t dim1, size_t dim2, size_t dim3) const {
+    return base_[toIndex_(dim0, dim1, dim2, dim3)];
+}
+
+void
+Array4DView::setValue(double, size_t, size_t, size_t, size_t) {
+    throw runtime_error(_READ_ONLY_MSG);
+}
+
+void
+Array4DView::subset(const vector<size_t> & dim0_indices,
+        const vector<size_t> & dim1_indices,
+        const vector<size_t> & dim2_indices,
+        const vector<size_t> & dim3_indices,
+        Array4D & arr_subset) const {
+
+    // Allocate memory
+    arr_subset.resize(
+            dim0_indices.size(),
+            dim1_indices.size(),
+            dim2_indices.size(),
+            dim3_indices.size());
+
+    double * p_subset = arr_subset.getValuesPtr();
+
+    // Loop through the data in column-major
+    for (size_t dim3_i : dim3_indices)
+        for (size_t dim2_i : dim2_indices)
+            for (size_t dim1_i : dim1_indices)
+                for (size_t dim0_i : dim0_indices) {
+                    *p_subset = getValue(dim0_i, dim1_i, dim2_i, dim3_i);
+                    p_subset++;
+                }
+
+    return;
+}
+
+void
+Array4DView::print(ostream & os) const {
+    os << "[Array4DView] shape [" << dims_[0] << "," << dims_[1] << ","
+            << dims_[2] << "," << dims_[3] << "] strided [" << isStrided(0) << ","
+            << isStrided(1) << "," << isStrided(2) << "," << isStrided(3) << "]" << endl;
+
+    for (size_t l = 0; l < dims_[0]; ++l) {
+        for (size_t m = 0; m < dims_[1]; ++m) {
+            os << "[" << l << "," << m << ",,]" << endl;
+
+            for (size_t p = 0; p < dims_[3]; ++p) os << "\t[,,," << p << "]";
+            os << endl;
+
+            for (size_t o = 0; o < dims_[2]; ++o) {
+                os << "[,," << o << ",]\t";
+
+                for (size_t p = 0; p < dims_[3]; ++p) {
+                    os << getValue(l, m, o, p) << "\t";
+                }
+
+                os << endl;
+            }
+
+            os << endl;
+        }
+    }
+
+    return;
+}
+
+ostream &
+operator<<(ostream & os, const Array4DView & obj) {
+    obj.print(os);
+    return os;
+}
+
+Array4DView &
+Array4DView::operator=(const Array4DView & rhs) {
+
+    if (this != &rhs) {
+        memcpy(dims_, rhs.dims_, 4 * sizeof (size_t));
+        memcpy(strides_, rhs.strides_, 4 * sizeof (size_t));
+        for (size_t dim = 0; dim < 4; ++dim) offsets_[dim] = rhs.offsets_[dim];
+
+        buffer_ = rhs.buffer_;
+        base_ = rhs.base_;
+    }
+
+    return *this;
+}
+
+size_t
+Array4DView::toIndex_(size_t dim0, size_t dim1, size_t dim2, size_t dim3) const {
+    // Strided dimensions are offsets from the first index. Others are looked up.
+    return (offsets_[0].empty() ? dim0 : offsets_[0][dim0]) +
+            (offsets_[1].empty() ? dim1 * strides_[1] : offsets_[1][dim1]) +
+            (offsets_[2].empty() ? dim2 * strides_[2] : offsets_[2][dim2]) +
+            (offsets_[3].empty() ? dim3 * strides_[3] : offsets_[3][dim3]);
+}
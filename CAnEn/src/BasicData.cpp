@@ -22,6 +22,12 @@ BasicData::BasicData(const BasicData& orig) {
     }
 }
 
+BasicData::BasicData(BasicData&& orig) :
+parameters_(std::move(orig.parameters_)),
+stations_(std::move(orig.stations_)),
+times_(std::move(orig.times_)) {
+}
+
 BasicData::BasicData(const Parameters & parameters, const Stations & stations, const Times & times) {
     setMembers(parameters, stations, times);
 }
@@ -93,6 +99,17 @@ BasicData::operator=(const BasicData & rhs) {
     return *this;
 }
 
+BasicData &
+BasicData::operator=(BasicData && rhs) {
+    if (this != &rhs) {
+        parameters_ = std::move(rhs.parameters_);
+        stations_ = std::move(rhs.stations_);
+        times_ = std::move(rhs.times_);
+    }
+
+    return *this;
+}
+
 void
 BasicData::print(ostream &os) const {
     os << parameters_;
@@ -111,6 +111,7 @@ Config::print(ostream & os) {
             << "save_obs_time_index_table: " << (save_obs_time_index_table ? "true" : "false") << endl
             << "save_search_stations_index: " << (save_search_stations_index ? "true" : "false") << endl
             << "no_norm: " << (no_norm ? "true" : "false") << endl
+            << "dynamic_chunks: " << dynamic_chunks << endl
             << "weights: " << (weights.size() > 0 ? Functions::format(weights) : "[equally weighted with 1s]") << endl
             << "verbose: " << Functions::vtoi(verbose) << " (" << Functions::vtos(verbose) << ")" << endl;
     return;
@@ -167,6 +168,7 @@ Config::reset() {
     save_obs_time_index_table = false;
     save_search_stations_index = false;
     no_norm = false;
+    dynamic_chunks = 0;
     verbose = Verbose::Warning;
     worker_verbose = Verbose::Warning;
 
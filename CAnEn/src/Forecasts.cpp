@@ -46,6 +46,13 @@ Forecasts::Forecasts(const Forecasts & orig) : Array4D(orig), BasicData(orig) {
     }
 }
 
+Forecasts::Forecasts(Forecasts && orig) : Array4D(orig), BasicData(std::move(orig)),
+flts_(std::move(orig.flts_)) {
+#if !defined(_DISABLE_GRID)
+    grid_ = std::move(orig.grid_);
+#endif
+}
+
 Forecasts::Forecasts(const Parameters & parameters, const Stations & stations,
         const Times & times, const Times & flts) :
 Array4D(), BasicData(parameters, stations, times), flts_(flts) {
@@ -498,6 +505,20 @@ Forecasts::operator=(const Forecasts & rhs) {
     return *this;
 }
 
+Forecasts &
+Forecasts::operator=(Forecasts && rhs) {
+
+    if (this != &rhs) {
+        BasicData::operator=(std::move(rhs));
+        flts_ = std::move(rhs.flts_);
+#if !defined(_DISABLE_GRID)
+        grid_ = std::move(rhs.grid_);
+#endif
+    }
+
+    return *this;
+}
+
 void
 Forecasts::print(ostream &os) const {
     os << "[Forecasts] size: [" <<
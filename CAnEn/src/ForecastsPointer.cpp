@@ -30,6 +30,10 @@ ForecastsPointer::ForecastsPointer(const ForecastsPointer& orig) :
 Forecasts(orig), Array4DPointer(orig) {
 }
 
+ForecastsPointer::ForecastsPointer(ForecastsPointer&& orig) :
+Forecasts(std::move(orig)), Array4DPointer(std::move(orig)) {
+}
+
 ForecastsPointer::ForecastsPointer(
         const Parameters & parameters, const Stations & stations,
         const Times & times, const Times & flts) :
@@ -54,6 +58,27 @@ ForecastsPointer::setDimensions(
     return;
 }
 
+void
+ForecastsPointer::wrap(
+        const Parameters & parameters, const Stations & stations,
+        const Times & times, const Times & flts,
+        const shared_ptr<double> & values) {
+
+    // Set members in the parent class
+    setMembers(parameters, stations, times);
+    flts_ = flts;
+
+    Array4DPointer::wrap(parameters_.size(), stations_.size(), times_.size(), flts_.size(), values);
+    return;
+}
+
+void
+ForecastsPointer::initialize(double value) {
+    // Pages are first touched following the station partition of the compute loop
+    firstTouch_(value, _DIM_STATION);
+    return;
+}
+
 void 
 ForecastsPointer::windTransform(
         const string & name_u, const string & name_v,
@@ -99,7 +124,12 @@ ForecastsPointer::windTransform(
     /*
      * Carry out the actual calculation and replace values in data with 
      * wind speed and direction values.
+     *
+     * Values are modified in parallel, so make sure the memory is not
+     * shared before entering the parallel region.
      */
+    detach_();
+
     size_t num_stations = stations_.size();
     size_t num_times = times_.size();
     size_t num_flts = flts_.size();
@@ -188,6 +218,28 @@ operator<<(ostream & os, const ForecastsPointer & obj) {
     return os;
 }
 
+ForecastsPointer &
+ForecastsPointer::operator=(const ForecastsPointer & rhs) {
+
+    if (this != &rhs) {
+        Forecasts::operator=(rhs);
+        Array4DPointer::operator=(rhs);
+    }
+
+    return *this;
+}
+
+ForecastsPointer &
+ForecastsPointer::operator=(ForecastsPointer && rhs) {
+
+    if (this != &rhs) {
+        Forecasts::operator=(std::move(rhs));
+        Array4DPointer::operator=(std::move(rhs));
+    }
+
+    return *this;
+}
+
 void
 ForecastsPointer::subset_data_(const Parameters & parameters, const Stations & stations, const Times & times, const Times & flts,
         Forecasts & forecasts_subset) const {
@@ -0,0 +1,132 @@
+/*
+ * File:   ForecastsView.cpp
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#include "ForecastsView.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+ForecastsView::ForecastsView() : Forecasts(), Array4DView() {
+}
+
+ForecastsView::ForecastsView(const ForecastsView& orig) :
+Forecasts(orig), Array4DView(orig) {
+}
+
+ForecastsView::ForecastsView(const ForecastsPointer & parent,
+        const Parameters & parameters, const Stations & stations,
+        const Times & times, const Times & flts) :
+Forecasts(), Array4DView() {
+    view(parent, parameters, stations, times, flts);
+}
+
+ForecastsView::~ForecastsView() {
+}
+
+void
+ForecastsView::view(const ForecastsPointer & parent,
+        const Parameters & parameters, const Stations & stations,
+        const Times & times, const Times & flts) {
+
+    // Get the indices for dimensions in the parent
+    vector<size_t> parameters_index, stations_index, times_index, flts_index;
+
+    parent.getParameters().getIndices(parameters, parameters_index);
+    parent.getStations().getIndices(stations, stations_index);
+    parent.getTimes().getIndices(times, times_index);
+    parent.getFLTs().getIndices(flts, flts_index);
+
+    // Reference values
+    Array4DView::view(parent, parameters_index, stations_index, times_index, flts_index);
+
+    // Set members in the parent class
+    setMembers(parameters, stations, times);
+    flts_ = flts;
+
+#if !defined(_DISABLE_GRID)
+    grid_ = parent.getGrid();
+#endif
+
+    return;
+}
+
+void
+ForecastsView::setDimensions(const Parameters &, const Stations &, const Times &, const Times &) {
+    throw runtime_error("ForecastsView is read-only. Use subset to create a ForecastsPointer");
+}
+
+void
+ForecastsView::windTransform(const string &, const string &, const string &, const string &) {
+    throw runtime_error("ForecastsView is read-only. Use subset to create a ForecastsPointer before wind transformation");
+}
+
+void
+ForecastsView::subset(Forecasts& forecasts_subset) const {
+
+    // Get dimension variables
+    const Parameters & parameters_subset = forecasts_subset.getParameters();
+    const Stations & stations_subset = forecasts_subset.getStations();
+    const Times & times_subset = forecasts_subset.getTimes();
+    const Times & flts_subset = forecasts_subset.getFLTs();
+
+    subset_data_(parameters_subset, stations_subset, times_subset, flts_subset, forecasts_subset);
+    return;
+}
+
+void
+ForecastsView::subset(const Parameters & parameters, const Stations & stations, const Times& times, const Times& flts,
+        Forecasts & forecasts_subset) const {
+
+    // Allocate memory
+    forecasts_subset.setDimensions(parameters, stations, times, flts);
+
+    subset_data_(parameters, stations, times, flts, forecasts_subset);
+    return;
+}
+
+void
+ForecastsView::print(ostream & os) const {
+    Forecasts::print(os);
+    Array4DView::print(os);
+    return;
+}
+
+ostream &
+operator<<(ostream & os, const ForecastsView & obj) {
+    obj.print(os);
+    return os;
+}
+
+ForecastsView &
+ForecastsView::operator=(const ForecastsView & rhs) {
+
+    if (this != &rhs) {
+        Forecasts::operator=(rhs);
+        Array4DView::operator=(rhs);
+    }
+
+    return *this;
+}
+
+void
+ForecastsView::subset_data_(const Parameters & parameters, const Stations & stations, const Times & times, const Times & flts,
+        Forecasts & forecasts_subset) const {
+
+    // Get the indices for dimensions to subset
+    vector<size_t> parameters_index, stations_index, times_index, flts_index;
+
+    parameters_.getIndices(parameters, parameters_index);
+    stations_.getIndices(stations, stations_index);
+    times_.getIndices(times, times_index);
+    flts_.getIndices(flts, flts_index);
+
+    // Copy values
+    Array4DView::subset(
+            parameters_index, stations_index,
+            times_index, flts_index, forecasts_subset);
+
+    return;
+}
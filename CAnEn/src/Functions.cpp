@@ -12,6 +12,7 @@
 #include <string>
 #include <limits>
 #include <sstream>
+#include <numeric>
 #include <iterator>
 #include <algorithm>
 #include <stdexcept>
@@ -27,6 +28,10 @@
 #include <omp.h>
 #endif
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 using namespace std;
 namespace bg = boost::geometry;
 namespace bgi = boost::geometry::index;
@@ -35,29 +40,6 @@ static const double _DEG2RAD = M_PI / 180;
 static const double _RAD2DEG = 180 / M_PI;
 
 
-/*
- * This definition is used to record the mapping from observation times to
- * forecast times and lead times. This is the reverse of the observation time
- * index table which goes from forecast times and lead times to observation times.
- */
-using time_arr = array<size_t, 3>;
-
-// These defines the value type on each position in the time array.
-static const size_t _VALUE_INDEX = 0;
-static const size_t _TIME_INDEX = 1;
-static const size_t _FLT_INDEX = 2;
-
-
-/*
- * This defines an operator for comparing observation time entry which is based
- * on the first position, time stamp value.
- */
-struct time_arr_compare {
-
-    bool operator()(const time_arr & lhs, const time_arr & rhs) const {
-        return lhs[_VALUE_INDEX] < rhs[_VALUE_INDEX];
-    }
-};
 
 void
 Functions::createObsMap(unordered_map<string, size_t> & map,
@@ -186,10 +168,12 @@ obs_id, analogs, observations, analogs_station_index)
 }
 
 void
-Functions::setSearchStations(const Stations & stations, Matrix & table, double distance, bool exclude_closest_location) {
+Functions::setSearchStations(const Stations & stations, Neighbors & neighbors,
+        size_t num_nearest, double distance, bool exclude_closest_location,
+        StationsIndex::Metric metric, bool save_distances) {
 
     // Determine the number of neighbors
-    size_t num_neighbors = table.size2();
+    size_t num_neighbors = num_nearest;
     size_t num_stations = stations.size();
 
     if (exclude_closest_location) {
@@ -199,8 +183,76 @@ Functions::setSearchStations(const Stations & stations, Matrix & table, double d
     if (num_neighbors > num_stations)
         throw runtime_error("Number of neighbors should not be larger than the number of stations. Not enough stations to search from.");
 
-    // Convert distance to squred distance
-    distance *= distance;
+    if (num_stations * num_nearest > UINT32_MAX)
+        throw overflow_error("Too many stations and neighbors for 32-bit neighbor lists");
+
+    // Build a spatial index so that neighbors are found without computing
+    // pair-wise station distances
+    //
+    StationsIndex index(stations, metric);
+
+    /*
+     * Each station first writes to a fixed-size block. Blocks are then
+     * compacted so that there are no gaps between stations.
+     */
+    neighbors.offsets.assign(num_stations + 1, 0);
+    neighbors.indices.resize(num_stations * num_nearest);
+    if (save_distances) neighbors.distances.resize(num_stations * num_nearest);
+    else neighbors.distances.clear();
+
+    size_t neighbor_start = (exclude_closest_location ? 1 : 0);
+
+#if defined(_OPENMP)
+#pragma omp parallel for default(none) schedule(static) \
+shared(num_stations, num_neighbors, num_nearest, stations, index, neighbors, distance, \
+neighbor_start, save_distances)
+#endif
+    for (size_t test_i = 0; test_i < num_stations; ++test_i) {
+
+        // Neighbors are sorted based on distances
+        vector<StationsIndex::Neighbor> results;
+        index.nearest(stations.getStation(test_i), num_neighbors, results, distance);
+
+        // Copy neighbor stations index to the block of this station
+        size_t pos = test_i * num_nearest;
+
+        for (size_t neighbor_i = neighbor_start; neighbor_i < results.size(); ++neighbor_i, ++pos) {
+            neighbors.indices[pos] = results[neighbor_i].second;
+            if (save_distances) neighbors.distances[pos] = results[neighbor_i].first;
+        }
+
+        neighbors.offsets[test_i + 1] = pos - test_i * num_nearest;
+    }
+
+    // Compact blocks. A station never moves after its original block.
+    for (size_t test_i = 0; test_i < num_stations; ++test_i) {
+        size_t count = neighbors.offsets[test_i + 1];
+        size_t from = test_i * num_nearest, to = neighbors.offsets[test_i];
+
+        if (from != to) {
+            copy_n(neighbors.indices.begin() + from, count, neighbors.indices.begin() + to);
+            if (save_distances) copy_n(neighbors.distances.begin() + from, count, neighbors.distances.begin() + to);
+        }
+
+        neighbors.offsets[test_i + 1] = to + count;
+    }
+
+    neighbors.indices.resize(neighbors.offsets.back());
+    neighbors.indices.shrink_to_fit();
+
+    if (save_distances) {
+        neighbors.distances.resize(neighbors.offsets.back());
+        neighbors.distances.shrink_to_fit();
+    }
+
+    return;
+}
+
+void
+Functions::setSearchStations(const Stations & stations, Matrix & table, double distance,
+        bool exclude_closest_location, StationsIndex::Metric metric) {
+
+    size_t num_stations = stations.size();
 
     // Check the rows of the table
     if (table.size1() != num_stations) {
@@ -210,43 +262,22 @@ Functions::setSearchStations(const Stations & stations, Matrix & table, double d
         throw overflow_error(msg.str());
     }
 
-    // Initialize a vector to store the distances and the indices
-    vector< pair<double, size_t> > distances_sq(num_stations);
-
-    for (size_t test_i = 0; test_i < num_stations; ++test_i) {
-
-        const Station & test = stations.getStation(test_i);
+    Neighbors neighbors;
+    setSearchStations(stations, neighbors, table.size2(), distance, exclude_closest_location, metric);
+    toMatrix(neighbors, table);
 
-        // Calculate pair-wise station distances
-        for (size_t search_i = 0; search_i < num_stations; ++search_i) {
-            const Station & search = stations.getStation(search_i);
-
-            distances_sq[search_i].first =
-                    pow(test.getX() - search.getX(), 2) +
-                    pow(test.getY() - search.getY(), 2);
-            distances_sq[search_i].second = search_i;
-        }
+    return;
+}
 
-        // Sort based on distances
-        partial_sort(distances_sq.begin(), distances_sq.begin() + num_neighbors, distances_sq.end(),
-                [](const pair<double, size_t> & lhs, const pair<double, size_t> & rhs) {
-                    return lhs.first < rhs.first;
-                });
+void
+Functions::toMatrix(const Neighbors & neighbors, Matrix & table) {
 
-        // Copy neighbor stations index to the output table
+    // Copy neighbor stations index to the output table
+    for (size_t test_i = 0; test_i < neighbors.size(); ++test_i) {
         size_t current_pos = 0;
-        size_t neighbor_i;
-
-        if (exclude_closest_location) {
-            neighbor_i = 1;
-        } else {
-            neighbor_i = 0;
-        }
 
-        for (; neighbor_i < num_neighbors; ++neighbor_i) {
-            if (distances_sq[neighbor_i].first > distance) continue;
-            table(test_i, current_pos) = distances_sq[neighbor_i].second;
-            ++current_pos;
+        for (auto it = neighbors.begin(test_i); it != neighbors.end(test_i); ++it, ++current_pos) {
+            table(test_i, current_pos) = *it;
         }
     }
 
@@ -274,14 +305,14 @@ Functions::findClosest(const Station & station, const Stations & stations) {
 
         // Skip invalid coordinates
         if (std::isnan(candidate_distance)) continue;
-        valid_result = true;
 
-        if (distance < candidate_distance) {
-            // Do nothing when the candidate distance is larger
-        } else {
+        // Keep the first station when distances are equal
+        if (!valid_result || candidate_distance < distance) {
             closest_i = station_i;
             distance = candidate_distance;
         }
+
+        valid_result = true;
     }
 
     if (!valid_result) throw runtime_error("All candidate coordinates are invalid (NAN)!");
@@ -290,7 +321,8 @@ Functions::findClosest(const Station & station, const Stations & stations) {
 }
 
 vector<size_t>
-Functions::findClosest(const Stations & targets, const Stations & pool, Verbose verbose) {
+Functions::findClosest(const Stations & targets, const Stations & pool, Verbose verbose,
+        StationsIndex::Metric metric) {
 
     if (verbose >= Verbose::Progress) cout << "Match stations based on distances ..." << endl;
 
@@ -298,17 +330,205 @@ Functions::findClosest(const Stations & targets, const Stations & pool, Verbose
     size_t num_target_stations = targets.size();
     vector<size_t> match_target_stations_with(num_target_stations);
 
+    for (const auto & target : targets.left) {
+        if (std::isnan(target.second.getX()) || std::isnan(target.second.getY())) {
+            throw runtime_error("Target station must have valid coordinates!");
+        }
+    }
+
+    StationsIndex index(pool, metric);
+    if (index.size() == 0) throw runtime_error("All candidate coordinates are invalid (NAN)!");
+
 #if defined(_OPENMP)
 #pragma omp parallel for default(none) schedule(static) \
-shared(num_target_stations, targets, pool, match_target_stations_with)
+shared(num_target_stations, targets, index, match_target_stations_with)
 #endif
     for (size_t target_i = 0; target_i < num_target_stations; ++target_i) {
-        match_target_stations_with[target_i] = Functions::findClosest(targets.getStation(target_i), pool);
+        match_target_stations_with[target_i] = index.nearest(targets.getStation(target_i));
     }
 
     return match_target_stations_with;
 }
 
+/*
+ * Computes the distance along a Hilbert curve of order 16 for a cell on the
+ * 65536 x 65536 grid.
+ */
+static uint64_t
+hilbertKey(uint32_t x, uint32_t y) {
+
+    const uint32_t n = 1u << 16;
+    uint64_t key = 0;
+
+    for (uint32_t s = n / 2; s > 0; s /= 2) {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        key += (uint64_t) s * s * ((3 * rx) ^ ry);
+
+        // Rotate the quadrant
+        if (ry == 0) {
+            if (rx == 1) {
+                x = n - 1 - x;
+                y = n - 1 - y;
+            }
+            swap(x, y);
+        }
+    }
+
+    return key;
+}
+
+void
+Functions::spaceFillingOrder(const Stations & stations, vector<size_t> & order) {
+
+    size_t num_stations = stations.size();
+
+    double x_min = numeric_limits<double>::infinity(), x_max = -x_min;
+    double y_min = x_min, y_max = -x_min;
+
+    for (const auto & station : stations.left) {
+        double x = station.second.getX(), y = station.second.getY();
+        if (std::isnan(x) || std::isnan(y)) continue;
+
+        x_min = min(x_min, x);
+        x_max = max(x_max, x);
+        y_min = min(y_min, y);
+        y_max = max(y_max, y);
+    }
+
+    // Quantize coordinates to the grid of the curve
+    const double num_cells = 65535;
+    double x_scale = (x_max > x_min ? num_cells / (x_max - x_min) : 0);
+    double y_scale = (y_max > y_min ? num_cells / (y_max - y_min) : 0);
+
+    vector<uint64_t> keys(num_stations);
+
+    for (size_t station_i = 0; station_i < num_stations; ++station_i) {
+        const Station & station = stations.getStation(station_i);
+        double x = station.getX(), y = station.getY();
+
+        if (std::isnan(x) || std::isnan(y)) {
+            keys[station_i] = numeric_limits<uint64_t>::max();
+        } else {
+            keys[station_i] = hilbertKey((uint32_t) ((x - x_min) * x_scale),
+                    (uint32_t) ((y - y_min) * y_scale));
+        }
+    }
+
+    order.resize(num_stations);
+    iota(order.begin(), order.end(), 0);
+
+    stable_sort(order.begin(), order.end(), [&keys](size_t lhs, size_t rhs) {
+        return keys[lhs] < keys[rhs];
+    });
+
+    return;
+}
+
+/*
+ * Moves values along a dimension. Values are column-major and each position
+ * of the dimension is a block of values from the preceding dimensions,
+ * repeated for the following dimensions. The position i is moved to to[i].
+ */
+static void
+permuteValues(double* ptr, size_t block, size_t len, size_t num_repeats, const vector<size_t> & to) {
+
+    vector<double> values(ptr, ptr + block * len * num_repeats);
+
+#if defined(_OPENMP)
+#pragma omp parallel for default(none) schedule(static) \
+shared(ptr, block, len, num_repeats, to, values)
+#endif
+    for (size_t repeat_i = 0; repeat_i < num_repeats; ++repeat_i) {
+        for (size_t i = 0; i < len; ++i) {
+            copy_n(values.begin() + (repeat_i * len + i) * block, block,
+                    ptr + (repeat_i * len + to[i]) * block);
+        }
+    }
+
+    return;
+}
+
+static void
+checkOrder(const vector<size_t> & order, size_t len) {
+
+    vector<bool> visited(len, false);
+    bool valid = (order.size() == len);
+
+    for (size_t i = 0; valid && i < len; ++i) {
+        valid = (order[i] < len && !visited[order[i]]);
+        if (valid) visited[order[i]] = true;
+    }
+
+    if (!valid) {
+        ostringstream msg;
+        msg << "The order is not a permutation of " << len << " elements";
+        throw runtime_error(msg.str());
+    }
+
+    return;
+}
+
+void
+Functions::permute(Array4D & arr, size_t dim, const vector<size_t> & order) {
+
+    if (dim > 3) throw out_of_range("Array4D only has 4 dimensions");
+
+    const size_t* dims = arr.shape();
+    checkOrder(order, dims[dim]);
+
+    size_t block = 1, num_repeats = 1;
+    for (size_t i = 0; i < dim; ++i) block *= dims[i];
+    for (size_t i = dim + 1; i < 4; ++i) num_repeats *= dims[i];
+
+    permuteValues(arr.getValuesPtr(), block, dims[dim], num_repeats, order);
+    return;
+}
+
+/*
+ * Reorders stations and returns where each station is moved to
+ */
+static vector<size_t>
+reorderStationsDim(Stations & stations, const vector<size_t> & order) {
+
+    size_t num_stations = stations.size();
+    checkOrder(order, num_stations);
+
+    Stations stations_sorted;
+    stations_sorted.reserve(num_stations);
+    vector<size_t> to(num_stations);
+
+    for (size_t i = 0; i < num_stations; ++i) {
+        stations_sorted.push_back(stations.getStation(order[i]));
+        to[order[i]] = i;
+    }
+
+    stations = std::move(stations_sorted);
+    return to;
+}
+
+void
+Functions::reorderStations(Forecasts & forecasts, const vector<size_t> & order) {
+
+    vector<size_t> to = reorderStationsDim(forecasts.getStations(), order);
+
+    const size_t* dims = forecasts.shape();
+    permuteValues(forecasts.getValuesPtr(), dims[0], dims[1], dims[2] * dims[3], to);
+
+    return;
+}
+
+void
+Functions::reorderStations(Observations & observations, const vector<size_t> & order) {
+
+    vector<size_t> to = reorderStationsDim(observations.getStations(), order);
+
+    permuteValues(observations.getValuesPtr(), observations.getParameters().size(),
+            to.size(), observations.getTimes().size(), to);
+
+    return;
+}
+
 Verbose
 Functions::itov(int flag) {
     switch (flag) {
@@ -365,6 +585,64 @@ Functions::vtos(Verbose verbose) {
     }
 }
 
+void
+Functions::mapTimes(
+        const Times & fcst_times, const vector<size_t> & fcst_times_index,
+        const Times & fcst_flts, const Times & obs_times, vector<size_t> & mapping) {
+
+    size_t rows = fcst_times_index.size(), cols = fcst_flts.size();
+    mapping.assign(rows * cols, Times::_NPOS);
+
+    if (rows == 0 || cols == 0 || obs_times.empty()) return;
+
+    // Collect time stamps so that they are accessed contiguously
+    vector<size_t> fcst_stamps(rows), obs_stamps(obs_times.size());
+
+    for (size_t row_i = 0; row_i < rows; ++row_i) {
+        fcst_stamps[row_i] = fcst_times.left.at(fcst_times_index[row_i]).second.timestamp;
+    }
+
+    for (size_t obs_i = 0; obs_i < obs_stamps.size(); ++obs_i) {
+        obs_stamps[obs_i] = obs_times.left[obs_i].second.timestamp;
+    }
+
+    bool merge = is_sorted(fcst_stamps.begin(), fcst_stamps.end()) &&
+            is_sorted(obs_stamps.begin(), obs_stamps.end());
+
+#if defined(_OPENMP)
+#pragma omp parallel for default(none) schedule(static) \
+shared(rows, cols, fcst_flts, fcst_stamps, obs_stamps, obs_times, mapping, merge)
+#endif
+    for (size_t col_i = 0; col_i < cols; ++col_i) {
+
+        size_t flt = fcst_flts.left[col_i].second.timestamp;
+
+        if (merge) {
+
+            /*
+             * Targets are in ascending order for a lead time, so the search
+             * range only narrows. The binary search skips large gaps when
+             * observations are much denser than forecasts.
+             */
+            auto it = obs_stamps.begin();
+            const auto & it_end = obs_stamps.end();
+
+            for (size_t row_i = 0; row_i < rows && it != it_end; ++row_i) {
+                size_t target = fcst_stamps[row_i] + flt;
+                it = lower_bound(it, it_end, target);
+                if (it != it_end && *it == target) mapping[row_i * cols + col_i] = it - obs_stamps.begin();
+            }
+
+        } else {
+            for (size_t row_i = 0; row_i < rows; ++row_i) {
+                mapping[row_i * cols + col_i] = obs_times.find(Time(fcst_stamps[row_i] + flt));
+            }
+        }
+    }
+
+    return;
+}
+
 void
 Functions::updateTimeTable(
         const Times & fcst_times, const vector<size_t> & fcst_times_index,
@@ -380,6 +658,9 @@ Functions::updateTimeTable(
         throw overflow_error(msg.str());
     }
 
+    vector<size_t> mapping;
+    mapTimes(fcst_times, fcst_times_index, fcst_flts, obs_times, mapping);
+
     // Define dimension variables so that nested parallel for-loops can be
     // perfectly collapsed (with Intel compilers)
     //
@@ -387,21 +668,16 @@ Functions::updateTimeTable(
 
 #if defined(_OPENMP)
 #pragma omp parallel for default(none) schedule(static) collapse(2) \
-shared(table, obs_times, fcst_times, fcst_flts, rows, cols, fcst_times_index)
+shared(table, mapping, rows, cols)
 #endif
     for (size_t row_i = 0; row_i < rows; ++row_i) {
         for (size_t col_i = 0; col_i < cols; ++col_i) {
 
-            try {
-                table(row_i, col_i) = obs_times.getIndex(
-                        fcst_times.left[fcst_times_index[row_i]].second +
-                        fcst_flts.left[col_i].second);
-            } catch (range_error & e) {
-                // If the time cannot be found, range_error will be generated.
-                // But nothing is done for this case so that the index value
-                // in the table simply remains intact.
-                //
-            }
+            // If the time cannot be found, the index value in the table
+            // simply remains intact.
+            //
+            size_t obs_i = mapping[row_i * cols + col_i];
+            if (obs_i != Times::_NPOS) table(row_i, col_i) = obs_i;
         }
     }
 
@@ -657,61 +933,72 @@ Functions::collapseLeadTimes(
         Observations & observations,
         const Forecasts & forecasts) {
 
-    // Calculate the unique time combination from forecast times and lead times
-    time_arr time_entry;
-    set<time_arr, time_arr_compare> unique_times;
-
     const auto & fcst_times = forecasts.getTimes();
     const auto & fcst_flts = forecasts.getFLTs();
 
+    size_t num_times = fcst_times.size(), num_flts = fcst_flts.size();
+
+    // Calculate the unique time combination from forecast times and lead times
+    vector<size_t> stamps;
+    stamps.reserve(num_times * num_flts);
+
+    for (const auto & time : fcst_times.left) {
+        for (const auto & flt : fcst_flts.left) {
+            stamps.push_back(time.second.timestamp + flt.second.timestamp);
+        }
+    }
+
+    sort(stamps.begin(), stamps.end());
+    stamps.erase(unique(stamps.begin(), stamps.end()), stamps.end());
+
+    // Insert the sorted unique times into observation times
+    Times obs_times;
+    obs_times.reserve(stamps.size());
+    for (auto stamp : stamps) obs_times.push_back(Time(stamp));
+
+    // Map all forecast times and lead times to observation times
+    vector<size_t> fcst_times_index(num_times), mapping;
+    iota(fcst_times_index.begin(), fcst_times_index.end(), 0);
+    mapTimes(fcst_times, fcst_times_index, fcst_flts, obs_times, mapping);
+
     /*
-     * Insert times from forecasts to observations.
+     * Find the source of each observation time.
      * 
      * Please note that I'm looping first on forecast lead times and then forecast
      * times because I'm giving priority to earlier forecast lead times compared
      * to later lead time that are further into the future. I will keep the values
      * that are close to the initialization time.
      */
-    for (size_t flt_i = 0; flt_i < fcst_flts.size(); ++flt_i) {
-        for (size_t time_i = 0; time_i < fcst_times.size(); ++time_i) {
+    size_t num_obs_times = obs_times.size();
+    vector<size_t> source_time(num_obs_times, Times::_NPOS), source_flt(num_obs_times);
 
-            time_entry[_TIME_INDEX] = time_i;
-            time_entry[_FLT_INDEX] = flt_i;
-            time_entry[_VALUE_INDEX] = fcst_times.getTime(time_i).timestamp
-                    + fcst_flts.getTime(flt_i).timestamp;
+    for (size_t flt_i = 0; flt_i < num_flts; ++flt_i) {
+        for (size_t time_i = 0; time_i < num_times; ++time_i) {
+            size_t obs_i = mapping[time_i * num_flts + flt_i];
 
-            unique_times.insert(time_entry);
+            if (source_time[obs_i] == Times::_NPOS) {
+                source_time[obs_i] = time_i;
+                source_flt[obs_i] = flt_i;
+            }
         }
     }
 
-    // Insert the sorted unique times into observation times
-    Times obs_times;
-    size_t time_i = 0;
-    const auto & unique_times_end = unique_times.end();
-    for (auto it = unique_times.begin(); it != unique_times_end; ++it, ++time_i) {
-        obs_times.push_back((*it)[_VALUE_INDEX]);
-    }
-
     // Set dimensions for observations
     observations.setDimensions(forecasts.getParameters(), forecasts.getStations(), obs_times);
     observations.initialize(NAN);
 
     // Copy values from forecasts
-    time_i = 0;
     size_t num_parameters = observations.getParameters().size();
     size_t num_stations = observations.getStations().size();
 
 #if defined(_OPENMP)
-#pragma omp parallel default(none) shared(unique_times, unique_times_end, \
-num_parameters, num_stations, forecasts, observations) firstprivate(time_i)
-#endif
-    for (auto it = unique_times.begin(); it != unique_times_end; ++it, ++time_i) {
-#if defined(_OPENMP)
-#pragma omp for schedule(static) collapse(2)
+#pragma omp parallel for default(none) schedule(static) \
+shared(num_obs_times, num_parameters, num_stations, source_time, source_flt, forecasts, observations)
 #endif
-        for (size_t parameter_i = 0; parameter_i < num_parameters; ++parameter_i) {
-            for (size_t station_i = 0; station_i < num_stations; ++station_i) {
-                double value = forecasts.getValue(parameter_i, station_i, (*it)[_TIME_INDEX], (*it)[_FLT_INDEX]);
+    for (size_t time_i = 0; time_i < num_obs_times; ++time_i) {
+        for (size_t station_i = 0; station_i < num_stations; ++station_i) {
+            for (size_t parameter_i = 0; parameter_i < num_parameters; ++parameter_i) {
+                double value = forecasts.getValue(parameter_i, station_i, source_time[time_i], source_flt[time_i]);
                 observations.setValue(value, parameter_i, station_i, time_i);
             }
         }
@@ -738,31 +1025,30 @@ Functions::unwrapTimeSeries(Forecasts & forecasts, const Times & times, const Ti
      * Copy data *
      * ***********/
 
-    const auto & time_series = observations.getTimes();
-    size_t ts_index = 0;
     auto num_times = times.size();
     auto num_flts = flts.size();
+    auto num_parameters = parameters.size();
+    auto num_stations = stations.size();
+
+    // Calculate the time series index for all combinations of forecast times and lead times
+    vector<size_t> times_index(num_times), mapping;
+    iota(times_index.begin(), times_index.end(), 0);
+    mapTimes(times, times_index, flts, observations.getTimes(), mapping);
 
 #if defined(_OPENMP)
 #pragma omp parallel for default(none) schedule(static) collapse(2) \
-shared(times, flts, num_times, num_flts, time_series, parameters, stations, observations, forecasts) firstprivate(ts_index)
+shared(num_times, num_flts, num_parameters, num_stations, mapping, observations, forecasts)
 #endif
     for (size_t time_i = 0; time_i < num_times; ++time_i) {
         for (size_t flt_i = 0; flt_i < num_flts; ++flt_i) {
 
-            // Calculate the time series index for this combination of forecast time and lead time
-            auto ts_time = times.getTime(time_i).timestamp + flts.getTime(flt_i).timestamp;
-
-            try {
-                ts_index = time_series.getIndex(ts_time);
-            } catch (range_error & e) {
-                // Skip writing if the index cannot be found
-                continue;
-            }
+            // Skip writing if the index cannot be found
+            size_t ts_index = mapping[time_i * num_flts + flt_i];
+            if (ts_index == Times::_NPOS) continue;
 
             // Copy value for all stations and parameters
-            for (size_t parameter_i = 0; parameter_i < parameters.size(); ++parameter_i) {
-                for (size_t station_i = 0; station_i < stations.size(); ++station_i) {
+            for (size_t station_i = 0; station_i < num_stations; ++station_i) {
+                for (size_t parameter_i = 0; parameter_i < num_parameters; ++parameter_i) {
                     double val = observations.getValue(parameter_i, station_i, ts_index);
                     forecasts.setValue(val, parameter_i, station_i, time_i, flt_i);
                 }
@@ -844,3 +1130,18 @@ Functions::getSubTotal(int total, int num_procs, int rank) {
     return getEndIndex(total, num_procs, rank) - getStartIndex(total, num_procs, rank);
 }
 
+void
+Functions::adviseHugePages(void * ptr, size_t bytes) {
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    const uintptr_t huge_page = 2 * 1024 * 1024;
+
+    uintptr_t start = (reinterpret_cast<uintptr_t> (ptr) + huge_page - 1) & ~(huge_page - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t> (ptr) + bytes) & ~(huge_page - 1);
+
+    // Failure is not an error. The buffer simply stays on regular pages.
+    if (end > start) madvise(reinterpret_cast<void *> (start), end - start, MADV_HUGEPAGE);
+#endif
+
+    return;
+}
@@ -21,9 +21,25 @@ Observations::Observations(const Observations & orig) :
 BasicData(orig) {
 }
 
+Observations::Observations(Observations && orig) :
+BasicData(std::move(orig)) {
+}
+
 Observations::~Observations() {
 }
 
+Observations &
+Observations::operator=(const Observations & rhs) {
+    BasicData::operator=(rhs);
+    return *this;
+}
+
+Observations &
+Observations::operator=(Observations && rhs) {
+    BasicData::operator=(std::move(rhs));
+    return *this;
+}
+
 void
 Observations::print(ostream& os) const {
     os << "[Observations] size: [" <<
@@ -7,8 +7,15 @@
  */
 
 #include "ObservationsPointer.h"
+#include "Functions.h"
+
+#include <cstring>
 #include <stdexcept>
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 using namespace std;
 
 const size_t ObservationsPointer::_DIM_PARAMETER = 0;
@@ -18,30 +25,31 @@ const size_t ObservationsPointer::_DIM_TIME = 2;
 ObservationsPointer::ObservationsPointer() : Observations() {
     fill_n(dims_, 3, 0);
     data_ = nullptr;
-    allocated_ = false;
 }
 
 ObservationsPointer::ObservationsPointer(const ObservationsPointer & orig) :
 Observations(orig) {
+    *this = orig;
+}
 
-    // Copy dimensions
-    memcpy(dims_, orig.dims_, 3 * sizeof (size_t));
+ObservationsPointer::ObservationsPointer(ObservationsPointer && orig) :
+Observations(std::move(orig)), buffer_(std::move(orig.buffer_)) {
 
-    // Copy values
-    data_ = new double [orig.num_elements()];
-    memcpy(data_, orig.data_, sizeof (double) * orig.num_elements());
+    // Take over values and leave the right hand side empty
+    memcpy(dims_, orig.dims_, 3 * sizeof (size_t));
+    data_ = orig.data_;
 
-    allocated_ = true;
+    fill_n(orig.dims_, 3, 0);
+    orig.data_ = nullptr;
 }
 
 ObservationsPointer::ObservationsPointer(
         const Parameters & parameters, const Stations & stations, const Times & times) :
-Observations(parameters, stations, times), allocated_(false) {
+Observations(parameters, stations, times) {
     allocateMemory_();
 }
 
 ObservationsPointer::~ObservationsPointer() {
-    if (allocated_) delete [] data_;
 }
 
 size_t
@@ -51,7 +59,28 @@ ObservationsPointer::num_elements() const {
 
 void
 ObservationsPointer::initialize(double value) {
-    if (data_ != nullptr) fill_n(data_, num_elements(), value);
+
+    if (data_ == nullptr) return;
+
+    // All values are overwritten, so a shared memory is replaced without copying
+    if (buffer_.use_count() > 1) allocateMemory_();
+
+    size_t num_parameters = dims_[_DIM_PARAMETER];
+    size_t num_stations = dims_[_DIM_STATION];
+    size_t num_times = dims_[_DIM_TIME];
+
+    // Pages are first touched following the station partition of the compute loop
+#if defined(_OPENMP)
+#pragma omp parallel for default(none) schedule(static) \
+shared(num_parameters, num_stations, num_times, value)
+#endif
+    for (size_t station_i = 0; station_i < num_stations; ++station_i) {
+        for (size_t time_i = 0; time_i < num_times; ++time_i) {
+            fill_n(data_ + toIndex_(0, station_i, time_i), num_parameters, value);
+        }
+    }
+
+    return;
 }
 
 const double*
@@ -61,6 +90,7 @@ ObservationsPointer::getValuesPtr() const {
 
 double*
 ObservationsPointer::getValuesPtr() {
+    detach_();
     return data_;
 }
 
@@ -79,6 +109,24 @@ ObservationsPointer::setDimensions(
     return;
 }
 
+void
+ObservationsPointer::wrap(
+        const Parameters & parameters, const Stations & stations,
+        const Times & times, const shared_ptr<double> & values) {
+
+    // Set members in the parent class
+    setMembers(parameters, stations, times);
+
+    dims_[_DIM_PARAMETER] = parameters_.size();
+    dims_[_DIM_STATION] = stations_.size();
+    dims_[_DIM_TIME] = times_.size();
+
+    buffer_ = values;
+    data_ = buffer_.get();
+
+    return;
+}
+
 double
 ObservationsPointer::getValue(
         size_t parameter_index, size_t station_index, size_t time_index) const {
@@ -89,6 +137,7 @@ void
 ObservationsPointer::setValue(double val,
         size_t parameter_index, size_t station_index, size_t time_index) {
 
+    detach_();
     data_[toIndex_(parameter_index, station_index, time_index)] = val;
     return;
 }
@@ -152,6 +201,39 @@ operator<<(std::ostream & os, const ObservationsPointer & obj) {
     return os;
 }
 
+ObservationsPointer &
+ObservationsPointer::operator=(const ObservationsPointer & rhs) {
+
+    if (this != &rhs) {
+        Observations::operator=(rhs);
+
+        // Share values. They will be copied when either side is modified.
+        memcpy(dims_, rhs.dims_, 3 * sizeof (size_t));
+        buffer_ = rhs.buffer_;
+        data_ = rhs.data_;
+    }
+
+    return *this;
+}
+
+ObservationsPointer &
+ObservationsPointer::operator=(ObservationsPointer && rhs) {
+
+    if (this != &rhs) {
+        Observations::operator=(std::move(rhs));
+
+        // Take over values and leave the right hand side empty
+        memcpy(dims_, rhs.dims_, 3 * sizeof (size_t));
+        buffer_ = std::move(rhs.buffer_);
+        data_ = rhs.data_;
+
+        fill_n(rhs.dims_, 3, 0);
+        rhs.data_ = nullptr;
+    }
+
+    return *this;
+}
+
 size_t
 ObservationsPointer::toIndex_(size_t dim0, size_t dim1, size_t dim2) const {
     // Convert dimension indices to position offset by column-major
@@ -166,11 +248,30 @@ ObservationsPointer::allocateMemory_() {
     dims_[_DIM_STATION] = stations_.size();
     dims_[_DIM_TIME] = times_.size();
 
-    // Allocate memory for underlying data structure
-    if (allocated_) delete [] data_;
-    data_ = new double [num_elements()];
+    // Allocate memory for underlying data structure. The previous memory
+    // is released when no other copies are sharing it.
+    //
+    buffer_.reset(new double [num_elements()], default_delete<double[]>());
+    data_ = buffer_.get();
+
+#if defined(_ENABLE_NUMA)
+    Functions::adviseHugePages(data_, num_elements() * sizeof (double));
+#endif
+
+    return;
+}
+
+void
+ObservationsPointer::detach_() {
+
+    if (buffer_.use_count() <= 1) return;
+
+    // Keep a reference to the shared memory while making a private copy
+    shared_ptr<double> shared = buffer_;
+    buffer_.reset(new double [num_elements()], default_delete<double[]>());
+    data_ = buffer_.get();
+    memcpy(data_, shared.get(), sizeof (double) * num_elements());
 
-    allocated_ = true;
     return;
 }
 
@@ -108,13 +108,13 @@ void Parameters::push_back(const Parameter& parameter) {
 
 size_t
 Parameters::getIndex(const Parameter & parameter) const {
-    auto it = right.find(parameter);
-    if (it == right.end()) {
+    size_t index = find(parameter);
+    if (index == _NPOS) {
         ostringstream msg;
         msg << "Parameter not found: " << parameter;
         throw range_error(msg.str());
     }
-    return (it->second);
+    return index;
 }
 
 void
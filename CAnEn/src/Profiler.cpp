@@ -8,6 +8,9 @@
 #include <iomanip>
 #include <stdexcept>
 #include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <cctype>
 
 #include "Profiler.h"
 #include "boost/date_time.hpp"
@@ -28,6 +31,10 @@ Profiler::Profiler(size_t num_sessions) {
 #ifndef _UNKNOWN_OS_
     peak_memory_.reserve(num_sessions);
 #endif
+
+#if defined(_NUMA_MAPS_)
+    node_memory_.reserve(num_sessions);
+#endif
 }
 
 Profiler::~Profiler() {
@@ -51,6 +58,11 @@ Profiler::log_time_session(const string& session_name) {
 #ifndef _UNKNOWN_OS_
     peak_memory_.push_back(getPeakRSS_());
 #endif
+
+#if defined(_NUMA_MAPS_)
+    node_memory_.push_back(vector<size_t>());
+    getNodeMemory_(node_memory_.back());
+#endif
 }
 
 void
@@ -73,6 +85,15 @@ Profiler::append_sessions(const Profiler & new_sessions) {
 #ifndef _UNKNOWN_OS_
         peak_memory_.push_back(new_sessions.peak_memory_[i]);
 #endif
+
+#if defined(_NUMA_MAPS_)
+        node_memory_.push_back(new_sessions.node_memory_[i]);
+#endif
+    }
+
+    if (!new_sessions.rank_busy_.empty()) {
+        rank_busy_ = new_sessions.rank_busy_;
+        rank_idle_ = new_sessions.rank_idle_;
     }
 
     return;
@@ -84,6 +105,14 @@ Profiler::operator+=(const Profiler & rhs) {
     return;
 }
 
+void
+Profiler::log_rank_times(const vector<double> & busy, const vector<double> & idle) {
+    if (busy.size() != idle.size()) throw runtime_error("The numbers of busy and idle times are different");
+    rank_busy_ = busy;
+    rank_idle_ = idle;
+    return;
+}
+
 void
 Profiler::summary(ostream& os) const {
 
@@ -140,9 +169,33 @@ Profiler::summary(ostream& os) const {
                 << "\t peak memory (" << peak_memory_[session_i]
                 << " bytes)"
 #endif
-                << endl;
+                ;
+
+#if defined(_NUMA_MAPS_)
+        const auto & node_memory = node_memory_[session_i];
+
+        if (!node_memory.empty()) {
+            os << "\t node memory (";
+            for (size_t node_i = 0; node_i < node_memory.size(); ++node_i) {
+                if (node_i != 0) os << ", ";
+                os << "N" << node_i << ": " << node_memory[node_i];
+            }
+            os << " bytes)";
+        }
+#endif
+
+        os << endl;
 
     }
+
+    for (size_t rank_i = 0; rank_i < rank_busy_.size(); ++rank_i) {
+        double rank_total = rank_busy_[rank_i] + rank_idle_[rank_i];
+        double busy_percent = (rank_total > 0 ? rank_busy_[rank_i] / rank_total * 100 : 0);
+
+        os << "Rank #" << rank_i << ": busy time (" << rank_busy_[rank_i] << " s, " << setw(6) << busy_percent << "%)"
+                << "\t idle time (" << rank_idle_[rank_i] << " s, " << setw(6) << 100 - busy_percent << "%)" << endl;
+    }
+
     os << "**************** End of Profiler Summary *****************" << endl;
 
 }
@@ -199,6 +252,54 @@ Profiler::getPeakRSS_() {
 
 #endif
 
+#if defined(_NUMA_MAPS_)
+
+void
+Profiler::getNodeMemory_(vector<size_t> & node_memory) {
+
+    /*
+     * Each line in numa_maps describes a memory mapping. Tokens like N1=20
+     * show the number of pages of this mapping resident on node 1, and the
+     * token kernelpagesize_kB shows the page size of this mapping.
+     */
+    node_memory.clear();
+
+    ifstream ifs("/proc/self/numa_maps");
+    if (!ifs) return;
+
+    string line, token;
+    vector<size_t> line_pages;
+
+    while (getline(ifs, line)) {
+        istringstream iss(line);
+        size_t page_kb = 4;
+        line_pages.clear();
+
+        while (iss >> token) {
+            if (token.size() > 1 && token[0] == 'N' && isdigit(token[1])) {
+                size_t pos = token.find('=');
+                if (pos == string::npos) continue;
+
+                size_t node = stoul(token.substr(1, pos - 1));
+                if (line_pages.size() <= node) line_pages.resize(node + 1, 0);
+                line_pages[node] += stoul(token.substr(pos + 1));
+
+            } else if (token.compare(0, 18, "kernelpagesize_kB=") == 0) {
+                page_kb = stoul(token.substr(18));
+            }
+        }
+
+        if (node_memory.size() < line_pages.size()) node_memory.resize(line_pages.size(), 0);
+        for (size_t node_i = 0; node_i < line_pages.size(); ++node_i) {
+            node_memory[node_i] += line_pages[node_i] * page_kb * 1024;
+        }
+    }
+
+    return;
+}
+
+#endif
+
 int
 Profiler::max_name_width_() const {
     if (session_names_.size() == 0) throw runtime_error("No session names added. Please add session names with log_time_session");
@@ -39,8 +39,8 @@ Station::Station(double x, double y, string name) :
 x_(x), y_(y), name_(name) {
 }
 
-Station::Station(Station const & rhs) {
-    *this = rhs;
+Station::Station(Station const & rhs) :
+x_(rhs.x_), y_(rhs.y_), name_(rhs.name_) {
 }
 
 Station::~Station() {
@@ -60,9 +60,9 @@ Station &
 
 bool
 Station::operator==(const Station & rhs) const {
-    if (name_ != rhs.getName()) return false;
-    if (x_ != rhs.getX()) return false;
-    if (y_ != rhs.getY()) return false;
+    if (x_ != rhs.x_) return false;
+    if (y_ != rhs.y_) return false;
+    if (name_ != rhs.name_) return false;
 
     return (true);
 }
@@ -146,13 +146,13 @@ Stations::shiftLongitudes() {
 
 size_t
 Stations::getIndex(const Station & station) const {
-    auto it = right.find(station);
-    if (it == right.end()) {
+    size_t index = find(station);
+    if (index == _NPOS) {
         ostringstream msg;
         msg << "Station not found: " << station;
         throw range_error(msg.str());
     }
-    return it->second;
+    return index;
 }
 
 void
@@ -0,0 +1,248 @@
+/*
+ * File:   StationsIndex.cpp
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#include "StationsIndex.h"
+
+#include <limits>
+#include <numeric>
+#include <algorithm>
+
+using namespace std;
+
+static const double _DEG2RAD = M_PI / 180;
+
+const size_t StationsIndex::_NPOS = static_cast<size_t> (-1);
+const double StationsIndex::_EARTH_RADIUS = 6371.0;
+
+StationsIndex::StationsIndex() : metric_(Metric::Euclidean), num_dims_(2) {
+}
+
+StationsIndex::StationsIndex(const Stations & stations, Metric metric) {
+    build(stations, metric);
+}
+
+StationsIndex::~StationsIndex() {
+}
+
+void
+StationsIndex::build(const Stations & stations, Metric metric) {
+
+    metric_ = metric;
+    num_dims_ = (metric_ == Metric::GreatCircle ? 3 : 2);
+
+    // Collect stations with valid coordinates
+    size_t num_stations = stations.size();
+    vector<double> coords(num_stations * num_dims_);
+    vector<size_t> valid_index;
+    valid_index.reserve(num_stations);
+
+    for (size_t station_i = 0; station_i < num_stations; ++station_i) {
+        if (toCoords_(stations.getStation(station_i), coords.data() + valid_index.size() * num_dims_)) {
+            valid_index.push_back(station_i);
+        }
+    }
+
+    // Build the tree by reordering stations
+    size_t num_valid = valid_index.size();
+    vector<size_t> order(num_valid);
+    iota(order.begin(), order.end(), 0);
+
+    split_dims_.assign(num_valid, 0);
+    build_(0, num_valid, order, coords);
+
+    // Store coordinates in the tree order so that a node is read contiguously
+    coords_.resize(num_valid * num_dims_);
+    stations_index_.resize(num_valid);
+
+    for (size_t node_i = 0; node_i < num_valid; ++node_i) {
+        copy_n(coords.begin() + order[node_i] * num_dims_, num_dims_, coords_.begin() + node_i * num_dims_);
+        stations_index_[node_i] = valid_index[order[node_i]];
+    }
+
+    return;
+}
+
+size_t
+StationsIndex::size() const {
+    return stations_index_.size();
+}
+
+StationsIndex::Metric
+StationsIndex::getMetric() const {
+    return metric_;
+}
+
+size_t
+StationsIndex::nearest(const Station & station) const {
+    vector<Neighbor> neighbors;
+    nearest(station, 1, neighbors);
+
+    if (neighbors.empty()) return _NPOS;
+    return neighbors[0].second;
+}
+
+void
+StationsIndex::nearest(const Station & station, size_t k,
+        vector<Neighbor> & neighbors, double max_distance) const {
+
+    neighbors.clear();
+
+    double query[3];
+    if (k == 0 || !toCoords_(station, query)) return;
+
+    double max_dist_sq = numeric_limits<double>::infinity();
+    if (!std::isnan(max_distance)) max_dist_sq = toTreeDistance_(max_distance);
+
+    // Neighbors are kept in a max heap so that the furthest is replaced first
+    neighbors.reserve(k);
+    search_(0, stations_index_.size(), query, k, max_dist_sq, neighbors);
+    sort_heap(neighbors.begin(), neighbors.end());
+
+    for (auto & neighbor : neighbors) neighbor.first = fromTreeDistance_(neighbor.first);
+
+    return;
+}
+
+bool
+StationsIndex::toCoords_(const Station & station, double * coords) const {
+
+    double x = station.getX(), y = station.getY();
+    if (std::isnan(x) || std::isnan(y)) return false;
+
+    if (metric_ == Metric::GreatCircle) {
+
+        // Points on the unit sphere. The chord distance increases with the
+        // great circle distance, so neighbors are the same.
+        //
+        double lon = x * _DEG2RAD, lat = y * _DEG2RAD;
+        coords[0] = cos(lat) * cos(lon);
+        coords[1] = cos(lat) * sin(lon);
+        coords[2] = sin(lat);
+
+    } else {
+        coords[0] = x;
+        coords[1] = y;
+    }
+
+    return true;
+}
+
+double
+StationsIndex::toTreeDistance_(double distance) const {
+
+    if (metric_ == Metric::GreatCircle) {
+        if (distance >= M_PI * _EARTH_RADIUS) return numeric_limits<double>::infinity();
+
+        double chord = 2 * sin(distance / (2 * _EARTH_RADIUS));
+        return chord * chord;
+    }
+
+    return distance * distance;
+}
+
+double
+StationsIndex::fromTreeDistance_(double tree_distance) const {
+
+    if (metric_ == Metric::GreatCircle) {
+        double half_chord = min(sqrt(tree_distance) / 2, 1.0);
+        return 2 * _EARTH_RADIUS * asin(half_chord);
+    }
+
+    return sqrt(tree_distance);
+}
+
+void
+StationsIndex::build_(size_t begin, size_t end, vector<size_t> & order,
+        const vector<double> & coords) {
+
+    if (begin >= end) return;
+
+    // Split on the dimension with the largest spread
+    size_t split_dim = 0;
+    double max_spread = -1;
+
+    for (size_t dim_i = 0; dim_i < num_dims_; ++dim_i) {
+        double lower = numeric_limits<double>::infinity();
+        double upper = -numeric_limits<double>::infinity();
+
+        for (size_t i = begin; i < end; ++i) {
+            double value = coords[order[i] * num_dims_ + dim_i];
+            lower = min(lower, value);
+            upper = max(upper, value);
+        }
+
+        if (upper - lower > max_spread) {
+            max_spread = upper - lower;
+            split_dim = dim_i;
+        }
+    }
+
+    size_t mid = begin + (end - begin) / 2;
+    size_t num_dims = num_dims_;
+
+    nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+            [&coords, split_dim, num_dims](size_t lhs, size_t rhs) {
+                return coords[lhs * num_dims + split_dim] < coords[rhs * num_dims + split_dim];
+            });
+
+    split_dims_[mid] = split_dim;
+
+    build_(begin, mid, order, coords);
+    build_(mid + 1, end, order, coords);
+
+    return;
+}
+
+void
+StationsIndex::search_(size_t begin, size_t end, const double * query,
+        size_t k, double max_dist_sq, vector<Neighbor> & heap) const {
+
+    if (begin >= end) return;
+
+    size_t mid = begin + (end - begin) / 2;
+    const double * node = coords_.data() + mid * num_dims_;
+
+    double dist_sq = 0;
+    for (size_t dim_i = 0; dim_i < num_dims_; ++dim_i) {
+        double diff = node[dim_i] - query[dim_i];
+        dist_sq += diff * diff;
+    }
+
+    // Pairs are compared by distances and then station indices
+    if (dist_sq <= max_dist_sq) {
+        Neighbor candidate(dist_sq, stations_index_[mid]);
+
+        if (heap.size() < k) {
+            heap.push_back(candidate);
+            push_heap(heap.begin(), heap.end());
+        } else if (candidate < heap.front()) {
+            pop_heap(heap.begin(), heap.end());
+            heap.back() = candidate;
+            push_heap(heap.begin(), heap.end());
+        }
+    }
+
+    // Visit the branch containing the query first
+    double diff = query[split_dims_[mid]] - node[split_dims_[mid]];
+
+    if (diff < 0) {
+        search_(begin, mid, query, k, max_dist_sq, heap);
+    } else {
+        search_(mid + 1, end, query, k, max_dist_sq, heap);
+    }
+
+    // Visit the other branch only if it might contain closer stations
+    double bound = (heap.size() < k ? max_dist_sq : heap.front().first);
+
+    if (diff * diff <= bound) {
+        if (diff < 0) {
+            search_(mid + 1, end, query, k, max_dist_sq, heap);
+        } else {
+            search_(begin, mid, query, k, max_dist_sq, heap);
+        }
+    }
+
+    return;
+}
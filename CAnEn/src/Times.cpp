@@ -147,13 +147,13 @@ Times::push_back(const Time & time) {
 
 size_t
 Times::getIndex(const Time & time) const {
-    auto it = right.find(time);
-    if (it == right.end()) {
+    size_t index = find(time);
+    if (index == _NPOS) {
         ostringstream msg;
         msg << "Time not found: " << time;
         throw range_error(msg.str());
     }
-    return (it->second);
+    return index;
 }
 
 void
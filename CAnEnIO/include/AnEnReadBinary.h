@@ -0,0 +1,92 @@
+/*
+ * File:   AnEnReadBinary.h
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#ifndef ANENREADBINARY_H
+#define ANENREADBINARY_H
+
+#include <memory>
+#include <string>
+
+#include "Config.h"
+#include "AnEnWriteBinary.h"
+#include "ForecastsPointer.h"
+#include "ObservationsPointer.h"
+
+/**
+ * \class AnEnReadBinary
+ *
+ * \brief AnEnReadBinary reads the native binary format written by
+ * AnEnWriteBinary. Files are memory mapped. When all stations are read,
+ * values are not copied. The data object references the mapped memory, and
+ * pages are loaded from disk when they are first accessed.
+ *
+ * The mapping is private, so modifying values never changes the file. The
+ * mapping is released when the data object and all its copies are destroyed.
+ */
+class AnEnReadBinary {
+public:
+    AnEnReadBinary();
+    AnEnReadBinary(Verbose verbose);
+    AnEnReadBinary(const AnEnReadBinary& orig);
+    virtual ~AnEnReadBinary();
+
+    void readForecasts(const std::string & file_path,
+            ForecastsPointer & forecasts) const;
+
+    /**
+     * Reads a range of stations. Values of these stations are copied
+     * from the mapped file.
+     */
+    void readForecasts(const std::string & file_path,
+            ForecastsPointer & forecasts,
+            int station_start, int station_count) const;
+
+    void readObservations(const std::string & file_path,
+            ObservationsPointer & observations) const;
+    void readObservations(const std::string & file_path,
+            ObservationsPointer & observations,
+            int station_start, int station_count) const;
+
+    /**
+     * Checks whether a file is in the native binary format
+     * @param file_path The file to check
+     * @return Whether the file starts with the binary header
+     */
+    static bool isBinary(const std::string & file_path);
+
+protected:
+    Verbose verbose_;
+
+    /**
+     * Maps a file and checks the header
+     * @param file_path The file to map
+     * @param type The expected file type
+     * @param header The header of the file
+     * @return The mapped memory. It is unmapped when released.
+     */
+    std::shared_ptr<char> map_(const std::string & file_path,
+            AnEnWriteBinary::FileType type,
+            AnEnWriteBinary::Header & header) const;
+
+    void read_(const std::string & file_path, ForecastsPointer & forecasts,
+            int station_start, int station_count) const;
+    void read_(const std::string & file_path, ObservationsPointer & observations,
+            int station_start, int station_count) const;
+
+    /**
+     * Copies values of a range of stations. Values are organized as
+     * [parameters, stations, others] in column-major.
+     */
+    static void copyStations_(const double * p_from, double * p_to,
+            std::size_t num_parameters, std::size_t num_stations, std::size_t num_others,
+            std::size_t station_start, std::size_t station_count);
+
+    static void getMeta_(const char * & p, const char * end, Parameters & parameters);
+    static void getMeta_(const char * & p, const char * end, Stations & stations,
+            std::size_t station_start, std::size_t station_count);
+    static void getMeta_(const char * & p, const char * end, Times & times);
+};
+
+#endif /* ANENREADBINARY_H */
@@ -9,7 +9,9 @@
 #define ANENREADGRIB_H
 
 #include <vector>
+#include <string>
 
+#include "eccodes.h"
 #include "Config.h"
 #include "Forecasts.h"
 #include "FunctionsIO.h"
@@ -26,8 +28,27 @@ public:
     AnEnReadGrib();
     AnEnReadGrib(const AnEnReadGrib& orig);
     AnEnReadGrib(Verbose verbose);
+
+    /**
+     * Files are decoded concurrently when more than one thread is used.
+     * Each thread opens its own files and handles. Eccodes should be built
+     * with thread support (ENABLE_ECCODES_THREADS).
+     * @param verbose Verbose level
+     * @param num_threads The number of threads to decode files
+     */
+    AnEnReadGrib(Verbose verbose, int num_threads);
     virtual ~AnEnReadGrib();
 
+    /**
+     * Whether to use message index files. An index file records the offset
+     * and the keys of each message in a GRIB file. It is created next to the
+     * GRIB file with the extension _INDEX_EXT on the first read, and later
+     * reads seek to the requested messages directly. An index is rebuilt
+     * when the size or the modification time of the GRIB file changes.
+     * @param use_index Whether to use index files
+     */
+    void setIndex(bool use_index);
+
     void readForecasts(Forecasts & forecasts,
             const std::vector<ParameterGrib> & grib_parameters,
             const std::vector<std::string> & files,
@@ -36,8 +57,37 @@ public:
             bool delimited = false,
             std::vector<int> stations_index = {}) const;
 
+    static const std::string _INDEX_EXT;
+    static const std::string _INDEX_HEADER;
+    static const std::string _key_grid_hash;
+
 protected:
     Verbose verbose_;
+    int num_threads_;
+    bool use_index_;
+
+    /**
+     * \struct MessageIndex
+     *
+     * \brief The location and the keys of a message in a GRIB file
+     */
+    struct MessageIndex {
+        long offset;
+        long length;
+        long id;
+        std::string level_type;
+        long level;
+    };
+
+    /**
+     * \struct DecodeBuffer
+     *
+     * \brief Buffers owned by each decoding thread and reused across files
+     */
+    struct DecodeBuffer {
+        std::vector<double> data;
+        std::vector<char> message;
+    };
     
     void readForecastsMeta_(Forecasts & forecasts,
             const std::vector<ParameterGrib> & grib_parameters,
@@ -48,6 +98,40 @@ protected:
 
     void readStations_(Stations&, const std::string &,
             const std::vector<int> & stations_index = {}) const;
+
+    /**
+     * Decodes all parameters from a file into the slice of a time and a lead
+     * time in the values of forecasts.
+     * @param p_values The pointer to forecast values in column-major
+     * @param dims The shape of forecast values
+     * @param buffer Decode buffers of the calling thread
+     */
+    void readFile_(double * p_values, const std::size_t * dims,
+            const std::vector<ParameterGrib> & grib_parameters,
+            const std::string & file, std::size_t time_i, std::size_t flt_i,
+            const std::vector<int> & stations_index, DecodeBuffer & buffer) const;
+
+    void readFileIndexed_(double * p_values, const std::size_t * dims,
+            const std::vector<ParameterGrib> & grib_parameters,
+            const std::string & file, std::size_t time_i, std::size_t flt_i,
+            const std::vector<int> & stations_index,
+            const std::vector<MessageIndex> & index, DecodeBuffer & buffer) const;
+
+    /**
+     * Gets the message index of a file. The index is read from the index
+     * file if it is up to date. Otherwise, it is built and saved.
+     * @return False if the file cannot be indexed, e.g. multi-field messages
+     */
+    bool getIndex_(const std::string & file, std::vector<MessageIndex> & index) const;
+    bool readIndex_(const std::string & file, std::vector<MessageIndex> & index) const;
+    void writeIndex_(const std::string & file, const std::vector<MessageIndex> & index) const;
+
+    void readKeys_(codes_handle * h, long & id, std::string & level_type, long & level) const;
+    void readValues_(codes_handle * h, const ParameterGrib & parameter,
+            const std::vector<int> & stations_index, std::vector<double> & data) const;
+    void setSlice_(double * p_values, const std::size_t * dims, std::size_t parameter_i,
+            std::size_t time_i, std::size_t flt_i, const std::vector<double> & data) const;
+    void checkMissing_(const std::vector<std::size_t> & parameters_i, std::size_t num_parameters) const;
 };
 
 #endif /* ANENREADGRIB_H */
@@ -0,0 +1,93 @@
+/*
+ * File:   AnEnWriteBinary.h
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#ifndef ANENWRITEBINARY_H
+#define ANENWRITEBINARY_H
+
+#include <string>
+#include <cstdint>
+
+#include "Config.h"
+#include "Forecasts.h"
+#include "Observations.h"
+
+/**
+ * \class AnEnWriteBinary
+ *
+ * \brief AnEnWriteBinary writes forecasts and observations to the native
+ * binary format. The file can be memory mapped by AnEnReadBinary so that
+ * values are used in place without parsing or copying.
+ *
+ * The file has three sections:
+ * - A fixed header, AnEnWriteBinary::Header
+ * - Dimension metadata, including parameters, stations, times, and lead times
+ * - Values in column-major, the same layout as in memory
+ *
+ * Values start at a multiple of _ALIGNMENT bytes. Numbers are stored in the
+ * byte order of the writing machine, which is verified by the reader.
+ */
+class AnEnWriteBinary {
+public:
+
+    enum class FileType : std::uint32_t {
+        Forecasts = 1, Observations = 2
+    };
+
+    struct Header {
+        char magic[8];
+        std::uint32_t byte_order;
+        std::uint32_t version;
+        std::uint32_t type;
+        std::uint32_t reserved;
+        std::uint64_t dims[4];
+        std::uint64_t meta_offset;
+        std::uint64_t meta_length;
+        std::uint64_t data_offset;
+        std::uint64_t data_length;
+    };
+
+    AnEnWriteBinary();
+    AnEnWriteBinary(const AnEnWriteBinary& orig);
+    AnEnWriteBinary(Verbose verbose);
+    virtual ~AnEnWriteBinary();
+
+    /**
+     * Writes forecasts to a binary file. Values should be contiguous in
+     * memory, so views need to be subset first.
+     * @param file The output file name
+     * @param forecasts Forecasts to write
+     * @param overwrite Whether to overwrite an existing file
+     */
+    void writeForecasts(const std::string & file,
+            const Forecasts & forecasts, bool overwrite = false) const;
+
+    /**
+     * Writes observations to a binary file.
+     * @param file The output file name
+     * @param observations Observations to write
+     * @param overwrite Whether to overwrite an existing file
+     */
+    void writeObservations(const std::string & file,
+            const Observations & observations, bool overwrite = false) const;
+
+    static const char _MAGIC[8];
+    static const std::uint32_t _BYTE_ORDER;
+    static const std::uint32_t _VERSION;
+    static const std::size_t _ALIGNMENT;
+    static const std::string _EXT;
+
+protected:
+    Verbose verbose_;
+
+    void write_(const std::string & file, FileType type,
+            const std::size_t * dims, const std::string & meta,
+            const double * values, bool overwrite) const;
+
+    static void putMeta_(std::string & meta, const Parameters & parameters);
+    static void putMeta_(std::string & meta, const Stations & stations);
+    static void putMeta_(std::string & meta, const Times & times);
+};
+
+#endif /* ANENWRITEBINARY_H */
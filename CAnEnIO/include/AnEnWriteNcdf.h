@@ -11,6 +11,7 @@
 #include <unordered_map> 
 #include <netcdf>
 
+#include "Ncdf.h"
 #include "Config.h"
 #include "AnEnIS.h"
 #include "AnEnSSE.h"
@@ -29,6 +30,14 @@ public:
     AnEnWriteNcdf(Verbose verbose);
     virtual ~AnEnWriteNcdf();
 
+    /**
+     * Sets chunking, compression, and quantization for variables written
+     * afterwards. Quantization is only applied to analog and similarity
+     * values. Indices, forecasts, and observations are kept lossless.
+     * @param storage Storage settings
+     */
+    void setStorage(const Ncdf::Storage & storage);
+
     /**
      * Write AnEn into to an NetCDF file
      * 
@@ -91,6 +100,86 @@ public:
             const Times & forecast_flts, const Parameters &, const Stations &,
             const Observations&, bool overwrite = false, bool append = false) const;
 
+    /**
+     * Create an NetCDF file with AnEn variables defined but not yet written.
+     * This is used when AnEn is generated and written by blocks of stations.
+     * Values are written with writeAnEnStations.
+     * 
+     * @param file The output file name
+     * @param anen The AnEn object from any block. It decides what variables
+     * to create and the configuration to save.
+     * @param multi_names Variable names of multivariate analogs
+     * @param test_times The test times used to generate AnEn
+     * @param search_times The search times used to generate AnEn
+     * @param forecast_flts The lead times of AnEn forecasts
+     * @param parameters The forecast parameters used to generate AnEn
+     * @param stations All stations to be written
+     * @param num_forecast_times The number of forecast times. Similarity
+     * time indices point to forecast times and are bounded by it.
+     * @param overwrite Whether to overwrite existing files
+     * @param fingerprint The fingerprint of the run saved as the global
+     * attribute _FINGERPRINT. It is used to resume the run with readCheckpoint.
+     */
+    void createAnEn(const std::string & file, const AnEnIS &,
+            const std::vector<std::string> & multi_names,
+            const Times & test_times, const Times & search_times,
+            const Times & forecast_flts, const Parameters &, const Stations &,
+            std::size_t num_forecast_times,
+            bool overwrite = false, const std::string & fingerprint = "") const;
+
+    /**
+     * Reads the progress of a file created by createAnEn so that an
+     * interrupted run can be resumed. Blocks are written in the order of
+     * stations, so only stations after the written ones need to be computed.
+     * 
+     * @param file The output file name created by createAnEn
+     * @param fingerprint The fingerprint of the current run. An exception is
+     * thrown if it is different from the one saved in the file.
+     * @return The number of leading stations that have been written
+     */
+    std::size_t readCheckpoint(const std::string & file, const std::string & fingerprint) const;
+
+    /**
+     * Write AnEn of a block of stations into a file created by createAnEn.
+     * If blocks are written in the order of stations, the global attribute
+     * _STATIONS_WRITTEN records how many leading stations are complete, so
+     * a partial file can be recognized after a crash.
+     * 
+     * @param file The output file name
+     * @param anen The AnEn object generated for the block
+     * @param obs_map Multivariate analog names and observation IDs. It can be empty.
+     * @param observations The observations of the block. Only used for multivariate analogs.
+     * @param station_start The index of the first station of this block in the file
+     */
+    void writeAnEnStations(const std::string & file, const AnEnIS &,
+            const std::unordered_map<std::string, std::size_t> & obs_map,
+            const Observations &, std::size_t station_start) const;
+
+    /**
+     * Write AnEn of a block of stations into a standalone part file. This is
+     * used when each MPI process writes its own stations in parallel instead
+     * of gathering results to the master. Values are kept lossless, and the
+     * global attribute _STATION_START records the position of the block.
+     * Parts are later concatenated with concatAnEnParts.
+     * 
+     * @param file The part file name
+     * @param anen The AnEn object generated for the block
+     * @param station_start The index of the first station of this block in the concatenated file
+     * @param overwrite Whether to overwrite existing files
+     */
+    void writeAnEnPart(const std::string & file, const AnEnIS &,
+            std::size_t station_start, bool overwrite = false) const;
+
+    /**
+     * Concatenate part files written by writeAnEnPart into a file created by
+     * createAnEn. Parts are read one at a time, so the memory usage is bounded
+     * by the largest part instead of the entire output.
+     * 
+     * @param file The output file name created by createAnEn
+     * @param part_files Part files in any order
+     */
+    void concatAnEnParts(const std::string & file, const std::vector<std::string> & part_files) const;
+
     /**
      * Write forecasts.
      * @param file The output file name
@@ -130,8 +219,24 @@ public:
     const static bool _unlimited_flts;
     const static bool _unlimited_members;
 
+    /**
+     * The global attribute for the number of stations written by blocks
+     */
+    const static std::string _STATIONS_WRITTEN;
+
+    /**
+     * The global attribute for the first station of a part file
+     */
+    const static std::string _STATION_START;
+
+    /**
+     * The global attribute for the fingerprint of the run that creates a file
+     */
+    const static std::string _FINGERPRINT;
+
 protected:
     Verbose verbose_;
+    Ncdf::Storage storage_;
     
     std::array<std::string, 4> analogs_dim_;
     std::array<std::string, 4> sims_dim_;
@@ -140,7 +245,11 @@ protected:
     void addBasicData_(netCDF::NcGroup &, const BasicData &) const;
     void addStations_(netCDF::NcGroup &, const Stations &, bool) const;
     void addMeta_(netCDF::NcGroup &) const;
+    void addAnEnMeta_(netCDF::NcGroup &, const AnEnIS &,
+            const Times &, const Times &, const Times &,
+            const Parameters &, const Stations &, bool) const;
     void setDimensions_();
+    Ncdf::Storage getLosslessStorage_() const;
 };
 
 #endif /* ANENWRITENCDF_H */
@@ -0,0 +1,109 @@
+/*
+ * File:   AnEnWriteNcdfQueue.h
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#ifndef ANENWRITENCDFQUEUE_H
+#define ANENWRITENCDFQUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <exception>
+#include <unordered_map>
+#include <condition_variable>
+
+#include "AnEnIS.h"
+#include "AnEnWriteNcdf.h"
+#include "ObservationsPointer.h"
+
+/**
+ * \class AnEnWriteNcdfQueue
+ *
+ * \brief AnEnWriteNcdfQueue writes AnEn of station blocks in a background
+ * thread. Blocks are handed over as soon as they are computed, and their
+ * memory is released after they are written, so the full results never
+ * need to be in memory.
+ *
+ * The output file is created with createAnEn from the first block, or a
+ * file from an interrupted run is resumed. Blocks
+ * are written with AnEnWriteNcdf::writeAnEnStations in the order they are
+ * pushed. The writer holds Ncdf::getMutex while it accesses the file, so
+ * other threads can safely read NetCDF files with the same lock.
+ */
+class AnEnWriteNcdfQueue {
+public:
+    AnEnWriteNcdfQueue() = delete;
+    AnEnWriteNcdfQueue(const AnEnWriteNcdfQueue& orig) = delete;
+
+    /**
+     * @param writer The writer with verbosity and storage settings
+     * @param file The output file name
+     * @param max_pending The maximum number of blocks owned by the writer.
+     * push waits when this number is reached.
+     */
+    AnEnWriteNcdfQueue(const AnEnWriteNcdf & writer,
+            const std::string & file, std::size_t max_pending = 1);
+    virtual ~AnEnWriteNcdfQueue();
+
+    /**
+     * Creates the output file and defines variables. This is called once
+     * before any blocks are pushed. Arguments are passed to createAnEn.
+     */
+    void create(const AnEnIS &, const std::unordered_map<std::string, std::size_t> & obs_map,
+            const Times & test_times, const Times & search_times,
+            const Times & forecast_flts, const Parameters &, const Stations &,
+            std::size_t num_forecast_times,
+            bool overwrite = false, const std::string & fingerprint = "");
+
+    /**
+     * Continues writing to an output file created by an interrupted run. This
+     * is called instead of create after the file has been validated with
+     * AnEnWriteNcdf::readCheckpoint.
+     */
+    void resume(const std::unordered_map<std::string, std::size_t> & obs_map);
+
+    /**
+     * Hands a block over to the writer.
+     * @param station_start The index of the first station of this block in the file
+     * @param anen The AnEn of the block
+     * @param observations The observations of the block. Only used for
+     * multivariate analogs. It can be empty otherwise.
+     */
+    void push(std::size_t station_start, std::unique_ptr<AnEnIS> anen,
+            ObservationsPointer && observations);
+
+    /**
+     * Waits until all blocks are written and stops the writer. Errors from
+     * the writer are thrown here or from the next push.
+     */
+    void finish();
+
+protected:
+
+    struct Block {
+        std::size_t station_start;
+        std::unique_ptr<AnEnIS> anen;
+        ObservationsPointer observations;
+    };
+
+    AnEnWriteNcdf writer_;
+    std::string file_;
+    std::size_t max_pending_;
+    std::unordered_map<std::string, std::size_t> obs_map_;
+
+    std::deque<Block> blocks_;
+    std::size_t num_pending_;
+    bool stop_;
+    std::exception_ptr error_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread thread_;
+
+    void run_();
+    void checkError_();
+};
+
+#endif /* ANENWRITENCDFQUEUE_H */
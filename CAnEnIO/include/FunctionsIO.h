@@ -35,17 +35,63 @@ namespace FunctionsIO {
             size_t unit_in_seconds,
             bool delimited);
 
+    /**
+     * Parses file names for unique times and lead times. Times and lead
+     * times are sorted.
+     */
     void parseFilenames(Times&, Times&,
             const std::vector<std::string> & files,
             const std::string & regex_str,
             size_t unit_in_seconds,
             bool delimited);
 
+    /**
+     * Parses the time and the lead time of each file name in parallel.
+     * @param file_times The time of each file
+     * @param file_flts The lead time of each file
+     * @param parsed Whether each file name is recognized
+     */
+    void parseFilenames(std::vector<Time> & file_times,
+            std::vector<Time> & file_flts, std::vector<char> & parsed,
+            const std::vector<std::string> & files,
+            const std::string & regex_str,
+            size_t unit_in_seconds,
+            bool delimited);
+
+    /**
+     * Lists files matching the regular expression in a folder, or reads file
+     * paths from a text file.
+     * @param manifest An optional file to cache the list of a folder. The
+     * cache is used if the folder and the regular expression are the same and
+     * the folder has not been modified since the manifest was saved.
+     * @param verbose The verbose level for warnings about the manifest
+     */
     void listFiles(std::vector<std::string> & files,
             const std::string & folder,
+            const std::string & regex_str,
+            const std::string & manifest = "",
+            Verbose verbose = Verbose::Warning);
+
+    bool readManifest(std::vector<std::string> & files,
+            const std::string & manifest, const std::string & folder,
             const std::string & regex_str);
+    void writeManifest(const std::vector<std::string> & files,
+            const std::string & manifest, const std::string & folder,
+            const std::string & regex_str, Verbose verbose = Verbose::Warning);
 
     size_t totalFiles(const std::string & folder);
+
+    /**
+     * Computes a fingerprint to check whether a later run has the same
+     * inputs. The 64-bit FNV-1a hash is used because it does not change
+     * across platforms and builds.
+     * @param content A description of the run, e.g. configuration and times
+     * @param files Input files. Their paths, sizes, and modification times
+     * are also hashed.
+     * @return 16 hexadecimal digits
+     */
+    std::string fingerprint(const std::string & content,
+            const std::vector<std::string> & files = {});
 }
 
 #endif /* FUNCTIONSIO_H */
@@ -9,6 +9,7 @@
 #define NCDF_H
 
 #include <array>
+#include <mutex>
 #include <netcdf>
 #include <vector>
 #include <string>
@@ -25,6 +26,35 @@
  */
 namespace Ncdf {
 
+    /**
+     * \struct Storage
+     * 
+     * \brief Storage settings for variables in NetCDF-4 files.
+     * 
+     * By default, variables are not compressed and chunks are decided by the
+     * library. Chunks are only set along the station dimension, so that
+     * reading a few stations from a file touches as few chunks as possible.
+     */
+    struct Storage {
+
+        // Deflate level from 0 (no compression) to 9
+        int deflate_level = 0;
+
+        // Whether to use the shuffle filter before deflate
+        bool shuffle = false;
+
+        // The number of significant digits to keep. 0 keeps all digits.
+        // This is lossy and only applied to values, never to indices.
+        int significant_digits = 0;
+
+        // The number of stations in a chunk. All values of the other
+        // dimensions are in the same chunk, unless the chunk would reach the
+        // 4 GiB limit of HDF5 and times are split. 0 uses the library default.
+        std::size_t chunk_stations = 0;
+
+        bool isDefault() const;
+    };
+
     std::size_t readDimLength(const std::string & file_path, const std::string dim_name);
 
     void checkExists(const std::string & file_path);
@@ -55,7 +85,68 @@ namespace Ncdf {
             bool unlimited = false);
     void writeArray4D(netCDF::NcGroup &, const Array4D &, const std::string &,
             const std::array<std::string, 4> &,
-            const std::array<bool, 4> & unlimited = {false, false, false, false});
+            const std::array<bool, 4> & unlimited = {false, false, false, false},
+            const Storage & storage = Storage());
+
+    /**
+     * Writes an array as a block into an existing variable that has been
+     * created by addArray4D. This is used to write results in pieces, e.g.
+     * a block of stations at a time. If the variable stores indices as
+     * unsigned integers, values are converted and NAN is written as the fill value.
+     * @param start The start index of the block on each dimension of the array
+     */
+    void writeArray4D(netCDF::NcGroup &, const Array4D &, const std::string &,
+            const std::array<std::size_t, 4> & start);
+
+    /**
+     * Defines a 4-dimensional variable without writing values.
+     */
+    netCDF::NcVar addArray4D(netCDF::NcGroup &, const std::string &,
+            const std::array<std::string, 4> &, const std::array<std::size_t, 4> &,
+            const std::array<bool, 4> & unlimited = {false, false, false, false},
+            const Storage & storage = Storage());
+
+    /**
+     * Defines a 4-dimensional variable for indices. Indices are stored as
+     * unsigned integers instead of doubles. The narrowest type that can hold
+     * the maximum index is used, and the largest value of the type is the
+     * fill value for missing indices.
+     * @param max_index The largest index to be stored
+     */
+    netCDF::NcVar addIndexArray4D(netCDF::NcGroup &, const std::string &,
+            const std::array<std::string, 4> &, const std::array<std::size_t, 4> &,
+            std::size_t max_index,
+            const std::array<bool, 4> & unlimited = {false, false, false, false},
+            const Storage & storage = Storage());
+
+    /**
+     * Writes an array of indices as unsigned integers. NAN is written as the
+     * fill value. The integer type is decided by the largest index in the array.
+     */
+    void writeIndexArray4D(netCDF::NcGroup &, const Array4D &, const std::string &,
+            const std::array<std::string, 4> &,
+            const std::array<bool, 4> & unlimited = {false, false, false, false},
+            const Storage & storage = Storage());
+
+    /**
+     * Replaces fill values with NAN after an index variable has been read
+     * into doubles. Nothing is changed if the variable is stored as doubles.
+     */
+    void fillIndexNAN(const netCDF::NcVar &, double * p_vals, std::size_t num_elements);
+
+    /**
+     * Applies storage settings to a newly defined variable. This must be
+     * called before any values are written.
+     */
+    void setStorage(netCDF::NcVar &, const Storage &);
+
+    void checkColumnMajor(const Array4D &);
+
+    /**
+     * The NetCDF library is not thread-safe. Threads that read or write
+     * files concurrently should hold this lock during each operation.
+     */
+    std::mutex & getMutex();
 
     void purge(std::string & str);
     void purge(std::vector<std::string> & strs);
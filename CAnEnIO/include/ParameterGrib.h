@@ -124,6 +124,8 @@ public:
     static const std::string _key_level;
     static const std::string _key_level_type;
     static const std::string _key_values;
+    static const std::string _key_offset;
+    static const std::string _key_length;
 
 private:
     long id_;
@@ -0,0 +1,329 @@
+/*
+ * File:   AnEnReadBinary.cpp
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#include "AnEnReadBinary.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+static const string _TRUNCATED_MSG = "Binary metadata is truncated";
+
+template <typename T>
+static T
+getNumber(const char * & p, const char * end) {
+    if (end - p < (ptrdiff_t) sizeof (T)) throw runtime_error(_TRUNCATED_MSG);
+
+    T value;
+    memcpy(&value, p, sizeof (T));
+    p += sizeof (T);
+    return value;
+}
+
+static string
+getString(const char * & p, const char * end) {
+    uint64_t len = getNumber<uint64_t>(p, end);
+    if ((uint64_t) (end - p) < len) throw runtime_error(_TRUNCATED_MSG);
+
+    string str(p, len);
+    p += len;
+    return str;
+}
+
+static void
+checkStations(int & station_start, int & station_count, size_t num_stations) {
+
+    if (station_start < 0 || station_count <= 0) {
+        station_start = 0;
+        station_count = num_stations;
+    }
+
+    if (station_start + station_count > (int) num_stations) {
+        ostringstream msg;
+        msg << "I need to read " << station_count << " stations from #" << station_start
+                << " but there are only " << num_stations << " stations";
+        throw range_error(msg.str());
+    }
+
+    return;
+}
+
+AnEnReadBinary::AnEnReadBinary() {
+    Config config;
+    verbose_ = config.verbose;
+}
+
+AnEnReadBinary::AnEnReadBinary(Verbose verbose) : verbose_(verbose) {
+}
+
+AnEnReadBinary::AnEnReadBinary(const AnEnReadBinary& orig) {
+    verbose_ = orig.verbose_;
+}
+
+AnEnReadBinary::~AnEnReadBinary() {
+}
+
+void
+AnEnReadBinary::readForecasts(const string & file_path,
+        ForecastsPointer & forecasts) const {
+    read_(file_path, forecasts, -1, -1);
+    return;
+}
+
+void
+AnEnReadBinary::readForecasts(const string & file_path,
+        ForecastsPointer & forecasts,
+        int station_start, int station_count) const {
+    read_(file_path, forecasts, station_start, station_count);
+    return;
+}
+
+void
+AnEnReadBinary::readObservations(const string & file_path,
+        ObservationsPointer & observations) const {
+    read_(file_path, observations, -1, -1);
+    return;
+}
+
+void
+AnEnReadBinary::readObservations(const string & file_path,
+        ObservationsPointer & observations,
+        int station_start, int station_count) const {
+    read_(file_path, observations, station_start, station_count);
+    return;
+}
+
+bool
+AnEnReadBinary::isBinary(const string & file_path) {
+
+    char magic[sizeof (AnEnWriteBinary::_MAGIC)];
+
+    ifstream ifs(file_path, ios::binary);
+    if (!ifs.read(magic, sizeof (magic))) return false;
+
+    return memcmp(magic, AnEnWriteBinary::_MAGIC, sizeof (magic)) == 0;
+}
+
+shared_ptr<char>
+AnEnReadBinary::map_(const string & file_path,
+        AnEnWriteBinary::FileType type,
+        AnEnWriteBinary::Header & header) const {
+
+    int fd = open(file_path.c_str(), O_RDONLY);
+    if (fd < 0) throw runtime_error("Failed to open " + file_path);
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        throw runtime_error("Failed to get the size of " + file_path);
+    }
+
+    size_t file_size = file_stat.st_size;
+
+    if (file_size < sizeof (AnEnWriteBinary::Header)) {
+        close(fd);
+        throw runtime_error(file_path + " is too small to be a binary file");
+    }
+
+    /*
+     * The whole file is mapped so that the mapping starts at a page boundary
+     * regardless of the page size of this machine. The mapping is private
+     * and writable, so writes to values only change private pages.
+     */
+    void * addr = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (addr == MAP_FAILED) throw runtime_error("Failed to map " + file_path);
+
+    shared_ptr<char> mapping(static_cast<char *> (addr), [file_size](char * p) {
+        munmap(p, file_size);
+    });
+
+    // Check the header
+    memcpy(&header, mapping.get(), sizeof (AnEnWriteBinary::Header));
+
+    ostringstream msg;
+
+    if (memcmp(header.magic, AnEnWriteBinary::_MAGIC, sizeof (header.magic)) != 0) {
+        msg << file_path << " is not a binary file";
+    } else if (header.byte_order != AnEnWriteBinary::_BYTE_ORDER) {
+        msg << file_path << " was written on a machine with a different byte order";
+    } else if (header.version != AnEnWriteBinary::_VERSION) {
+        msg << file_path << " has version " << header.version << " but version "
+                << AnEnWriteBinary::_VERSION << " is supported";
+    } else if (header.type != static_cast<uint32_t> (type)) {
+        msg << file_path << " does not have the expected file type";
+    } else if (header.meta_offset + header.meta_length > file_size ||
+            header.data_offset + header.data_length > file_size ||
+            header.data_offset % sizeof (double) != 0) {
+        msg << file_path << " is truncated or corrupted";
+    } else if (header.data_length != header.dims[0] * header.dims[1] *
+            header.dims[2] * header.dims[3] * sizeof (double)) {
+        msg << file_path << " has inconsistent dimensions and values";
+    }
+
+    if (!msg.str().empty()) throw runtime_error(msg.str());
+
+    return mapping;
+}
+
+void
+AnEnReadBinary::read_(const string & file_path, ForecastsPointer & forecasts,
+        int station_start, int station_count) const {
+
+    if (verbose_ >= Verbose::Progress) cout << "Reading forecasts from a binary file ..." << endl;
+
+    AnEnWriteBinary::Header header;
+    shared_ptr<char> mapping = map_(file_path, AnEnWriteBinary::FileType::Forecasts, header);
+
+    const uint64_t * dims = header.dims;
+    checkStations(station_start, station_count, dims[1]);
+
+    // Read dimensions
+    Parameters parameters;
+    Stations stations;
+    Times times, flts;
+
+    const char * p = mapping.get() + header.meta_offset;
+    const char * end = p + header.meta_length;
+
+    getMeta_(p, end, parameters);
+    getMeta_(p, end, stations, station_start, station_count);
+    getMeta_(p, end, times);
+    getMeta_(p, end, flts);
+
+    if (parameters.size() != dims[0] || stations.size() != (size_t) station_count ||
+            times.size() != dims[2] || flts.size() != dims[3]) {
+        throw runtime_error("Binary metadata do not match dimensions. Duplicates might exist.");
+    }
+
+    // Reference values in the mapped memory
+    shared_ptr<double> values(mapping, reinterpret_cast<double *> (mapping.get() + header.data_offset));
+
+    if ((size_t) station_count == dims[1]) {
+        forecasts.wrap(parameters, stations, times, flts, values);
+    } else {
+        forecasts.setDimensions(parameters, stations, times, flts);
+        copyStations_(values.get(), forecasts.getValuesPtr(), dims[0], dims[1],
+                dims[2] * dims[3], station_start, station_count);
+    }
+
+    if (verbose_ >= Verbose::Detail) cout << forecasts;
+    return;
+}
+
+void
+AnEnReadBinary::read_(const string & file_path, ObservationsPointer & observations,
+        int station_start, int station_count) const {
+
+    if (verbose_ >= Verbose::Progress) cout << "Reading observations from a binary file ..." << endl;
+
+    AnEnWriteBinary::Header header;
+    shared_ptr<char> mapping = map_(file_path, AnEnWriteBinary::FileType::Observations, header);
+
+    const uint64_t * dims = header.dims;
+    checkStations(station_start, station_count, dims[1]);
+
+    // Read dimensions
+    Parameters parameters;
+    Stations stations;
+    Times times;
+
+    const char * p = mapping.get() + header.meta_offset;
+    const char * end = p + header.meta_length;
+
+    getMeta_(p, end, parameters);
+    getMeta_(p, end, stations, station_start, station_count);
+    getMeta_(p, end, times);
+
+    if (parameters.size() != dims[0] || stations.size() != (size_t) station_count ||
+            times.size() != dims[2]) {
+        throw runtime_error("Binary metadata do not match dimensions. Duplicates might exist.");
+    }
+
+    // Reference values in the mapped memory
+    shared_ptr<double> values(mapping, reinterpret_cast<double *> (mapping.get() + header.data_offset));
+
+    if ((size_t) station_count == dims[1]) {
+        observations.wrap(parameters, stations, times, values);
+    } else {
+        observations.setDimensions(parameters, stations, times);
+        copyStations_(values.get(), observations.getValuesPtr(), dims[0], dims[1],
+                dims[2], station_start, station_count);
+    }
+
+    if (verbose_ >= Verbose::Detail) cout << observations;
+    return;
+}
+
+void
+AnEnReadBinary::copyStations_(const double * p_from, double * p_to,
+        size_t num_parameters, size_t num_stations, size_t num_others,
+        size_t station_start, size_t station_count) {
+
+    // Parameters of the station range are contiguous for each of the other indices
+    size_t len = num_parameters * station_count;
+
+    for (size_t other_i = 0; other_i < num_others; ++other_i) {
+        memcpy(p_to + other_i * len,
+                p_from + num_parameters * (other_i * num_stations + station_start),
+                sizeof (double) * len);
+    }
+
+    return;
+}
+
+void
+AnEnReadBinary::getMeta_(const char * & p, const char * end, Parameters & parameters) {
+
+    uint64_t num = getNumber<uint64_t>(p, end);
+
+    for (uint64_t i = 0; i < num; ++i) {
+        string name = getString(p, end);
+        bool circular = getNumber<uint8_t>(p, end);
+        parameters.push_back(Parameter(name, circular));
+    }
+
+    return;
+}
+
+void
+AnEnReadBinary::getMeta_(const char * & p, const char * end, Stations & stations,
+        size_t station_start, size_t station_count) {
+
+    uint64_t num = getNumber<uint64_t>(p, end);
+    stations.reserve(station_count);
+
+    for (uint64_t i = 0; i < num; ++i) {
+        double x = getNumber<double>(p, end);
+        double y = getNumber<double>(p, end);
+        string name = getString(p, end);
+
+        if (i >= station_start && i < station_start + station_count) {
+            stations.push_back(Station(x, y, name));
+        }
+    }
+
+    return;
+}
+
+void
+AnEnReadBinary::getMeta_(const char * & p, const char * end, Times & times) {
+
+    uint64_t num = getNumber<uint64_t>(p, end);
+    times.reserve(num);
+
+    for (uint64_t i = 0; i < num; ++i) times.push_back(Time(getNumber<uint64_t>(p, end)));
+
+    return;
+}
@@ -5,12 +5,17 @@
  * Created on February 7, 2020, 1:02 PM
  */
 
+#include <map>
 #include <cmath>
+#include <mutex>
 #include <numeric>
 #include <sstream>
+#include <fstream>
 #include <algorithm>
 #include <stdexcept>
 
+#include "boost/filesystem.hpp"
+
 #include "eccodes.h"
 #include "Functions.h"
 #include "FunctionsIO.h"
@@ -20,16 +25,45 @@ using namespace std;
 using namespace boost::gregorian;
 using namespace boost::xpressive;
 
+namespace filesys = boost::filesystem;
+
+const string AnEnReadGrib::_INDEX_EXT = ".anenidx";
+const string AnEnReadGrib::_INDEX_HEADER = "PAnEnGribIndex1";
+const string AnEnReadGrib::_key_grid_hash = "md5GridSection";
+
+/*
+ * Stations are cached by the hash of the grid definition and the stations
+ * index, so that forecasts and analysis on the same grid only iterate
+ * through coordinates once.
+ */
+static mutex _grid_cache_mutex;
+static map<pair<string, vector<int> >, Stations> _grid_cache;
+
 AnEnReadGrib::AnEnReadGrib() {
     Config config;
     verbose_ = config.verbose;
+    num_threads_ = 1;
+    use_index_ = false;
 }
 
 AnEnReadGrib::AnEnReadGrib(const AnEnReadGrib& orig) {
     verbose_ = orig.verbose_;
+    num_threads_ = orig.num_threads_;
+    use_index_ = orig.use_index_;
+}
+
+AnEnReadGrib::AnEnReadGrib(Verbose verbose) :
+verbose_(verbose), num_threads_(1), use_index_(false) {
 }
 
-AnEnReadGrib::AnEnReadGrib(Verbose verbose) : verbose_(verbose) {
+AnEnReadGrib::AnEnReadGrib(Verbose verbose, int num_threads) :
+verbose_(verbose), num_threads_(num_threads), use_index_(false) {
+}
+
+void
+AnEnReadGrib::setIndex(bool use_index) {
+    use_index_ = use_index;
+    return;
 }
 
 AnEnReadGrib::~AnEnReadGrib() {
@@ -53,185 +87,80 @@ AnEnReadGrib::readForecasts(Forecasts & forecasts,
      * Read forecast data values
      */
     if (verbose_ >= Verbose::Progress) cout << "Reading forecast ..." << endl;
-    int err = 0;
-    double* p_data = nullptr;
-    Time file_time, file_flt;
-
-    // Initialize variables in advance
-    size_t data_len, parameter_i, time_i, flt_i;
-    size_t num_stations = forecasts.getStations().size();
-    long current_id, current_level;
-    char* current_level_type;
-    codes_handle *h = nullptr;
-    FILE* in = nullptr;
-    size_t str_len;
     const Times & times = forecasts.getTimes();
     const Times & flts = forecasts.getFLTs();
 
-    // This variable counts the number of failures when reading files
-    size_t failed_files = 0;
-    size_t read_files = 0;
-
-    // These regular expressions can be reused
-    sregex rex = sregex::compile(regex_str);
-
-    // This is the start time
-    date start_day(from_string(Time::_origin));
-
-    // Turn on support for multi fields messages
-    codes_grib_multi_support_on(0);
-
-    // Count how many files have been read
-    size_t counter = 0;
-
     // The number of total files to read
     size_t num_files = files.size();
 
-    for (const auto & file : files) {
+    /*
+     * Determine the time and flt index for each file. Files are decoded
+     * afterwards, possibly with multiple threads.
+     */
+    vector<Time> file_times, file_flts;
+    vector<char> parsed;
+    FunctionsIO::parseFilenames(file_times, file_flts, parsed, files, regex_str, flt_unit_in_seconds, delimited);
 
-        ++counter;
+    vector<string> files_to_read;
+    vector<size_t> times_index, flts_index;
 
-        // Determine the time and flt index for this file
-        bool ret = FunctionsIO::parseFilename(file_time, file_flt, file, start_day,
-                rex, flt_unit_in_seconds, delimited);
+    for (size_t file_i = 0; file_i < num_files; ++file_i) {
 
-        // Skip this file if the file is not recognized
-        if (ret) {
-            if (verbose_ >= Verbose::Detail) cout << "(" << counter << "/"
-                << num_files << ") " << file << " --> Time: " << file_time.toString()
-                << " Lead time: " << file_flt << " " << Time::_unit << endl;
+        const string & file = files[file_i];
 
-            read_files++;
+        // Skip this file if the file is not recognized
+        if (parsed[file_i]) {
+            if (verbose_ >= Verbose::Detail) cout << "(" << file_i + 1 << "/"
+                << num_files << ") " << file << " --> Time: " << file_times[file_i].toString()
+                << " Lead time: " << file_flts[file_i] << " " << Time::_unit << endl;
 
         } else {
             if (verbose_ >= Verbose::Debug) cout << "Skip " << file << endl;
             continue;
         }
 
-        // Get index
-        time_i = times.getIndex(file_time);
-        flt_i = flts.getIndex(file_flt);
+        files_to_read.push_back(file);
+        times_index.push_back(times.getIndex(file_times[file_i]));
+        flts_index.push_back(flts.getIndex(file_flts[file_i]));
+    }
 
-        // Define the parameter indices to find. This variable is used to
-        // avoid searching for already found variables and to avoid excessive
-        // function calls to eccodes.
-        //
-        vector<size_t> parameters_i(grib_parameters.size());
-        iota(parameters_i.begin(), parameters_i.end(), 0);
+    // This variable counts the number of failures when reading files
+    size_t failed_files = 0;
+    size_t read_files = files_to_read.size();
 
-        try {
+    /*
+     * Get the pointer once before decoding. Each file fills a disjoint slice
+     * of times and lead times, so threads write values in place without locks.
+     */
+    double *p_values = forecasts.getValuesPtr();
+    const size_t *dims = forecasts.shape();
 
-            in = fopen(file.c_str(), "r");
-
-            while ((h = codes_handle_new_from_file(0, in, PRODUCT_GRIB, &err)) != NULL) {
-                if (err) throw runtime_error(codes_get_error_message(err));
-
-                for (auto it = parameters_i.begin(); it != parameters_i.end(); ++it) {
-                    
-                    parameter_i = *it;
-
-                    // Create a reference to the current parameter to avoid copy
-                    const auto & current_parameter = grib_parameters[parameter_i];
-
-                    // Check whether we have found the correct parameter id
-                    err = codes_get_long(h, ParameterGrib::_key_id.c_str(), &current_id);
-                    if (err) throw runtime_error(codes_get_error_message(err));
-                    if (current_id != current_parameter.getId()) continue;
-
-                    // Check whether we have found the correct level type
-                    err = codes_get_length(h, ParameterGrib::_key_level_type.c_str(), &str_len);
-                    if (err) throw runtime_error(codes_get_error_message(err));
-                    current_level_type = new char[str_len];
-
-                    err = codes_get_string(h, ParameterGrib::_key_level_type.c_str(), current_level_type, &str_len);
-                    if (err) throw runtime_error(codes_get_error_message(err));
-
-                    if (current_level_type != current_parameter.getLevelType()) {
-                        delete [] current_level_type;
-                        continue;
-                    }
-                    
-                    delete [] current_level_type;
-
-                    // Check whether we have found the correct level
-                    err = codes_get_long(h, ParameterGrib::_key_level.c_str(), &current_level);
-                    if (err) throw runtime_error(codes_get_error_message(err));
-                    if (current_level != current_parameter.getLevel()) continue;
-
-                    // Read data from the GRIB file
-                    if (stations_index.empty()) {
-                        if (codes_get_size(h, ParameterGrib::_key_values.c_str(), &data_len)) {
-                            ostringstream msg;
-                            msg << "Failed to read variable length for id: " << current_parameter.getId()
-                                    << ", level: " << current_parameter.getLevel() << ", type of level: "
-                                    << current_parameter.getLevelType() << endl
-                                    << "The original message from Eccodes: " << codes_get_error_message(err);
-                            throw runtime_error(msg.str());
-                        }
-
-                        p_data = new double [data_len];
-
-                        codes_get_double_array(h, ParameterGrib::_key_values.c_str(), p_data, &data_len);
-
-                    } else {
-                        data_len = stations_index.size();
-
-                        p_data = new double [data_len];
-
-                        if (codes_get_double_elements(h, ParameterGrib::_key_values.c_str(), stations_index.data(), data_len, p_data)) {
-                            ostringstream msg;
-                            msg << "Failed to read variable for id: " << current_parameter.getId()
-                                    << ", level: " << current_parameter.getLevel() << ", type of level: " << current_parameter.getLevelType() << endl
-                                    << "The original message from Eccodes: " << codes_get_error_message(err);
-                            throw runtime_error(msg.str());
-                        }
-                    }
-
-                    if (num_stations != data_len) {
-                        ostringstream msg;
-                        msg << "The number of data values (" << data_len
-                                << ") do not match the number of stations (" << num_stations
-                                << "). Do you have duplicates in station coordinates?";
-                        throw runtime_error(msg.str());
-                    }
-
-                    // Set values into the forecasts
-                    for (size_t station_i = 0; station_i < data_len; ++station_i) {
-                        forecasts.setValue(p_data[station_i], parameter_i, station_i, time_i, flt_i);
-                    }
-
-                    delete [] p_data;
-                    
-                    // Remove the parameter index that has been found
-                    parameters_i.erase(it);
-                    
-                    // This handle has been processed. I can skip to the next handle.
-                    break;
-                }
+    // Turn on support for multi fields messages
+    codes_grib_multi_support_on(0);
 
-                codes_handle_delete(h);
+    int num_threads = num_threads_;
 
-                // If all parameters have been found for this file, skip the rest of the messages
-                if (parameters_i.size() == 0) break;
-            }
+    if (verbose_ >= Verbose::Detail && num_threads > 1) cout << "Decoding " << read_files
+            << " files with " << num_threads << " threads ..." << endl;
 
-            if (parameters_i.size() != 0) {
-                stringstream msg;
-                msg << parameters_i.size() << " out of " << grib_parameters.size() << " parameters are not found";
+#pragma omp parallel num_threads(num_threads) default(none) \
+shared(files_to_read, times_index, flts_index, read_files, p_values, dims, grib_parameters, \
+stations_index, std::cerr) reduction(+:failed_files)
+    {
+        // Buffers are sized by the first message and reused for all files of a thread
+        DecodeBuffer buffer;
 
-                if (verbose_ >= Verbose::Debug) {
-                    msg << " (ID: " << Functions::format(parameters_i, ",", parameters_i.size()) << ")";
-                }
+#pragma omp for schedule(dynamic, 1)
+        for (size_t file_i = 0; file_i < read_files; ++file_i) {
+            try {
+                readFile_(p_values, dims, grib_parameters, files_to_read[file_i],
+                        times_index[file_i], flts_index[file_i], stations_index, buffer);
+            } catch (exception & e) {
+#pragma omp critical
+                cerr << "Errored when reading " << files_to_read[file_i] << ": " << e.what() << endl;
 
-                throw runtime_error(msg.str());
+                failed_files++;
             }
-
-            // Clean up
-            fclose(in);
-
-        } catch (exception & e) {
-            cerr << "Errored when reading " << file << ": " << e.what() << endl;
-            failed_files++;
         }
     }
 
@@ -329,53 +258,473 @@ AnEnReadGrib::readStations_(Stations & stations, const string & file,
 
     int err;
     FILE *in = fopen(file.c_str(), "r");
+    if (in == nullptr) throw runtime_error(string("Failed to open ") + file);
+
     codes_handle *h = NULL;
     
-    if ((h = codes_handle_new_from_file(0, in, PRODUCT_GRIB, &err)) == NULL) {
+    if ((h = codes_handle_new_from_file(0, in, PRODUCT_GRIB, &err)) == NULL || err) {
+        if (h) codes_handle_delete(h);
+        fclose(in);
         throw runtime_error(string("Failed to create handle from ") + file);
-    } else {
-        if (err) throw runtime_error(string("Failed to create handle from ") + file);
     }
 
-    // Set a missing value
-    err = codes_set_double(h, "missingValue", NAN);
-    if (err) throw runtime_error(string("Failed to set missing value in ") + file);
+    // Check whether this grid has been read before
+    pair<string, vector<int> > key;
+    size_t str_len = 0;
+    bool cacheable = (codes_get_length(h, _key_grid_hash.c_str(), &str_len) == 0);
+
+    if (cacheable) {
+        vector<char> buffer(str_len);
+        cacheable = (codes_get_string(h, _key_grid_hash.c_str(), buffer.data(), &str_len) == 0);
+        key = make_pair(string(buffer.data()), stations_index);
+    }
+
+    if (cacheable) {
+        lock_guard<mutex> lock(_grid_cache_mutex);
+        auto it = _grid_cache.find(key);
 
-    // Create an iterator to loop through all coordinates
-    codes_iterator *iter = codes_grib_iterator_new(h, 0, &err);
-    if (err) throw runtime_error(string("Failed to create an iterator from ") + file);
+        if (it != _grid_cache.end()) {
+            if (verbose_ >= Verbose::Debug) cout << "Stations are copied from the grid cache" << endl;
 
-    // Start with a clean repository
-    stations.clear();
+            stations = it->second;
+            codes_handle_delete(h);
+            fclose(in);
+            return;
+        }
+    }
 
-    double x, y, val;
-    int counter = 0, station_index = 0;
+    try {
+        // Set a missing value
+        err = codes_set_double(h, "missingValue", NAN);
+        if (err) throw runtime_error(string("Failed to set missing value in ") + file);
 
-    while (codes_grib_iterator_next(iter, &y, &x, &val)) {
+        // Get the number of points to reserve space for stations
+        long num_points = 0;
+        err = codes_get_long(h, "numberOfPoints", &num_points);
+        if (err) throw runtime_error(string("Failed to get the number of points from ") + file);
 
-        if (stations_index.size() != 0) {
-            // If we are reading a subset of the stations
+        // Create an iterator to loop through all coordinates
+        codes_iterator *iter = codes_grib_iterator_new(h, 0, &err);
+        if (err) throw runtime_error(string("Failed to create an iterator from ") + file);
 
-            // No need to read more stations if all subset stations have been read
-            if (station_index == stations_index.size()) break;
+        // Start with a clean repository
+        stations.clear();
+        stations.reserve(stations_index.size() != 0 ? stations_index.size() : num_points);
 
-            if (stations_index[station_index] != counter) {
-                // If the current station is not what we want to read
-                counter++;
-                continue;
+        double x, y, val;
+        size_t counter = 0, station_index = 0;
+
+        while (codes_grib_iterator_next(iter, &y, &x, &val)) {
+
+            if (stations_index.size() != 0) {
+                // If we are reading a subset of the stations
+
+                // No need to read more stations if all subset stations have been read
+                if (station_index == stations_index.size()) break;
+
+                if ((size_t) stations_index[station_index] != counter) {
+                    // If the current station is not what we want to read
+                    counter++;
+                    continue;
+                }
             }
+
+            // The current station is what we want to read
+            Station station(x, y);
+            stations.push_back(station);
+            counter++;
+            station_index++;
         }
 
-        // The current station is what we want to read
-        Station station(x, y);
-        stations.push_back(station);
-        counter++;
-        station_index++;
+        codes_grib_iterator_delete(iter);
+
+    } catch (...) {
+        codes_handle_delete(h);
+        fclose(in);
+        throw;
     }
 
-    codes_grib_iterator_delete(iter);
     codes_handle_delete(h);
     fclose(in);
 
+    if (cacheable) {
+        lock_guard<mutex> lock(_grid_cache_mutex);
+        _grid_cache[key] = stations;
+    }
+
+    return;
+}
+
+void
+AnEnReadGrib::readFile_(double * p_values, const size_t * dims,
+        const vector<ParameterGrib> & grib_parameters, const string & file,
+        size_t time_i, size_t flt_i, const vector<int> & stations_index,
+        DecodeBuffer & buffer) const {
+
+    // Seek to messages directly if the file can be indexed
+    if (use_index_) {
+        vector<MessageIndex> index;
+
+        if (getIndex_(file, index)) {
+            readFileIndexed_(p_values, dims, grib_parameters, file, time_i, flt_i, stations_index, index, buffer);
+            return;
+        }
+    }
+
+    int err = 0;
+    long current_id, current_level;
+    string current_level_type;
+
+    // Define the parameter indices to find. This variable is used to
+    // avoid searching for already found variables and to avoid excessive
+    // function calls to eccodes.
+    //
+    vector<size_t> parameters_i(grib_parameters.size());
+    iota(parameters_i.begin(), parameters_i.end(), 0);
+
+    FILE *in = fopen(file.c_str(), "r");
+    if (in == nullptr) throw runtime_error("Failed to open the file");
+
+    codes_handle *h = nullptr;
+
+    try {
+
+        while ((h = codes_handle_new_from_file(0, in, PRODUCT_GRIB, &err)) != NULL) {
+            if (err) throw runtime_error(codes_get_error_message(err));
+
+            // Keys are only queried once for each message
+            readKeys_(h, current_id, current_level_type, current_level);
+
+            for (auto it = parameters_i.begin(); it != parameters_i.end(); ++it) {
+
+                // Create a reference to the current parameter to avoid copy
+                const auto & current_parameter = grib_parameters[*it];
+
+                // Check whether we have found the correct parameter
+                if (current_id != current_parameter.getId()) continue;
+                if (current_level_type != current_parameter.getLevelType()) continue;
+                if (current_level != current_parameter.getLevel()) continue;
+
+                // Read data from the GRIB file
+                readValues_(h, current_parameter, stations_index, buffer.data);
+                setSlice_(p_values, dims, *it, time_i, flt_i, buffer.data);
+
+                // Remove the parameter index that has been found
+                parameters_i.erase(it);
+
+                // This handle has been processed. I can skip to the next handle.
+                break;
+            }
+
+            codes_handle_delete(h);
+            h = nullptr;
+
+            // If all parameters have been found for this file, skip the rest of the messages
+            if (parameters_i.size() == 0) break;
+        }
+
+        checkMissing_(parameters_i, grib_parameters.size());
+
+    } catch (...) {
+        // Clean up before passing on the error
+        if (h) codes_handle_delete(h);
+        fclose(in);
+        throw;
+    }
+
+    // Clean up
+    fclose(in);
+
+    return;
+}
+
+void
+AnEnReadGrib::readFileIndexed_(double * p_values, const size_t * dims,
+        const vector<ParameterGrib> & grib_parameters, const string & file,
+        size_t time_i, size_t flt_i, const vector<int> & stations_index,
+        const vector<MessageIndex> & index, DecodeBuffer & buffer) const {
+
+    vector<size_t> parameters_i;
+    vector<char> & message = buffer.message;
+
+    FILE *in = fopen(file.c_str(), "rb");
+    if (in == nullptr) throw runtime_error("Failed to open the file");
+
+    codes_handle *h = nullptr;
+
+    try {
+
+        for (size_t parameter_i = 0; parameter_i < grib_parameters.size(); ++parameter_i) {
+
+            const auto & current_parameter = grib_parameters[parameter_i];
+
+            // Find the message of this parameter
+            auto it = find_if(index.begin(), index.end(), [&current_parameter](const MessageIndex & entry) {
+                return entry.id == current_parameter.getId() &&
+                        entry.level_type == current_parameter.getLevelType() &&
+                        entry.level == current_parameter.getLevel();
+            });
+
+            if (it == index.end()) {
+                parameters_i.push_back(parameter_i);
+                continue;
+            }
+
+            // Read only this message from the file
+            message.resize(it->length);
+
+            if (fseek(in, it->offset, SEEK_SET) != 0 || fread(message.data(), 1, it->length, in) != (size_t) it->length) {
+                throw runtime_error("Failed to read a message at the indexed offset. Remove the index file to rebuild it.");
+            }
+
+            // The handle refers to the message buffer without a copy
+            h = codes_handle_new_from_message(0, message.data(), message.size());
+            if (h == nullptr) throw runtime_error("Failed to create a handle from the indexed message");
+
+            readValues_(h, current_parameter, stations_index, buffer.data);
+            setSlice_(p_values, dims, parameter_i, time_i, flt_i, buffer.data);
+
+            codes_handle_delete(h);
+            h = nullptr;
+        }
+
+        checkMissing_(parameters_i, grib_parameters.size());
+
+    } catch (...) {
+        if (h) codes_handle_delete(h);
+        fclose(in);
+        throw;
+    }
+
+    fclose(in);
+
+    return;
+}
+
+bool
+AnEnReadGrib::getIndex_(const string & file, vector<MessageIndex> & index) const {
+
+    if (readIndex_(file, index)) return true;
+
+    /*
+     * Scan the file and record the keys of all messages. Multi-field messages
+     * share the same offset, and a field cannot be seeked to directly. These
+     * files are not indexed.
+     */
+    int err = 0;
+    FILE *in = fopen(file.c_str(), "r");
+    if (in == nullptr) throw runtime_error("Failed to open the file");
+
+    codes_handle *h = nullptr;
+    index.clear();
+
+    try {
+        while ((h = codes_handle_new_from_file(0, in, PRODUCT_GRIB, &err)) != NULL) {
+            if (err) throw runtime_error(codes_get_error_message(err));
+
+            MessageIndex entry;
+            readKeys_(h, entry.id, entry.level_type, entry.level);
+
+            err = codes_get_long(h, ParameterGrib::_key_offset.c_str(), &entry.offset);
+            if (err) throw runtime_error(codes_get_error_message(err));
+
+            err = codes_get_long(h, ParameterGrib::_key_length.c_str(), &entry.length);
+            if (err) throw runtime_error(codes_get_error_message(err));
+
+            index.push_back(entry);
+
+            codes_handle_delete(h);
+            h = nullptr;
+        }
+    } catch (...) {
+        if (h) codes_handle_delete(h);
+        fclose(in);
+        throw;
+    }
+
+    fclose(in);
+
+    for (size_t i = 1; i < index.size(); ++i) {
+        if (index[i].offset == index[i - 1].offset) {
+            if (verbose_ >= Verbose::Debug) cout << "Multi-field messages are not indexed in " << file << endl;
+            return false;
+        }
+    }
+
+    writeIndex_(file, index);
+    return true;
+}
+
+bool
+AnEnReadGrib::readIndex_(const string & file, vector<MessageIndex> & index) const {
+
+    ifstream ifs(file + _INDEX_EXT);
+    if (!ifs) return false;
+
+    // The index is valid only if the file has not changed since it was created
+    string header;
+    uintmax_t file_size;
+    time_t file_time;
+
+    if (!(ifs >> header >> file_size >> file_time) || header != _INDEX_HEADER) return false;
+
+    try {
+        if (file_size != filesys::file_size(file) || file_time != filesys::last_write_time(file)) return false;
+    } catch (exception & e) {
+        return false;
+    }
+
+    MessageIndex entry;
+    index.clear();
+
+    while (ifs >> entry.offset >> entry.length >> entry.id >> entry.level_type >> entry.level) {
+        index.push_back(entry);
+    }
+
+    if (!ifs.eof()) return false;
+
+    if (verbose_ >= Verbose::Debug) cout << "Read " << index.size() << " messages from the index of " << file << endl;
+    return true;
+}
+
+void
+AnEnReadGrib::writeIndex_(const string & file, const vector<MessageIndex> & index) const {
+
+    /*
+     * Write to a temporary file first and then rename it, so that concurrent
+     * runs over the same archive never see a partial index. Failures are not
+     * fatal because the archive might be read-only.
+     *
+     * The temporary file name is random so that threads and processes,
+     * possibly on different nodes, never write to the same file.
+     */
+    string index_file = file + _INDEX_EXT;
+    ostringstream tmp_file;
+    tmp_file << index_file << "." << filesys::unique_path("%%%%-%%%%-%%%%-%%%%").string() << ".tmp";
+
+    try {
+        {
+            ofstream ofs(tmp_file.str());
+            if (!ofs) throw runtime_error("Failed to open " + tmp_file.str());
+
+            ofs << _INDEX_HEADER << " " << filesys::file_size(file) << " " << filesys::last_write_time(file) << endl;
+            for (const auto & entry : index) {
+                ofs << entry.offset << " " << entry.length << " " << entry.id << " "
+                        << entry.level_type << " " << entry.level << endl;
+            }
+
+            if (!ofs) throw runtime_error("Failed to write " + tmp_file.str());
+        }
+
+        filesys::rename(tmp_file.str(), index_file);
+
+    } catch (exception & e) {
+        if (verbose_ >= Verbose::Warning) cerr << "Warning: The index of " << file << " is not saved: " << e.what() << endl;
+
+        boost::system::error_code ec;
+        filesys::remove(tmp_file.str(), ec);
+    }
+
+    return;
+}
+
+void
+AnEnReadGrib::readKeys_(codes_handle * h, long & id, string & level_type, long & level) const {
+
+    int err;
+    size_t str_len;
+
+    err = codes_get_long(h, ParameterGrib::_key_id.c_str(), &id);
+    if (err) throw runtime_error(codes_get_error_message(err));
+
+    err = codes_get_length(h, ParameterGrib::_key_level_type.c_str(), &str_len);
+    if (err) throw runtime_error(codes_get_error_message(err));
+
+    vector<char> buffer(str_len);
+    err = codes_get_string(h, ParameterGrib::_key_level_type.c_str(), buffer.data(), &str_len);
+    if (err) throw runtime_error(codes_get_error_message(err));
+    level_type = buffer.data();
+
+    err = codes_get_long(h, ParameterGrib::_key_level.c_str(), &level);
+    if (err) throw runtime_error(codes_get_error_message(err));
+
+    return;
+}
+
+void
+AnEnReadGrib::readValues_(codes_handle * h, const ParameterGrib & parameter,
+        const vector<int> & stations_index, vector<double> & data) const {
+
+    int err;
+    size_t data_len;
+
+    if (stations_index.empty()) {
+        err = codes_get_size(h, ParameterGrib::_key_values.c_str(), &data_len);
+        if (err) {
+            ostringstream msg;
+            msg << "Failed to read variable length for id: " << parameter.getId()
+                    << ", level: " << parameter.getLevel() << ", type of level: "
+                    << parameter.getLevelType() << endl
+                    << "The original message from Eccodes: " << codes_get_error_message(err);
+            throw runtime_error(msg.str());
+        }
+
+        data.resize(data_len);
+        codes_get_double_array(h, ParameterGrib::_key_values.c_str(), data.data(), &data_len);
+
+    } else {
+        data_len = stations_index.size();
+        data.resize(data_len);
+
+        err = codes_get_double_elements(h, ParameterGrib::_key_values.c_str(), stations_index.data(), data_len, data.data());
+        if (err) {
+            ostringstream msg;
+            msg << "Failed to read variable for id: " << parameter.getId()
+                    << ", level: " << parameter.getLevel() << ", type of level: " << parameter.getLevelType() << endl
+                    << "The original message from Eccodes: " << codes_get_error_message(err);
+            throw runtime_error(msg.str());
+        }
+    }
+
+    return;
+}
+
+void
+AnEnReadGrib::setSlice_(double * p_values, const size_t * dims,
+        size_t parameter_i, size_t time_i, size_t flt_i, const vector<double> & data) const {
+
+    size_t num_stations = dims[1];
+
+    if (num_stations != data.size()) {
+        ostringstream msg;
+        msg << "The number of data values (" << data.size()
+                << ") do not match the number of stations (" << num_stations
+                << "). Do you have duplicates in station coordinates?";
+        throw runtime_error(msg.str());
+    }
+
+    // Set values into the forecasts. Values are column-major.
+    double *p_slice = p_values + parameter_i + dims[0] * dims[1] * (time_i + dims[2] * flt_i);
+    for (size_t station_i = 0; station_i < num_stations; ++station_i) {
+        p_slice[station_i * dims[0]] = data[station_i];
+    }
+
+    return;
+}
+
+void
+AnEnReadGrib::checkMissing_(const vector<size_t> & parameters_i, size_t num_parameters) const {
+
+    if (parameters_i.size() != 0) {
+        stringstream msg;
+        msg << parameters_i.size() << " out of " << num_parameters << " parameters are not found";
+
+        if (verbose_ >= Verbose::Debug) {
+            msg << " (ID: " << Functions::format(parameters_i, ",", parameters_i.size()) << ")";
+        }
+
+        throw runtime_error(msg.str());
+    }
+
     return;
 }
@@ -335,6 +335,9 @@ AnEnReadNcdf::readAnalogs(const string& file_path, Array4D& analogs,
         throw runtime_error("Variable cannot be found");
     } else {
         read(nc, analogs.getValuesPtr(), var_name, start, count);
+
+        // Indices might be stored as unsigned integers with fill values
+        Ncdf::fillIndexNAN(var, analogs.getValuesPtr(), analogs.num_elements());
     }
 
     return;
@@ -449,6 +452,7 @@ AnEnReadNcdf::read(const NcGroup & nc, Stations & stations,
     }
 
     // Convert vectors to the dimension class
+    stations.reserve(size_ori + xs.size());
     for (size_t dim_i = size_ori, i = 0; i < xs.size(); ++dim_i, ++i) {
 
         // Determine whether the station has a name
@@ -505,6 +509,7 @@ AnEnReadNcdf::read(const NcGroup & nc, Times & times,
     size_t last_timestamp = 0;
 
     // Convert this vector to the dimension class
+    times.reserve(size_ori + vec.size());
     for (size_t i = 0, dim_i = size_ori; i < vec.size(); ++i, ++dim_i) {
 
         if (last_timestamp > vec[i]) {
@@ -0,0 +1,188 @@
+/*
+ * File:   AnEnWriteBinary.cpp
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#include "AnEnWriteBinary.h"
+
+#include "boost/filesystem.hpp"
+
+#include <thread>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace filesys = boost::filesystem;
+
+const char AnEnWriteBinary::_MAGIC[8] = {'P', 'A', 'n', 'E', 'n', 'B', 'i', 'n'};
+const uint32_t AnEnWriteBinary::_BYTE_ORDER = 0x01020304;
+const uint32_t AnEnWriteBinary::_VERSION = 1;
+const size_t AnEnWriteBinary::_ALIGNMENT = 4096;
+const string AnEnWriteBinary::_EXT = ".anb";
+
+template <typename T>
+static void
+putNumber(string & meta, T value) {
+    meta.append(reinterpret_cast<const char *> (&value), sizeof (T));
+    return;
+}
+
+static void
+putString(string & meta, const string & str) {
+    putNumber<uint64_t>(meta, str.size());
+    meta.append(str);
+    return;
+}
+
+AnEnWriteBinary::AnEnWriteBinary() {
+    Config config;
+    verbose_ = config.verbose;
+}
+
+AnEnWriteBinary::AnEnWriteBinary(const AnEnWriteBinary& orig) {
+    verbose_ = orig.verbose_;
+}
+
+AnEnWriteBinary::AnEnWriteBinary(Verbose verbose) : verbose_(verbose) {
+}
+
+AnEnWriteBinary::~AnEnWriteBinary() {
+}
+
+void
+AnEnWriteBinary::writeForecasts(const string & file,
+        const Forecasts & forecasts, bool overwrite) const {
+
+    if (verbose_ >= Verbose::Progress) cout << "Writing forecasts to a binary file ..." << endl;
+
+    string meta;
+    putMeta_(meta, forecasts.getParameters());
+    putMeta_(meta, forecasts.getStations());
+    putMeta_(meta, forecasts.getTimes());
+    putMeta_(meta, forecasts.getFLTs());
+
+    write_(file, FileType::Forecasts, forecasts.shape(), meta, forecasts.getValuesPtr(), overwrite);
+
+    if (verbose_ >= Verbose::Detail) cout << "Forecasts have been written to " << file << endl;
+    return;
+}
+
+void
+AnEnWriteBinary::writeObservations(const string & file,
+        const Observations & observations, bool overwrite) const {
+
+    if (verbose_ >= Verbose::Progress) cout << "Writing observations to a binary file ..." << endl;
+
+    string meta;
+    putMeta_(meta, observations.getParameters());
+    putMeta_(meta, observations.getStations());
+    putMeta_(meta, observations.getTimes());
+
+    size_t dims[4] = {
+        observations.getParameters().size(),
+        observations.getStations().size(),
+        observations.getTimes().size(), 1
+    };
+
+    write_(file, FileType::Observations, dims, meta, observations.getValuesPtr(), overwrite);
+
+    if (verbose_ >= Verbose::Detail) cout << "Observations have been written to " << file << endl;
+    return;
+}
+
+void
+AnEnWriteBinary::write_(const string & file, FileType type,
+        const size_t * dims, const string & meta,
+        const double * values, bool overwrite) const {
+
+    if (filesys::exists(file) && !overwrite) {
+        ostringstream msg;
+        msg << "File to write (" << file << ") exists. Use overwrite to replace it";
+        throw runtime_error(msg.str());
+    }
+
+    // Values start at the first aligned position after metadata
+    Header header;
+    memset(&header, 0, sizeof (Header));
+    memcpy(header.magic, _MAGIC, sizeof (_MAGIC));
+    header.byte_order = _BYTE_ORDER;
+    header.version = _VERSION;
+    header.type = static_cast<uint32_t> (type);
+    for (size_t i = 0; i < 4; ++i) header.dims[i] = dims[i];
+    header.meta_offset = sizeof (Header);
+    header.meta_length = meta.size();
+    header.data_offset = (header.meta_offset + header.meta_length + _ALIGNMENT - 1) / _ALIGNMENT * _ALIGNMENT;
+    header.data_length = dims[0] * dims[1] * dims[2] * dims[3] * sizeof (double);
+
+    if (header.data_length > 0 && values == nullptr) throw runtime_error("Values to write are empty");
+
+    /*
+     * Write to a temporary file first and then rename it, so that readers
+     * never map a partially written file.
+     */
+    ostringstream tmp_file;
+    tmp_file << file << "." << this_thread::get_id() << ".tmp";
+
+    try {
+        ofstream ofs(tmp_file.str(), ios::binary | ios::trunc);
+        if (!ofs) throw runtime_error("Failed to open " + tmp_file.str());
+
+        string padding(header.data_offset - header.meta_offset - header.meta_length, '\0');
+
+        ofs.write(reinterpret_cast<const char *> (&header), sizeof (Header));
+        ofs.write(meta.data(), meta.size());
+        ofs.write(padding.data(), padding.size());
+        ofs.write(reinterpret_cast<const char *> (values), header.data_length);
+
+        ofs.close();
+        if (!ofs) throw runtime_error("Failed to write " + tmp_file.str());
+
+        filesys::rename(tmp_file.str(), file);
+
+    } catch (...) {
+        boost::system::error_code ec;
+        filesys::remove(tmp_file.str(), ec);
+        throw;
+    }
+
+    return;
+}
+
+void
+AnEnWriteBinary::putMeta_(string & meta, const Parameters & parameters) {
+
+    putNumber<uint64_t>(meta, parameters.size());
+
+    for (const auto & parameter : parameters.left) {
+        putString(meta, parameter.second.getName());
+        putNumber<uint8_t>(meta, parameter.second.getCircular());
+    }
+
+    return;
+}
+
+void
+AnEnWriteBinary::putMeta_(string & meta, const Stations & stations) {
+
+    putNumber<uint64_t>(meta, stations.size());
+
+    for (const auto & station : stations.left) {
+        putNumber<double>(meta, station.second.getX());
+        putNumber<double>(meta, station.second.getY());
+        putString(meta, station.second.getName());
+    }
+
+    return;
+}
+
+void
+AnEnWriteBinary::putMeta_(string & meta, const Times & times) {
+
+    putNumber<uint64_t>(meta, times.size());
+    for (const auto & time : times.left) putNumber<uint64_t>(meta, time.second.timestamp);
+
+    return;
+}
@@ -11,6 +11,7 @@
 
 #include "boost/filesystem.hpp"
 
+#include <cmath>
 #include <stdexcept>
 #include <algorithm>
 #include <functional>
@@ -29,6 +30,10 @@ const bool AnEnWriteNcdf::_unlimited_times = false;
 const bool AnEnWriteNcdf::_unlimited_flts = false;
 const bool AnEnWriteNcdf::_unlimited_members = false;
 
+const string AnEnWriteNcdf::_STATIONS_WRITTEN = "stations_written";
+const string AnEnWriteNcdf::_STATION_START = "station_start";
+const string AnEnWriteNcdf::_FINGERPRINT = "fingerprint";
+
 AnEnWriteNcdf::AnEnWriteNcdf() {
     Config config;
     verbose_ = config.verbose;
@@ -37,6 +42,7 @@ AnEnWriteNcdf::AnEnWriteNcdf() {
 
 AnEnWriteNcdf::AnEnWriteNcdf(const AnEnWriteNcdf& orig) {
     verbose_ = orig.verbose_;
+    storage_ = orig.storage_;
     setDimensions_();
 }
 
@@ -47,6 +53,12 @@ AnEnWriteNcdf::AnEnWriteNcdf(Verbose verbose) : verbose_(verbose) {
 AnEnWriteNcdf::~AnEnWriteNcdf() {
 }
 
+void
+AnEnWriteNcdf::setStorage(const Ncdf::Storage & storage) {
+    storage_ = storage;
+    return;
+}
+
 void
 AnEnWriteNcdf::writeAnEn(const string & file, const AnEnIS & anen,
         const Times & test_times, const Times & search_times,
@@ -72,49 +84,18 @@ AnEnWriteNcdf::writeAnEn(const string & file, const AnEnIS & anen,
      * - 4D arrays that are controlled by save_* boolean variables
      */
 
-    // Save array if they are generated
-    if (anen.save_analogs()) Ncdf::writeArray4D(nc, anen.analogs_value(), Config::_ANALOGS, analogs_dim_, unlimited_);
-    if (anen.save_analogs_time_index()) Ncdf::writeArray4D(nc, anen.analogs_time_index(), Config::_ANALOGS_TIME_IND, analogs_dim_, unlimited_);
-    if (anen.save_sims()) Ncdf::writeArray4D(nc, anen.sims_metric(), Config::_SIMS, sims_dim_, unlimited_);
-    if (anen.save_sims_time_index()) Ncdf::writeArray4D(nc, anen.sims_time_index(), Config::_SIMS_TIME_IND, sims_dim_, unlimited_);
-
-    // Save configuration variables as global attributes
-    Ncdf::writeAttribute(nc, Config::_NUM_ANALOGS, (int) anen.num_analogs(), NcType::nc_INT, overwrite);
-    Ncdf::writeAttribute(nc, Config::_NUM_SIMS, (int) anen.num_sims(), NcType::nc_INT, overwrite);
-    Ncdf::writeAttribute(nc, Config::_OBS_ID, (int) anen.obs_var_index(), NcType::nc_INT, overwrite);
-    Ncdf::writeAttribute(nc, Config::_NUM_PAR_NA, (int) anen.max_par_nan(), NcType::nc_INT, overwrite);
-    Ncdf::writeAttribute(nc, Config::_NUM_FLT_NA, (int) anen.max_flt_nan(), NcType::nc_INT, overwrite);
-    Ncdf::writeAttribute(nc, Config::_FLT_RADIUS, (int) anen.flt_radius(), NcType::nc_INT, overwrite);
-    Ncdf::writeAttribute(nc, Config::_OPERATION, (int) anen.operation(), NcType::nc_INT, overwrite);
-    Ncdf::writeAttribute(nc, Config::_QUICK, (int) anen.quick_sort(), NcType::nc_INT, overwrite);
-    Ncdf::writeAttribute(nc, Config::_PREVENT_SEARCH_FUTURE, (int) anen.prevent_search_future(), NcType::nc_INT, overwrite);
-    Ncdf::writeAttribute(nc, Config::_NO_NORM, (int) anen.no_norm(), NcType::nc_INT, overwrite);
-
-    // Save weights with fixed length dimension of num_parameters
-    Ncdf::writeVector(nc, Config::_WEIGHTS, Config::_DIM_PARS, anen.weights(), NcType::nc_DOUBLE, false);
-
-
-    /*************************************************************************
-     *                   Write Extra variables                               *
-     *************************************************************************/
-    vector<size_t> test_timestamps, search_timestamps, flt_timestamps;
-    vector<string> parameter_names;
-
-    // Get values from the objects to write
-    test_times.getTimestamps(test_timestamps);
-    search_times.getTimestamps(search_timestamps);
-    forecast_flts.getTimestamps(flt_timestamps);
-    forecast_parameters.getNames(parameter_names);
+    // Indices are never quantized
+    Ncdf::Storage index_storage = getLosslessStorage_();
 
-    // Write to the file
-    addStations_(nc, forecast_stations, _unlimited_stations);
-    Ncdf::writeVector(nc, Config::_TEST_TIMES, Config::_DIM_TEST_TIMES, test_timestamps, NcType::nc_UINT64, _unlimited_test_times);
-    Ncdf::writeVector(nc, Config::_SEARCH_TIMES, Config::_DIM_SEARCH_TIMES, search_timestamps, NcType::nc_UINT64, _unlimited_search_times);
-    Ncdf::writeVector(nc, Config::_FLTS, Config::_DIM_FLTS, flt_timestamps, NcType::nc_UINT64, _unlimited_flts);
-    Ncdf::writeStringVector(nc, Config::_PAR_NAMES, Config::_DIM_PARS, parameter_names, _unlimited_parameters);
+    // Save array if they are generated
+    if (anen.save_analogs()) Ncdf::writeArray4D(nc, anen.analogs_value(), Config::_ANALOGS, analogs_dim_, unlimited_, storage_);
+    if (anen.save_analogs_time_index()) Ncdf::writeIndexArray4D(nc, anen.analogs_time_index(), Config::_ANALOGS_TIME_IND, analogs_dim_, unlimited_, index_storage);
+    if (anen.save_sims()) Ncdf::writeArray4D(nc, anen.sims_metric(), Config::_SIMS, sims_dim_, unlimited_, storage_);
+    if (anen.save_sims_time_index()) Ncdf::writeIndexArray4D(nc, anen.sims_time_index(), Config::_SIMS_TIME_IND, sims_dim_, unlimited_, index_storage);
 
-    // Write meta information
-    addMeta_(nc);
+    // Save configuration and dimension variables
+    addAnEnMeta_(nc, anen, test_times, search_times, forecast_flts,
+            forecast_parameters, forecast_stations, overwrite);
 
     // The file handler will automatically be closed when it is out of scope.
     // For C++ API older than 4.3.0, this function was not available.
@@ -142,7 +123,7 @@ AnEnWriteNcdf::writeAnEn(const string& file, const AnEnSSE& anen,
     NcFile nc(file, NcFile::FileMode::write, NcFile::FileFormat::nc4);
 
     // Save stations index
-    if (anen.save_sims_station_index()) Ncdf::writeArray4D(nc, anen.sims_station_index(), Config::_SIMS_STATION_IND, sims_dim_, unlimited_);
+    if (anen.save_sims_station_index()) Ncdf::writeIndexArray4D(nc, anen.sims_station_index(), Config::_SIMS_STATION_IND, sims_dim_, unlimited_, getLosslessStorage_());
 
     // Save configuration variables as global attributes
     Ncdf::writeAttribute(nc, Config::_NUM_NEAREST, (int) anen.num_nearest(), NcType::nc_INT, overwrite);
@@ -233,7 +214,7 @@ AnEnWriteNcdf::writeMultiAnEn(const string& file,
 
         // Append analog to the existing file
         if (verbose_ >= Verbose::Progress) cout << "Writing " << pair.first << " values to the output file ..." << endl;
-        Ncdf::writeArray4D(nc, analogs, pair.first, analogs_dim_, unlimited_);
+        Ncdf::writeArray4D(nc, analogs, pair.first, analogs_dim_, unlimited_, storage_);
     }
 
     return;
@@ -289,7 +270,7 @@ AnEnWriteNcdf::writeMultiAnEn(const string& file,
 
         // Append analog to the existing file
         if (verbose_ >= Verbose::Progress) cout << "Writing " << pair.first << " values to the output file ..." << endl;
-        Ncdf::writeArray4D(nc, analogs, pair.first, analogs_dim_, unlimited_);
+        Ncdf::writeArray4D(nc, analogs, pair.first, analogs_dim_, unlimited_, storage_);
     }
 
     return;
@@ -327,6 +308,250 @@ AnEnWriteNcdf::writeMultiAnEn(const string& file,
     return;
 }
 
+void
+AnEnWriteNcdf::createAnEn(const string & file, const AnEnIS & anen,
+        const vector<string> & multi_names,
+        const Times & test_times, const Times & search_times,
+        const Times & forecast_flts, const Parameters & forecast_parameters,
+        const Stations & forecast_stations, size_t num_forecast_times,
+        bool overwrite, const string & fingerprint) const {
+
+    if (verbose_ >= Verbose::Progress) cout << "Creating AnEn variables ..." << endl;
+
+    // Check file path availability
+    Ncdf::checkExists(file, overwrite, false);
+    Ncdf::checkExtension(file);
+
+    NcFile nc(file, NcFile::FileMode::newFile, NcFile::FileFormat::nc4);
+
+    /*
+     * Variables are defined with the shape of the input AnEn except for the
+     * station dimension which has the length of all stations. Values are
+     * written later with writeAnEnStations.
+     */
+    auto lens = [&forecast_stations](const Array4D & arr) {
+        array<size_t, 4> dim_lens = {forecast_stations.size(), arr.shape()[1], arr.shape()[2], arr.shape()[3]};
+        return dim_lens;
+    };
+
+    // Indices are never quantized
+    Ncdf::Storage index_storage = getLosslessStorage_();
+
+    /*
+     * Analog time indices point to observation times. All blocks share the
+     * same observation time table, so the largest entry bounds the analog time
+     * indices of any block. Similarity time indices point to forecast times.
+     * Bounds decide the integer type of index variables.
+     */
+    size_t max_time_index = 0;
+    size_t max_sims_time_index = (num_forecast_times > 0 ? num_forecast_times - 1 : 0);
+    const auto & obs_time_index_table = anen.obs_time_index_table();
+
+    for (size_t row_i = 0; row_i < obs_time_index_table.size1(); ++row_i) {
+        for (size_t col_i = 0; col_i < obs_time_index_table.size2(); ++col_i) {
+            double index = obs_time_index_table(row_i, col_i);
+            if (!std::isnan(index) && index > max_time_index) max_time_index = (size_t) index;
+        }
+    }
+
+    if (anen.save_analogs()) Ncdf::addArray4D(nc, Config::_ANALOGS, analogs_dim_, lens(anen.analogs_value()), unlimited_, storage_);
+    if (anen.save_analogs_time_index()) Ncdf::addIndexArray4D(nc, Config::_ANALOGS_TIME_IND, analogs_dim_, lens(anen.analogs_time_index()), max_time_index, unlimited_, index_storage);
+    if (anen.save_sims()) Ncdf::addArray4D(nc, Config::_SIMS, sims_dim_, lens(anen.sims_metric()), unlimited_, storage_);
+    if (anen.save_sims_time_index()) Ncdf::addIndexArray4D(nc, Config::_SIMS_TIME_IND, sims_dim_, lens(anen.sims_time_index()), max_sims_time_index, unlimited_, index_storage);
+
+    // Multivariate analogs are translated from analogs time index
+    if (!multi_names.empty()) {
+        if (!anen.save_analogs_time_index()) throw runtime_error("Analogs time index should be saved when generating multivariate AnEn. Set config.save_analogs_time_index = true");
+        for (const auto & name : multi_names) Ncdf::addArray4D(nc, name, analogs_dim_, lens(anen.analogs_time_index()), unlimited_, storage_);
+    }
+
+    // Save configuration and dimension variables
+    addAnEnMeta_(nc, anen, test_times, search_times, forecast_flts,
+            forecast_parameters, forecast_stations, overwrite);
+
+    // No stations have been written yet
+    Ncdf::writeAttribute(nc, _STATIONS_WRITTEN, 0, NcType::nc_INT, overwrite);
+    if (!fingerprint.empty()) Ncdf::writeStringAttribute(nc, _FINGERPRINT, fingerprint, overwrite);
+
+    return;
+}
+
+size_t
+AnEnWriteNcdf::readCheckpoint(const string & file, const string & fingerprint) const {
+
+    Ncdf::checkExists(file);
+    Ncdf::checkExtension(file);
+
+    NcFile nc(file, NcFile::FileMode::read);
+
+    NcGroupAtt att_fingerprint = nc.getAtt(_FINGERPRINT);
+    NcGroupAtt att_written = nc.getAtt(_STATIONS_WRITTEN);
+
+    if (att_fingerprint.isNull() || att_written.isNull()) {
+        ostringstream msg;
+        msg << file << " cannot be resumed because it is not created by a run with checkpoints";
+        throw runtime_error(msg.str());
+    }
+
+    string saved_fingerprint;
+    att_fingerprint.getValues(saved_fingerprint);
+
+    if (saved_fingerprint != fingerprint) {
+        ostringstream msg;
+        msg << file << " cannot be resumed because inputs or configuration have changed (fingerprint "
+                << saved_fingerprint << " in the file but " << fingerprint << " for this run)";
+        throw runtime_error(msg.str());
+    }
+
+    int stations_written;
+    att_written.getValues(&stations_written);
+
+    if (verbose_ >= Verbose::Progress) cout << "Resuming " << file << " with "
+            << stations_written << " stations written ..." << endl;
+
+    return stations_written;
+}
+
+void
+AnEnWriteNcdf::writeAnEnStations(const string & file, const AnEnIS & anen,
+        const unordered_map<string, size_t> & obs_map,
+        const Observations & observations, size_t station_start) const {
+
+    if (verbose_ >= Verbose::Progress) cout << "Writing AnEn from station #" << station_start << " ..." << endl;
+
+    NcFile nc(file, NcFile::FileMode::write, NcFile::FileFormat::nc4);
+    array<size_t, 4> start = {station_start, 0, 0, 0};
+
+    if (anen.save_analogs()) Ncdf::writeArray4D(nc, anen.analogs_value(), Config::_ANALOGS, start);
+    if (anen.save_analogs_time_index()) Ncdf::writeArray4D(nc, anen.analogs_time_index(), Config::_ANALOGS_TIME_IND, start);
+    if (anen.save_sims()) Ncdf::writeArray4D(nc, anen.sims_metric(), Config::_SIMS, start);
+    if (anen.save_sims_time_index()) Ncdf::writeArray4D(nc, anen.sims_time_index(), Config::_SIMS_TIME_IND, start);
+
+    // Multivariate analogs are translated from the time index of this block
+    for (const auto & pair : obs_map) {
+        Array4DPointer analogs;
+        Functions::toValues(analogs, pair.second, anen.analogs_time_index(), observations);
+        Ncdf::writeArray4D(nc, analogs, pair.first, start);
+    }
+
+    // Move the progress forward if this block follows the written stations
+    NcGroupAtt att = nc.getAtt(_STATIONS_WRITTEN);
+
+    if (!att.isNull()) {
+        int stations_written;
+        att.getValues(&stations_written);
+
+        if ((size_t) stations_written == station_start) {
+            size_t block_stations;
+            if (anen.save_analogs()) block_stations = anen.analogs_value().shape()[0];
+            else if (anen.save_analogs_time_index()) block_stations = anen.analogs_time_index().shape()[0];
+            else if (anen.save_sims()) block_stations = anen.sims_metric().shape()[0];
+            else block_stations = anen.sims_time_index().shape()[0];
+
+            int num_stations = station_start + block_stations;
+            Ncdf::writeAttribute(nc, _STATIONS_WRITTEN, num_stations, NcType::nc_INT, true);
+        }
+    }
+
+    return;
+}
+
+void
+AnEnWriteNcdf::writeAnEnPart(const string & file, const AnEnIS & anen,
+        size_t station_start, bool overwrite) const {
+
+    if (verbose_ >= Verbose::Progress) cout << "Writing AnEn part from station #" << station_start << " ..." << endl;
+
+    Ncdf::checkExists(file, overwrite, false);
+    Ncdf::checkExtension(file);
+
+    NcFile nc(file, NcFile::FileMode::newFile, NcFile::FileFormat::nc4);
+
+    // Parts are not quantized. Storage settings are applied when parts are concatenated.
+    Ncdf::Storage part_storage = getLosslessStorage_();
+
+    if (anen.save_analogs()) Ncdf::writeArray4D(nc, anen.analogs_value(), Config::_ANALOGS, analogs_dim_, unlimited_, part_storage);
+    if (anen.save_analogs_time_index()) Ncdf::writeIndexArray4D(nc, anen.analogs_time_index(), Config::_ANALOGS_TIME_IND, analogs_dim_, unlimited_, part_storage);
+    if (anen.save_sims()) Ncdf::writeArray4D(nc, anen.sims_metric(), Config::_SIMS, sims_dim_, unlimited_, part_storage);
+    if (anen.save_sims_time_index()) Ncdf::writeIndexArray4D(nc, anen.sims_time_index(), Config::_SIMS_TIME_IND, sims_dim_, unlimited_, part_storage);
+
+    Ncdf::writeAttribute(nc, _STATION_START, (int) station_start, NcType::nc_INT, overwrite);
+
+    return;
+}
+
+void
+AnEnWriteNcdf::concatAnEnParts(const string & file, const vector<string> & part_files) const {
+
+    // Parts are concatenated in the order of stations so that the progress can be recorded
+    vector< pair<size_t, string> > parts;
+
+    for (const auto & part_file : part_files) {
+        Ncdf::checkExists(part_file);
+
+        NcFile nc_part(part_file, NcFile::FileMode::read);
+        NcGroupAtt att = nc_part.getAtt(_STATION_START);
+
+        if (att.isNull()) {
+            ostringstream msg;
+            msg << "The attribute " << _STATION_START << " is missing. " << part_file << " is not an AnEn part file";
+            throw runtime_error(msg.str());
+        }
+
+        int station_start;
+        att.getValues(&station_start);
+        parts.push_back(make_pair(station_start, part_file));
+    }
+
+    sort(parts.begin(), parts.end());
+
+    NcFile nc(file, NcFile::FileMode::write, NcFile::FileFormat::nc4);
+    vector<string> var_names = {Config::_ANALOGS, Config::_ANALOGS_TIME_IND, Config::_SIMS, Config::_SIMS_TIME_IND};
+
+    for (const auto & part : parts) {
+
+        if (verbose_ >= Verbose::Progress) cout << "Concatenating " << part.second << " from station #" << part.first << " ..." << endl;
+
+        NcFile nc_part(part.second, NcFile::FileMode::read);
+        array<size_t, 4> start = {part.first, 0, 0, 0};
+
+        for (const auto & var_name : var_names) {
+            if (!Ncdf::varExists(nc_part, var_name)) continue;
+
+            if (!Ncdf::varExists(nc, var_name)) {
+                ostringstream msg;
+                msg << "Variable " << var_name << " in " << part.second << " is not defined in " << file;
+                throw runtime_error(msg.str());
+            }
+
+            // Variable dimensions are reversed
+            NcVar var = nc_part.getVar(var_name);
+            vector<NcDim> dims = var.getDims();
+
+            Array4DPointer values(dims[3].getSize(), dims[2].getSize(), dims[1].getSize(), dims[0].getSize());
+            var.getVar(values.getValuesPtr());
+            Ncdf::fillIndexNAN(var, values.getValuesPtr(), values.num_elements());
+
+            Ncdf::writeArray4D(nc, values, var_name, start);
+        }
+
+        // Move the progress forward if this part follows the written stations
+        NcGroupAtt att = nc.getAtt(_STATIONS_WRITTEN);
+
+        if (!att.isNull()) {
+            int stations_written;
+            att.getValues(&stations_written);
+
+            if ((size_t) stations_written == part.first) {
+                int num_stations = part.first + nc_part.getDim(Config::_DIM_STATIONS).getSize();
+                Ncdf::writeAttribute(nc, _STATIONS_WRITTEN, num_stations, NcType::nc_INT, true);
+            }
+        }
+    }
+
+    return;
+}
+
 void
 AnEnWriteNcdf::writeForecasts(const string& file,
         const Forecasts & forecasts, bool overwrite, bool append, const string & group_name) const {
@@ -388,7 +613,7 @@ AnEnWriteNcdf::writeForecasts(const string& file,
     array<string, 4> data_dim = {Config::_DIM_PARS, Config::_DIM_STATIONS, Config::_DIM_TIMES, Config::_DIM_FLTS};
     array<bool, 4 > unlimited = {_unlimited_parameters, _unlimited_stations, _unlimited_times, _unlimited_flts};
     
-    Ncdf::writeArray4D(nc_group, forecasts, Config::_DATA, data_dim, unlimited);
+    Ncdf::writeArray4D(nc_group, forecasts, Config::_DATA, data_dim, unlimited, getLosslessStorage_());
 
     // Add the protected member forecast lead times
     vector<size_t> flt_timestamps;
@@ -474,6 +699,7 @@ AnEnWriteNcdf::writeObservations(const string & file,
      * dimension in the initializer list is the slowest varying dimension
      */
     auto var = nc_group.addVar(Config::_DATA, NC_DOUBLE, {dim2, dim1, dim0});
+    Ncdf::setStorage(var, getLosslessStorage_());
 
     // Add observation data
     var.putVar(arr);
@@ -517,6 +743,60 @@ AnEnWriteNcdf::addBasicData_(netCDF::NcGroup& nc_group, const BasicData& basic_d
     return;
 }
 
+void
+AnEnWriteNcdf::addAnEnMeta_(NcGroup & nc, const AnEnIS & anen,
+        const Times & test_times, const Times & search_times,
+        const Times & forecast_flts, const Parameters & forecast_parameters,
+        const Stations & forecast_stations, bool overwrite) const {
+
+    // Save configuration variables as global attributes
+    Ncdf::writeAttribute(nc, Config::_NUM_ANALOGS, (int) anen.num_analogs(), NcType::nc_INT, overwrite);
+    Ncdf::writeAttribute(nc, Config::_NUM_SIMS, (int) anen.num_sims(), NcType::nc_INT, overwrite);
+    Ncdf::writeAttribute(nc, Config::_OBS_ID, (int) anen.obs_var_index(), NcType::nc_INT, overwrite);
+    Ncdf::writeAttribute(nc, Config::_NUM_PAR_NA, (int) anen.max_par_nan(), NcType::nc_INT, overwrite);
+    Ncdf::writeAttribute(nc, Config::_NUM_FLT_NA, (int) anen.max_flt_nan(), NcType::nc_INT, overwrite);
+    Ncdf::writeAttribute(nc, Config::_FLT_RADIUS, (int) anen.flt_radius(), NcType::nc_INT, overwrite);
+    Ncdf::writeAttribute(nc, Config::_OPERATION, (int) anen.operation(), NcType::nc_INT, overwrite);
+    Ncdf::writeAttribute(nc, Config::_QUICK, (int) anen.quick_sort(), NcType::nc_INT, overwrite);
+    Ncdf::writeAttribute(nc, Config::_PREVENT_SEARCH_FUTURE, (int) anen.prevent_search_future(), NcType::nc_INT, overwrite);
+    Ncdf::writeAttribute(nc, Config::_NO_NORM, (int) anen.no_norm(), NcType::nc_INT, overwrite);
+
+    // Save weights with fixed length dimension of num_parameters
+    Ncdf::writeVector(nc, Config::_WEIGHTS, Config::_DIM_PARS, anen.weights(), NcType::nc_DOUBLE, false);
+
+
+    /*************************************************************************
+     *                   Write Extra variables                               *
+     *************************************************************************/
+    vector<size_t> test_timestamps, search_timestamps, flt_timestamps;
+    vector<string> parameter_names;
+
+    // Get values from the objects to write
+    test_times.getTimestamps(test_timestamps);
+    search_times.getTimestamps(search_timestamps);
+    forecast_flts.getTimestamps(flt_timestamps);
+    forecast_parameters.getNames(parameter_names);
+
+    // Write to the file
+    addStations_(nc, forecast_stations, _unlimited_stations);
+    Ncdf::writeVector(nc, Config::_TEST_TIMES, Config::_DIM_TEST_TIMES, test_timestamps, NcType::nc_UINT64, _unlimited_test_times);
+    Ncdf::writeVector(nc, Config::_SEARCH_TIMES, Config::_DIM_SEARCH_TIMES, search_timestamps, NcType::nc_UINT64, _unlimited_search_times);
+    Ncdf::writeVector(nc, Config::_FLTS, Config::_DIM_FLTS, flt_timestamps, NcType::nc_UINT64, _unlimited_flts);
+    Ncdf::writeStringVector(nc, Config::_PAR_NAMES, Config::_DIM_PARS, parameter_names, _unlimited_parameters);
+
+    // Write meta information
+    addMeta_(nc);
+
+    return;
+}
+
+Ncdf::Storage
+AnEnWriteNcdf::getLosslessStorage_() const {
+    Ncdf::Storage storage = storage_;
+    storage.significant_digits = 0;
+    return storage;
+}
+
 void
 AnEnWriteNcdf::addStations_(netCDF::NcGroup& nc, const Stations & stations, bool unlimited) const {
 
@@ -0,0 +1,160 @@
+/*
+ * File:   AnEnWriteNcdfQueue.cpp
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#include "AnEnWriteNcdfQueue.h"
+
+#include <algorithm>
+
+using namespace std;
+
+AnEnWriteNcdfQueue::AnEnWriteNcdfQueue(const AnEnWriteNcdf & writer,
+        const string & file, size_t max_pending) :
+writer_(writer), file_(file), max_pending_(max(max_pending, (size_t) 1)),
+num_pending_(0), stop_(false) {
+    thread_ = thread(&AnEnWriteNcdfQueue::run_, this);
+}
+
+AnEnWriteNcdfQueue::~AnEnWriteNcdfQueue() {
+
+    // Pending blocks are still written. Errors are not thrown from a destructor.
+    if (thread_.joinable()) {
+        {
+            lock_guard<mutex> lock(mutex_);
+            stop_ = true;
+        }
+
+        cv_.notify_all();
+        thread_.join();
+    }
+}
+
+void
+AnEnWriteNcdfQueue::create(const AnEnIS & anen,
+        const unordered_map<string, size_t> & obs_map,
+        const Times & test_times, const Times & search_times,
+        const Times & forecast_flts, const Parameters & forecast_parameters,
+        const Stations & forecast_stations, size_t num_forecast_times,
+        bool overwrite, const string & fingerprint) {
+
+    obs_map_ = obs_map;
+
+    vector<string> multi_names;
+    for (const auto & pair : obs_map_) multi_names.push_back(pair.first);
+
+    lock_guard<mutex> ncdf_lock(Ncdf::getMutex());
+    writer_.createAnEn(file_, anen, multi_names, test_times, search_times,
+            forecast_flts, forecast_parameters, forecast_stations, num_forecast_times,
+            overwrite, fingerprint);
+
+    return;
+}
+
+void
+AnEnWriteNcdfQueue::resume(const unordered_map<string, size_t> & obs_map) {
+    obs_map_ = obs_map;
+    return;
+}
+
+void
+AnEnWriteNcdfQueue::push(size_t station_start, unique_ptr<AnEnIS> anen,
+        ObservationsPointer && observations) {
+
+    if (!anen) throw runtime_error("AnEn of a block should not be empty");
+
+    unique_lock<mutex> lock(mutex_);
+
+    // Wait for the writer to release a block
+    cv_.wait(lock, [this] {
+        return num_pending_ < max_pending_ || error_;
+    });
+
+    if (stop_) throw runtime_error("The writer has been finished");
+    checkError_();
+
+    Block block;
+    block.station_start = station_start;
+    block.anen = std::move(anen);
+    block.observations = std::move(observations);
+
+    blocks_.push_back(std::move(block));
+    num_pending_++;
+
+    lock.unlock();
+    cv_.notify_all();
+
+    return;
+}
+
+void
+AnEnWriteNcdfQueue::finish() {
+
+    {
+        lock_guard<mutex> lock(mutex_);
+        stop_ = true;
+    }
+
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+
+    lock_guard<mutex> lock(mutex_);
+    checkError_();
+
+    return;
+}
+
+void
+AnEnWriteNcdfQueue::run_() {
+
+    while (true) {
+
+        Block block;
+        bool failed;
+
+        {
+            unique_lock<mutex> lock(mutex_);
+            cv_.wait(lock, [this] {
+                return stop_ || !blocks_.empty();
+            });
+
+            // Stop after all blocks have been written
+            if (blocks_.empty()) break;
+
+            block = std::move(blocks_.front());
+            blocks_.pop_front();
+            failed = (bool) error_;
+        }
+
+        // Blocks after an error are discarded
+        if (!failed) {
+            try {
+                lock_guard<mutex> ncdf_lock(Ncdf::getMutex());
+                writer_.writeAnEnStations(file_, *(block.anen), obs_map_,
+                        block.observations, block.station_start);
+            } catch (...) {
+                lock_guard<mutex> lock(mutex_);
+                error_ = current_exception();
+            }
+        }
+
+        // Release memory before the block is counted as done
+        block.anen.reset();
+        block.observations = ObservationsPointer();
+
+        {
+            lock_guard<mutex> lock(mutex_);
+            num_pending_--;
+        }
+
+        cv_.notify_all();
+    }
+
+    return;
+}
+
+void
+AnEnWriteNcdfQueue::checkError_() {
+    if (error_) rethrow_exception(error_);
+    return;
+}
@@ -10,6 +10,9 @@
 #include <array>
 #include <cmath>
 #include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <cstdint>
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
@@ -30,6 +33,8 @@ namespace fs = boost::filesystem;
 static const size_t _SECONDS_IN_DAY = 24 * 60 * 60;
 static const size_t _SECONDS_IN_HOUR = 60 * 60;
 
+static const string _MANIFEST_HEADER = "PAnEnFileManifest2";
+
 void
 FunctionsIO::toParameterVector(
         vector<ParameterGrib> & grib_parameters,
@@ -114,32 +119,65 @@ FunctionsIO::parseFilenames(Times & times, Times & flts,
     //
     if (!is_sorted(files.begin(), files.end())) throw runtime_error("Filenames should be odered in ascension order");
 
-    // Convert regular expression string to a regular expression object
-    sregex rex = sregex::compile(regex_str);
+    // Parse each file name
+    vector<Time> file_times, file_flts;
+    vector<char> parsed;
+    parseFilenames(file_times, file_flts, parsed, files, regex_str, unit_in_seconds, delimited);
+
+    /*
+     * Collect unique time stamps with one sort instead of inserting every
+     * file into the bidirectional map
+     */
+    vector<size_t> unique_times, unique_flts;
+    unique_times.reserve(files.size());
+    unique_flts.reserve(files.size());
+
+    for (size_t file_i = 0; file_i < files.size(); ++file_i) {
+        if (parsed[file_i]) {
+            unique_times.push_back(file_times[file_i].timestamp);
+            unique_flts.push_back(file_flts[file_i].timestamp);
+        }
+    }
+
+    sort(unique_times.begin(), unique_times.end());
+    unique_times.erase(unique(unique_times.begin(), unique_times.end()), unique_times.end());
+
+    sort(unique_flts.begin(), unique_flts.end());
+    unique_flts.erase(unique(unique_flts.begin(), unique_flts.end()), unique_flts.end());
 
     // Start with clean repositories
     times.clear();
     flts.clear();
 
-    Time time, flt;
+    for (auto timestamp : unique_times) times.push_back(Time(timestamp));
+    for (auto timestamp : unique_flts) flts.push_back(Time(timestamp));
+
+    return;
+}
+
+void
+FunctionsIO::parseFilenames(vector<Time> & file_times, vector<Time> & file_flts,
+        vector<char> & parsed, const vector<string> & files,
+        const string & regex_str, size_t unit_in_seconds, bool delimited) {
+
+    // Convert regular expression string to a regular expression object.
+    // A compiled regular expression can be shared by threads for matching.
+    //
+    sregex rex = sregex::compile(regex_str);
 
     // Determine our start day
     date start_day(from_string(Time::_origin));
 
-    // Loop through each file from the file list
-    auto it_end = files.end();
-    for (auto it = files.begin(); it != it_end; ++it) {
-
-        // Try to parse time information from the file name
-        bool ret = parseFilename(time, flt, *it, start_day, rex, unit_in_seconds, delimited);
+    size_t num_files = files.size();
+    file_times.resize(num_files);
+    file_flts.resize(num_files);
+    parsed.resize(num_files);
 
-        // If information is successfully parsed, record the information;
-        // otherwise, this file is removed from further process.
-        //
-        if (ret) {
-            times.push_back(time);
-            flts.push_back(flt);
-        }
+#pragma omp parallel for default(none) schedule(static) \
+shared(file_times, file_flts, parsed, files, rex, start_day, unit_in_seconds, delimited, num_files)
+    for (size_t file_i = 0; file_i < num_files; ++file_i) {
+        parsed[file_i] = parseFilename(file_times[file_i], file_flts[file_i],
+                files[file_i], start_day, rex, unit_in_seconds, delimited);
     }
 
     return;
@@ -147,7 +185,8 @@ FunctionsIO::parseFilenames(Times & times, Times & flts,
 
 void
 FunctionsIO::listFiles(vector<string> & files,
-        const string & folder, const string & regex_str) {
+        const string & folder, const string & regex_str,
+        const string & manifest, Verbose verbose) {
 
     // Convert string to boost filesystem path
     fs::path folder_path(folder.c_str());
@@ -167,45 +206,121 @@ FunctionsIO::listFiles(vector<string> & files,
 
     } else {
         // A folder containing files is passed
-        
-        // Get the total number of files in this folder
-        size_t total_files = totalFiles(folder);
 
-        // Allocate memory
-        files.resize(total_files);
+        // Use the cached list if the folder has not changed
+        if (!manifest.empty() && readManifest(files, manifest, folder, regex_str)) return;
+
+        if (folder.empty()) throw runtime_error("Specify folder");
+        if (!fs::exists(folder_path)) throw runtime_error("Input path does not exists");
+        if (!fs::is_directory(folder_path)) throw runtime_error("Input path is not a directory");
 
         // Compile the regular expression to make sure it is valid
         sregex rex = sregex::compile(regex_str);
 
-        // Extract filenames that matches the regular expression
-        fs::directory_iterator it(folder), endit;
-
-        size_t pos = 0;
-        fs::path filepath;
+        // Iterating a directory is serial. Only names are collected here.
+        vector<string> filenames;
+        fs::directory_iterator it(folder_path), endit;
 
-        while (it != endit) {
-
-            // If this is a regular file
-            if (fs::is_regular_file(it->status())) {
-                filepath = it->path().filename();
+        for (; it != endit; ++it) {
+            if (fs::is_regular_file(it->status())) filenames.push_back(it->path().filename().string());
+        }
 
-                // Check regular expression
-                if (regex_match(filepath.string(), rex)) {
-                    files[pos] = (folder_path/filepath).string();
-                    pos++;
-                }
-            }
+        // Match names against the regular expression in parallel
+        size_t num_names = filenames.size();
+        vector<char> matched(num_names);
 
-            it++;
+#pragma omp parallel for default(none) schedule(static) shared(filenames, matched, rex, num_names)
+        for (size_t name_i = 0; name_i < num_names; ++name_i) {
+            matched[name_i] = regex_match(filenames[name_i], rex);
         }
 
-        // Erase the empty slots if not all files are included
-        if (pos != total_files) files.erase(files.begin() + pos, files.end());
+        files.clear();
+        for (size_t name_i = 0; name_i < num_names; ++name_i) {
+            if (matched[name_i]) files.push_back((folder_path / filenames[name_i]).string());
+        }
     }
 
     // Sort file names
     sort(files.begin(), files.end());
 
+    if (!manifest.empty() && fs::is_directory(folder_path)) writeManifest(files, manifest, folder, regex_str, verbose);
+
+    return;
+}
+
+bool
+FunctionsIO::readManifest(vector<string> & files, const string & manifest,
+        const string & folder, const string & regex_str) {
+
+    ifstream ifs(manifest);
+    if (!ifs) return false;
+
+    // The manifest is valid only for the same folder, expression, and modification time
+    string header, line;
+    time_t folder_time;
+    size_t num_files;
+
+    if (!getline(ifs, header) || header != _MANIFEST_HEADER) return false;
+    if (!getline(ifs, line) || line != fs::absolute(folder).string()) return false;
+    if (!getline(ifs, line) || line != regex_str) return false;
+    if (!(ifs >> folder_time) || !getline(ifs, line)) return false;
+    if (!(ifs >> num_files) || !getline(ifs, line)) return false;
+
+    try {
+        if (folder_time != fs::last_write_time(folder)) return false;
+    } catch (exception & e) {
+        return false;
+    }
+
+    vector<string> manifest_files;
+    while (getline(ifs, line)) {
+        if (!line.empty()) manifest_files.push_back(line);
+    }
+
+    // A short manifest is incomplete
+    if (manifest_files.size() != num_files) return false;
+
+    files.swap(manifest_files);
+    return true;
+}
+
+void
+FunctionsIO::writeManifest(const vector<string> & files, const string & manifest,
+        const string & folder, const string & regex_str, Verbose verbose) {
+
+    /*
+     * Write to a temporary file first and then rename it, so that concurrent
+     * runs never read a partial manifest. Failures are not fatal because the
+     * manifest is only a cache.
+     */
+    ostringstream tmp_file;
+    tmp_file << manifest << "." << fs::unique_path("%%%%-%%%%-%%%%-%%%%").string() << ".tmp";
+
+    try {
+        {
+            ofstream ofs(tmp_file.str());
+            if (!ofs) throw runtime_error("Failed to open the file");
+
+            ofs << _MANIFEST_HEADER << endl
+                    << fs::absolute(folder).string() << endl
+                    << regex_str << endl
+                    << fs::last_write_time(folder) << endl
+                    << files.size() << endl;
+
+            for (const auto & file : files) ofs << file << endl;
+
+            if (!ofs) throw runtime_error("Failed to write the file");
+        }
+
+        fs::rename(tmp_file.str(), manifest);
+
+    } catch (exception & e) {
+        if (verbose >= Verbose::Warning) cerr << "Warning: The manifest " << manifest << " is not saved: " << e.what() << endl;
+
+        boost::system::error_code ec;
+        fs::remove(tmp_file.str(), ec);
+    }
+
     return;
 }
 
@@ -230,3 +345,31 @@ FunctionsIO::totalFiles(const string & folder) {
 
     return total_files;
 }
+
+string
+FunctionsIO::fingerprint(const string & content, const vector<string> & files) {
+
+    ostringstream description;
+    description << content << endl;
+
+    for (const auto & file : files) {
+        fs::path file_path(file.c_str());
+        if (!fs::exists(file_path)) throw runtime_error("File does not exist: " + file);
+
+        description << fs::absolute(file_path).string() << " "
+                << fs::file_size(file_path) << " "
+                << fs::last_write_time(file_path) << endl;
+    }
+
+    // 64-bit FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (unsigned char c : description.str()) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+
+    ostringstream digits;
+    digits << hex << setw(16) << setfill('0') << hash;
+    return digits.str();
+}
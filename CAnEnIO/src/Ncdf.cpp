@@ -6,6 +6,8 @@
  */
 
 #include <cmath>
+#include <limits>
+#include <algorithm>
 
 #include "boost/filesystem.hpp"
 
@@ -15,10 +17,107 @@
 // This is maximum count of characters allowed in a single name
 static int _MAX_LENGTH = 200;
 
+// HDF5 does not allow chunks of 4 GiB or larger
+static const size_t _MAX_CHUNK_BYTES = 4294967295;
+
 namespace filesys = boost::filesystem;
 using namespace netCDF;
 using namespace std;
 
+/*
+ * Converts index values to unsigned integers. The largest value of the type
+ * is reserved as the fill value for NAN.
+ */
+template <typename T>
+static void
+toIndexValues_(const Array4D & arr, vector<T> & indices) {
+
+    const T fill = numeric_limits<T>::max();
+    const double *p_vals = arr.getValuesPtr();
+    size_t num_elements = arr.num_elements();
+
+    indices.resize(num_elements);
+
+    for (size_t i = 0; i < num_elements; ++i) {
+        if (std::isnan(p_vals[i])) {
+            indices[i] = fill;
+        } else if (p_vals[i] < 0 || p_vals[i] >= fill) {
+            ostringstream msg;
+            msg << "Index " << p_vals[i] << " cannot be stored as an unsigned integer with the fill value " << fill;
+            throw runtime_error(msg.str());
+        } else {
+            indices[i] = (T) p_vals[i];
+        }
+    }
+
+    return;
+}
+
+/*
+ * Defines a 4-dimensional variable of the given type with dimensions created
+ * or checked by name.
+ */
+static NcVar
+defineArray4D_(NcGroup & nc, const string & var_name,
+        const array<string, 4> & dim_names, const array<size_t, 4> & dim_lens,
+        const array<bool, 4> & unlimited, NcType::ncType type) {
+
+    if (var_name.empty()) throw runtime_error("Ncdf::addArray4D -> Empty variable name is not allowed");
+
+    // Check whether the variable name already exists
+    NcVar var = nc.getVar(var_name);
+    if (!var.isNull()) {
+        ostringstream msg;
+        msg << "Variable " << var_name << " exists";
+        throw runtime_error(msg.str());
+    }
+
+    NcDim dim0, dim1, dim2, dim3;
+    try {
+        dim0 = Ncdf::getDimension(nc, dim_names[0], unlimited[0], dim_lens[0]);
+        dim1 = Ncdf::getDimension(nc, dim_names[1], unlimited[1], dim_lens[1]);
+        dim2 = Ncdf::getDimension(nc, dim_names[2], unlimited[2], dim_lens[2]);
+        dim3 = Ncdf::getDimension(nc, dim_names[3], unlimited[3], dim_lens[3]);
+    } catch (exception & e) {
+        ostringstream msg;
+        msg << "addArray4D(var_name = " << var_name << ") -> " << e.what();
+        throw runtime_error(msg.str());
+    }
+
+    /*
+     * Create an NetCDF variable. Note the reversed dimension order so that we
+     * can copy values from the column-major ordered pointer directly. The first
+     * dimension in the initializer list is the slowest varying dimension
+     */
+    return nc.addVar(var_name, type, {dim3, dim2, dim1, dim0});
+}
+
+/*
+ * Writes index values into a variable of unsigned integers
+ */
+static void
+putIndexValues_(const NcVar & var, const Array4D & arr,
+        const vector<size_t> & start, const vector<size_t> & count) {
+
+    if (var.getType().getId() == NC_USHORT) {
+        vector<unsigned short> indices;
+        toIndexValues_(arr, indices);
+        var.putVar(start, count, indices.data());
+
+    } else if (var.getType().getId() == NC_UINT) {
+        vector<unsigned int> indices;
+        toIndexValues_(arr, indices);
+        var.putVar(start, count, indices.data());
+
+    } else {
+        ostringstream msg;
+        msg << "Variable " << var.getName() << " should be stored as unsigned short or unsigned int for indices";
+        throw runtime_error(msg.str());
+    }
+
+    return;
+}
+
 size_t
 Ncdf::readDimLength(const string & file_path, const string dim_name) {
 
@@ -370,64 +469,259 @@ Ncdf::writeStringVector(NcGroup & nc, const std::string & var_name,
 
 void
 Ncdf::writeArray4D(NcGroup & nc, const Array4D & arr, const string & var_name,
-        const array<string, 4> & dim_names, const array<bool, 4 > & unlimited) {
+        const array<string, 4> & dim_names, const array<bool, 4 > & unlimited,
+        const Storage & storage) {
 
     if (var_name.empty()) throw runtime_error("Ncdf::writeArray4D -> Empty variable name is not allowed");
 
     // Check whether array is column major
-    if (arr.num_elements() >= 2) {
-        double value_array_form = arr.getValue(1, 0, 0, 0);
-        double value_pointer_form = arr.getValuesPtr()[1];
-
-        if (std::isnan(value_array_form) || std::isnan(value_pointer_form)) {
-            
-            // If any of the values is NAN, both of them must be NAN
-            if (std::isnan(value_array_form) && std::isnan(value_pointer_form)) {
-                // Expected
-            } else {
-                throw runtime_error("The input array is not column major");
-            }
+    checkColumnMajor(arr);
 
-        } else {
+    // Create the variable and write all values
+    const size_t *dims = arr.shape();
+    NcVar var = addArray4D(nc, var_name, dim_names, {dims[0], dims[1], dims[2], dims[3]}, unlimited, storage);
 
-            // If both values are valid, compare the values
-            if (value_array_form != value_pointer_form) {
-                throw runtime_error("The input array is not column major");
-            }
-        }
-    }
+    var.putVar(arr.getValuesPtr());
+    return;
+}
+
+void
+Ncdf::writeArray4D(NcGroup & nc, const Array4D & arr, const string & var_name,
+        const array<size_t, 4> & start) {
+
+    if (var_name.empty()) throw runtime_error("Ncdf::writeArray4D -> Empty variable name is not allowed");
 
-    // Check whether the variable name already exists
     NcVar var = nc.getVar(var_name);
-    if (!var.isNull()) {
+    if (var.isNull()) {
         ostringstream msg;
-        msg << "Variable " << var_name << " exists";
+        msg << "Variable " << var_name << " does not exist. Define it with Ncdf::addArray4D first";
         throw runtime_error(msg.str());
     }
 
-    NcDim dim0, dim1, dim2, dim3;
-    try {
-        dim0 = getDimension(nc, dim_names[0], unlimited[0], arr.shape()[0]);
-        dim1 = getDimension(nc, dim_names[1], unlimited[1], arr.shape()[1]);
-        dim2 = getDimension(nc, dim_names[2], unlimited[2], arr.shape()[2]);
-        dim3 = getDimension(nc, dim_names[3], unlimited[3], arr.shape()[3]);
-    } catch (exception & e) {
+    // Check whether array is column major
+    checkColumnMajor(arr);
+
+    // Check whether the block fits in the variable. Variable dimensions are reversed.
+    const size_t *dims = arr.shape();
+    vector<NcDim> var_dims = var.getDims();
+
+    if (var_dims.size() != 4) {
         ostringstream msg;
-        msg << "writeArray4D(var_name = " << var_name << ") -> " << e.what();
+        msg << "Variable " << var_name << " should have 4 dimensions";
+        throw runtime_error(msg.str());
+    }
+
+    for (size_t i = 0; i < 4; ++i) {
+        if (!var_dims[3 - i].isUnlimited()) checkIndex(start[i], dims[i], var_dims[3 - i].getSize());
+    }
+
+    vector<size_t> var_start = {start[3], start[2], start[1], start[0]};
+    vector<size_t> var_count = {dims[3], dims[2], dims[1], dims[0]};
+
+    if (var.getType().getId() == NC_DOUBLE) var.putVar(var_start, var_count, arr.getValuesPtr());
+    else putIndexValues_(var, arr, var_start, var_count);
+
+    return;
+}
+
+NcVar
+Ncdf::addIndexArray4D(NcGroup & nc, const string & var_name,
+        const array<string, 4> & dim_names, const array<size_t, 4> & dim_lens,
+        size_t max_index, const array<bool, 4> & unlimited, const Storage & storage) {
+
+    if (max_index >= numeric_limits<unsigned int>::max()) {
+        ostringstream msg;
+        msg << "The maximum index " << max_index << " of " << var_name << " is too large to be stored as unsigned int";
+        throw runtime_error(msg.str());
+    }
+
+    NcVar var;
+
+    if (max_index < numeric_limits<unsigned short>::max()) {
+        var = defineArray4D_(nc, var_name, dim_names, dim_lens, unlimited, NcType::nc_USHORT);
+        var.setFill(true, numeric_limits<unsigned short>::max());
+    } else {
+        var = defineArray4D_(nc, var_name, dim_names, dim_lens, unlimited, NcType::nc_UINT);
+        var.setFill(true, numeric_limits<unsigned int>::max());
+    }
+
+    // Indices are never quantized
+    Storage index_storage = storage;
+    index_storage.significant_digits = 0;
+    setStorage(var, index_storage);
+
+    return var;
+}
+
+void
+Ncdf::writeIndexArray4D(NcGroup & nc, const Array4D & arr, const string & var_name,
+        const array<string, 4> & dim_names, const array<bool, 4> & unlimited,
+        const Storage & storage) {
+
+    checkColumnMajor(arr);
+
+    // Find the largest index to decide the integer type
+    size_t max_index = 0;
+    const double *p_vals = arr.getValuesPtr();
+
+    for (size_t i = 0; i < arr.num_elements(); ++i) {
+        if (!std::isnan(p_vals[i]) && p_vals[i] > max_index) max_index = (size_t) p_vals[i];
+    }
+
+    const size_t *dims = arr.shape();
+    NcVar var = addIndexArray4D(nc, var_name, dim_names, {dims[0], dims[1], dims[2], dims[3]}, max_index, unlimited, storage);
+
+    putIndexValues_(var, arr, {0, 0, 0, 0}, {dims[3], dims[2], dims[1], dims[0]});
+    return;
+}
+
+void
+Ncdf::fillIndexNAN(const NcVar & var, double * p_vals, size_t num_elements) {
+
+    double fill;
+    int type = var.getType().getId();
+
+    if (type == NC_USHORT) fill = numeric_limits<unsigned short>::max();
+    else if (type == NC_UINT) fill = numeric_limits<unsigned int>::max();
+    else return;
+
+    // A fill value set by other tools takes precedence
+    auto atts = var.getAtts();
+    auto it = atts.find("_FillValue");
+    if (it != atts.end()) it->second.getValues(&fill);
+
+    for (size_t i = 0; i < num_elements; ++i) {
+        if (p_vals[i] == fill) p_vals[i] = NAN;
+    }
+
+    return;
+}
+
+NcVar
+Ncdf::addArray4D(NcGroup & nc, const string & var_name,
+        const array<string, 4> & dim_names, const array<size_t, 4> & dim_lens,
+        const array<bool, 4> & unlimited, const Storage & storage) {
+
+    NcVar var = defineArray4D_(nc, var_name, dim_names, dim_lens, unlimited, NcType::nc_DOUBLE);
+    setStorage(var, storage);
+
+    return var;
+}
+
+bool
+Ncdf::Storage::isDefault() const {
+    return deflate_level == 0 && !shuffle && significant_digits == 0 && chunk_stations == 0;
+}
+
+void
+Ncdf::setStorage(NcVar & var, const Storage & storage) {
+
+    if (storage.isDefault()) return;
+
+    if (storage.deflate_level < 0 || storage.deflate_level > 9) {
+        ostringstream msg;
+        msg << "Deflate level should be within [0, 9]. Got " << storage.deflate_level;
         throw runtime_error(msg.str());
     }
 
     /*
-     * Create an NetCDF variable. Note the reversed dimension order so that we
-     * can copy values from the column-major ordered pointer directly. The first
-     * dimension in the initializer list is the slowest varying dimension
+     * Chunk along the station dimension. Other dimensions are kept whole in a
+     * chunk so that all values of a station can be read from one chunk.
+     *
+     * If such a chunk reaches the HDF5 limit, the times dimension is split
+     * first, then the other dimensions from the slowest varying one, and
+     * stations last.
      */
-    var = nc.addVar(var_name, NC_DOUBLE,{dim3, dim2, dim1, dim0});
+    if (storage.chunk_stations > 0) {
+
+        vector<NcDim> dims = var.getDims();
+        vector<size_t> chunk_sizes(dims.size()), split_order;
+        size_t chunk_bytes = var.getType().getSize();
+
+        for (size_t i = 0; i < dims.size(); ++i) {
+            size_t len = (dims[i].isUnlimited() ? 1 : dims[i].getSize());
+            if (dims[i].getName() == Config::_DIM_STATIONS) len = min(len, storage.chunk_stations);
+            chunk_sizes[i] = max(len, (size_t) 1);
+            chunk_bytes *= chunk_sizes[i];
+
+            if (dims[i].getName() == Config::_DIM_TIMES) split_order.insert(split_order.begin(), i);
+            else if (dims[i].getName() != Config::_DIM_STATIONS) split_order.push_back(i);
+        }
+
+        for (size_t i = 0; i < dims.size(); ++i) {
+            if (dims[i].getName() == Config::_DIM_STATIONS) split_order.push_back(i);
+        }
+
+        for (size_t i : split_order) {
+            if (chunk_bytes <= _MAX_CHUNK_BYTES) break;
+
+            // The size of a chunk with only one value on this dimension
+            size_t slice_bytes = chunk_bytes / chunk_sizes[i];
+            chunk_sizes[i] = max(_MAX_CHUNK_BYTES / slice_bytes, (size_t) 1);
+            chunk_bytes = slice_bytes * chunk_sizes[i];
+        }
+
+        var.setChunking(NcVar::nc_CHUNKED, chunk_sizes);
+    }
+
+    // Compression filters
+    if (storage.deflate_level > 0 || storage.shuffle) {
+        var.setCompression(storage.shuffle, storage.deflate_level > 0, storage.deflate_level);
+    }
+
+    // Lossy quantization is only available from NetCDF 4.9.0
+    if (storage.significant_digits > 0) {
+#if defined(NC_QUANTIZE_BITGROOM)
+        int status = nc_def_var_quantize(var.getParentGroup().getId(), var.getId(),
+                NC_QUANTIZE_BITGROOM, storage.significant_digits);
+
+        if (status != NC_NOERR) {
+            ostringstream msg;
+            msg << "Failed to quantize " << var.getName() << ": " << nc_strerror(status);
+            throw runtime_error(msg.str());
+        }
+#else
+        throw runtime_error("Quantization requires NetCDF 4.9.0 or later");
+#endif
+    }
 
-    var.putVar(arr.getValuesPtr());
     return;
 }
 
+void
+Ncdf::checkColumnMajor(const Array4D & arr) {
+
+    if (arr.num_elements() < 2) return;
+
+    double value_array_form = arr.getValue(1, 0, 0, 0);
+    double value_pointer_form = arr.getValuesPtr()[1];
+
+    if (std::isnan(value_array_form) || std::isnan(value_pointer_form)) {
+
+        // If any of the values is NAN, both of them must be NAN
+        if (std::isnan(value_array_form) && std::isnan(value_pointer_form)) {
+            // Expected
+        } else {
+            throw runtime_error("The input array is not column major");
+        }
+
+    } else {
+
+        // If both values are valid, compare the values
+        if (value_array_form != value_pointer_form) {
+            throw runtime_error("The input array is not column major");
+        }
+    }
+
+    return;
+}
+
+mutex &
+Ncdf::getMutex() {
+    static mutex ncdf_mutex;
+    return ncdf_mutex;
+}
+
 void
 Ncdf::purge(string & str) {
     str.erase(remove_if(str.begin(), str.end(), [](const unsigned char & c) {
@@ -13,6 +13,8 @@ const string ParameterGrib::_key_id = "parameter";
 const string ParameterGrib::_key_level = "level";
 const string ParameterGrib::_key_level_type = "typeOfLevel";
 const string ParameterGrib::_key_values = "values";
+const string ParameterGrib::_key_offset = "offset";
+const string ParameterGrib::_key_length = "totalLength";
 
 ParameterGrib::ParameterGrib() : Parameter::Parameter() {
 }
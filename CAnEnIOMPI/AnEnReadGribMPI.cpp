@@ -252,6 +252,7 @@ AnEnReadGribMPI::readForecasts(Forecasts & forecasts,
         // Read the assigned files
         ForecastsPointer forecasts_subset;
         AnEnReadGrib anen_read(worker_verbose_);
+        anen_read.setIndex(use_index_);
         anen_read.readForecasts(forecasts_subset, grib_parameters, files_subset,
                 regex_str, flt_unit_in_seconds, delimited, stations_index);
 
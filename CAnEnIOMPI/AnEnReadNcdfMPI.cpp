@@ -0,0 +1,407 @@
+/*
+ * File:   AnEnReadNcdfMPI.cpp
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#include "Ncdf.h"
+#include "Functions.h"
+#include "AnEnReadNcdfMPI.h"
+#include "ForecastsPointer.h"
+#include "ObservationsPointer.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <boost/numeric/conversion/cast.hpp>
+
+using namespace std;
+using namespace netCDF;
+
+/**
+ * Creates the datatype of a block of stations in a column-major array with
+ * parameters as the first and stations as the second dimension.
+ */
+static MPI_Datatype
+createStationBlockType_(const vector<size_t> & shape, size_t num_block_stations) {
+
+    size_t num_blocks = 1;
+    for (size_t dim_i = 2; dim_i < shape.size(); ++dim_i) num_blocks *= shape[dim_i];
+
+    MPI_Datatype block_type, type;
+    MPI_Type_contiguous(boost::numeric_cast<int>(shape[0] * num_block_stations), MPI_DOUBLE, &block_type);
+
+    // Bytes between the same station of two consecutive times or lead times
+    MPI_Aint stride = shape[0] * shape[1] * sizeof(double);
+    MPI_Type_create_hvector(boost::numeric_cast<int>(num_blocks), 1, stride, block_type, &type);
+    MPI_Type_free(&block_type);
+    MPI_Type_commit(&type);
+
+    return type;
+}
+
+AnEnReadNcdfMPI::AnEnReadNcdfMPI() {
+    Config config;
+    worker_verbose_ = config.worker_verbose;
+}
+
+AnEnReadNcdfMPI::AnEnReadNcdfMPI(const AnEnReadNcdfMPI& orig) : AnEnReadNcdf(orig) {
+    worker_verbose_ = orig.worker_verbose_;
+}
+
+AnEnReadNcdfMPI::AnEnReadNcdfMPI(Verbose master_verbose) : AnEnReadNcdf(master_verbose) {
+    Config config;
+    worker_verbose_ = config.worker_verbose;
+}
+
+AnEnReadNcdfMPI::AnEnReadNcdfMPI(Verbose master_verbose, Verbose worker_verbose) :
+AnEnReadNcdf(master_verbose), worker_verbose_(worker_verbose) {
+}
+
+AnEnReadNcdfMPI::~AnEnReadNcdfMPI() {
+}
+
+void
+AnEnReadNcdfMPI::readForecasts(const string & file_path, Forecasts & forecasts) const {
+
+    int world_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    if (world_rank == 0) {
+
+        // The master only reads dimensions
+        if (verbose_ >= Verbose::Progress) cout << "Reading forecast dimensions (" << file_path << ") ..." << endl;
+
+        Parameters parameters;
+        Stations stations;
+        Times times, flts;
+
+        readDimensions_(file_path, FileType::Forecasts, parameters, stations, times, flts);
+
+        // No memory is allocated for values
+        forecasts.setMembers(parameters, stations, times);
+        forecasts.getFLTs() = flts;
+    }
+
+    int station_start, station_count;
+
+    if (getStationBlock_(file_path, world_rank, station_start, station_count)) {
+        AnEnReadNcdf reader(worker_verbose_);
+        reader.readForecasts(file_path, forecasts, station_start, station_count);
+    }
+
+    return;
+}
+
+void
+AnEnReadNcdfMPI::readObservations(const string & file_path, Observations & observations) const {
+
+    int world_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    if (world_rank == 0) {
+
+        // The master only reads dimensions
+        if (verbose_ >= Verbose::Progress) cout << "Reading observation dimensions (" << file_path << ") ..." << endl;
+
+        Parameters parameters;
+        Stations stations;
+        Times times, flts;
+
+        readDimensions_(file_path, FileType::Observations, parameters, stations, times, flts);
+
+        // No memory is allocated for values
+        observations.setMembers(parameters, stations, times);
+    }
+
+    int station_start, station_count;
+
+    if (getStationBlock_(file_path, world_rank, station_start, station_count)) {
+        AnEnReadNcdf reader(worker_verbose_);
+        reader.readObservations(file_path, observations, station_start, station_count);
+    }
+
+    return;
+}
+
+bool
+AnEnReadNcdfMPI::getStationBlock_(const string & file_path, int world_rank,
+        int & station_start, int & station_count) const {
+
+    int num_procs;
+    unsigned long num_stations;
+
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+    if (world_rank == 0) num_stations = Ncdf::readDimLength(file_path, Config::_DIM_STATIONS);
+    MPI_Bcast(&num_stations, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+
+    // Processes beyond the number of stations plus 1 are idle
+    if (num_procs > (int) num_stations + 1) num_procs = num_stations + 1;
+
+    if (world_rank == 0 || world_rank >= num_procs) return false;
+
+    station_start = Functions::getStartIndex(num_stations, num_procs, world_rank);
+    station_count = Functions::getSubTotal(num_stations, num_procs, world_rank);
+
+    if (worker_verbose_ >= Verbose::Detail) cout << "Worker #" << world_rank << " reads "
+            << station_count << " stations from #" << station_start << " (" << file_path << ")" << endl;
+
+    return true;
+}
+
+void
+AnEnReadNcdfMPI::gatherForecasts(const string & file_path, Forecasts & forecasts) const {
+
+    int world_rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    // A single process reads everything by itself
+    if (num_procs == 1) {
+        AnEnReadNcdf::readForecasts(file_path, forecasts);
+        return;
+    }
+
+    // The master reads dimensions and the chunk length of stations
+    string error_msg;
+    unsigned long sizes[5];
+
+    if (world_rank == 0) {
+        if (verbose_ >= Verbose::Progress) cout << "Reading forecast file in parallel (" << file_path << ") ..." << endl;
+
+        try {
+            Parameters parameters;
+            Stations stations;
+            Times times, flts;
+
+            readDimensions_(file_path, FileType::Forecasts, parameters, stations, times, flts);
+
+            forecasts.setDimensions(parameters, stations, times, flts);
+            forecasts.initialize(NAN);
+
+            sizes[0] = parameters.size();
+            sizes[1] = stations.size();
+            sizes[2] = times.size();
+            sizes[3] = flts.size();
+            sizes[4] = getStationChunk_(file_path, "Forecasts");
+        } catch (exception & e) {
+            error_msg = e.what();
+        }
+    }
+
+    checkErrors_(error_msg);
+    MPI_Bcast(sizes, 5, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+
+    // Workers read their own blocks of stations
+    ForecastsPointer block;
+    size_t station_start, station_count;
+
+    if (world_rank != 0 && getChunkBlock_(sizes[1], sizes[4], num_procs, world_rank, station_start, station_count)) {
+        try {
+            AnEnReadNcdf reader(worker_verbose_);
+            reader.readForecasts(file_path, block, station_start, station_count);
+        } catch (exception & e) {
+            error_msg = e.what();
+        }
+    }
+
+    checkErrors_(error_msg);
+
+    double * values = (world_rank == 0 ? forecasts.getValuesPtr() : nullptr);
+    gatherValues_(values, {sizes[0], sizes[1], sizes[2], sizes[3]}, block.getValuesPtr(), sizes[4]);
+
+    return;
+}
+
+void
+AnEnReadNcdfMPI::gatherObservations(const string & file_path, Observations & observations) const {
+
+    int world_rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    // A single process reads everything by itself
+    if (num_procs == 1) {
+        AnEnReadNcdf::readObservations(file_path, observations);
+        return;
+    }
+
+    // The master reads dimensions and the chunk length of stations
+    string error_msg;
+    unsigned long sizes[4];
+
+    if (world_rank == 0) {
+        if (verbose_ >= Verbose::Progress) cout << "Reading observation file in parallel (" << file_path << ") ..." << endl;
+
+        try {
+            Parameters parameters;
+            Stations stations;
+            Times times, flts;
+
+            readDimensions_(file_path, FileType::Observations, parameters, stations, times, flts);
+
+            observations.setDimensions(parameters, stations, times);
+            observations.initialize(NAN);
+
+            sizes[0] = parameters.size();
+            sizes[1] = stations.size();
+            sizes[2] = times.size();
+            sizes[3] = getStationChunk_(file_path, "Observations");
+        } catch (exception & e) {
+            error_msg = e.what();
+        }
+    }
+
+    checkErrors_(error_msg);
+    MPI_Bcast(sizes, 4, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+
+    // Workers read their own blocks of stations
+    ObservationsPointer block;
+    size_t station_start, station_count;
+
+    if (world_rank != 0 && getChunkBlock_(sizes[1], sizes[3], num_procs, world_rank, station_start, station_count)) {
+        try {
+            AnEnReadNcdf reader(worker_verbose_);
+            reader.readObservations(file_path, block, station_start, station_count);
+        } catch (exception & e) {
+            error_msg = e.what();
+        }
+    }
+
+    checkErrors_(error_msg);
+
+    double * values = (world_rank == 0 ? observations.getValuesPtr() : nullptr);
+    gatherValues_(values, {sizes[0], sizes[1], sizes[2]}, block.getValuesPtr(), sizes[3]);
+
+    return;
+}
+
+void
+AnEnReadNcdfMPI::readDimensions_(const string & file_path, FileType file_type,
+        Parameters & parameters, Stations & stations, Times & times, Times & flts) const {
+
+    Ncdf::checkExists(file_path);
+    Ncdf::checkExtension(file_path);
+
+    NcFile nc(file_path, NcFile::FileMode::read);
+    checkFileType_(nc, file_type);
+
+    read(nc, parameters);
+    read(nc, stations);
+    read(nc, times, Config::_TIMES);
+    if (file_type == FileType::Forecasts) read(nc, flts, Config::_FLTS);
+
+    return;
+}
+
+bool
+AnEnReadNcdfMPI::getChunkBlock_(size_t num_stations, size_t station_chunk, int num_procs,
+        int rank, size_t & station_start, size_t & station_count) const {
+
+    size_t num_chunks = (num_stations + station_chunk - 1) / station_chunk;
+
+    // Processes beyond the number of chunks plus 1 are idle
+    if (num_procs > (int) num_chunks + 1) num_procs = num_chunks + 1;
+    if (rank == 0 || rank >= num_procs) return false;
+
+    size_t chunk_start = Functions::getStartIndex(num_chunks, num_procs, rank);
+    size_t chunk_count = Functions::getSubTotal(num_chunks, num_procs, rank);
+
+    station_start = chunk_start * station_chunk;
+    station_count = min(num_stations, (chunk_start + chunk_count) * station_chunk) - station_start;
+
+    return (station_count > 0);
+}
+
+void
+AnEnReadNcdfMPI::gatherValues_(double * values, const vector<size_t> & shape,
+        const double * block_values, size_t station_chunk) const {
+
+    int world_rank, num_procs;
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+
+    size_t station_start, station_count;
+    int err;
+
+    if (world_rank == 0) {
+
+        vector<MPI_Request> requests;
+        vector<MPI_Datatype> types;
+
+        for (int rank = 1; rank < num_procs; ++rank) {
+            if (!getChunkBlock_(shape[1], station_chunk, num_procs, rank, station_start, station_count)) continue;
+
+            if (verbose_ >= Verbose::Debug) cout << "Master receiving " << station_count
+                << " stations from #" << station_start << " from worker #" << rank << " ..." << endl;
+
+            types.push_back(createStationBlockType_(shape, station_count));
+
+            requests.push_back(MPI_REQUEST_NULL);
+            MPI_Irecv(values + station_start * shape[0], 1, types.back(), rank, 0, MPI_COMM_WORLD, &requests.back());
+        }
+
+        err = MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+        for (auto & type : types) MPI_Type_free(&type);
+
+    } else if (getChunkBlock_(shape[1], station_chunk, num_procs, world_rank, station_start, station_count)) {
+
+        // The block is the only stations of its own array
+        vector<size_t> block_shape = shape;
+        block_shape[1] = station_count;
+
+        MPI_Datatype type = createStationBlockType_(block_shape, station_count);
+        err = MPI_Send(block_values, 1, type, 0, 0, MPI_COMM_WORLD);
+        MPI_Type_free(&type);
+
+    } else {
+        err = MPI_SUCCESS;
+    }
+
+    if (err != MPI_SUCCESS) {
+        char err_buffer[MPI_MAX_ERROR_STRING];
+        int err_len;
+        MPI_Error_string(err, err_buffer, &err_len);
+        throw runtime_error(string("Failed to gather values read by workers. MPI error: ") + string(err_buffer));
+    }
+
+    return;
+}
+
+size_t
+AnEnReadNcdfMPI::getStationChunk_(const string & file_path, const string & group_name) {
+
+    // The data variable might be in the root group or in a sub group
+    NcFile nc(file_path, NcFile::FileMode::read);
+    NcVar var = nc.getVar(Config::_DATA);
+    if (var.isNull() && !nc.getGroup(group_name).isNull()) var = nc.getGroup(group_name).getVar(Config::_DATA);
+
+    if (var.isNull()) {
+        ostringstream msg;
+        msg << group_name << " can not be found";
+        throw runtime_error(msg.str());
+    }
+
+    NcVar::ChunkMode chunk_mode;
+    vector<size_t> chunk_sizes;
+    var.getChunkingParameters(chunk_mode, chunk_sizes);
+    if (chunk_mode != NcVar::nc_CHUNKED) return 1;
+
+    auto dims = var.getDims();
+    for (size_t dim_i = 0; dim_i < dims.size() && dim_i < chunk_sizes.size(); ++dim_i) {
+        if (dims[dim_i].getName() == Config::_DIM_STATIONS && chunk_sizes[dim_i] > 0) return chunk_sizes[dim_i];
+    }
+
+    return 1;
+}
+
+void
+AnEnReadNcdfMPI::checkErrors_(const string & error_msg) {
+
+    int failed = !error_msg.empty(), any_failed, world_rank;
+    MPI_Allreduce(&failed, &any_failed, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    if (failed) throw runtime_error(error_msg);
+    if (any_failed) throw runtime_error("Process #" + to_string(world_rank) + " stopped because another process has failed to read");
+
+    return;
+}
@@ -0,0 +1,122 @@
+/*
+ * File:   AnEnReadNcdfMPI.h
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+
+#ifndef AnEnREADNCDFMPI_H
+#define AnEnREADNCDFMPI_H
+
+#include <mpi.h>
+#include "AnEnReadNcdf.h"
+
+/**
+ * \class AnEnReadNcdfMPI
+ *
+ * \brief AnEnReadNcdfMPI reads NetCDF files in parallel with MPI so that
+ * forecasts and observations are never held by a single process.
+ *
+ * The master process only reads dimensions, i.e. parameters, stations, times,
+ * and lead times, without any data values. It broadcasts the number of
+ * stations. Each worker then reads the hyperslab of its own stations. Stations
+ * are partitioned in the same way as AnEnISMPI scatters them, so the results
+ * can be passed to AnEnISMPI and AnEnSSEMPI directly.
+ *
+ * Idle processes, created when there are more processes than stations, do
+ * not read anything.
+ *
+ * When the master needs all values, e.g. to transform forecasts, the gather
+ * functions read in parallel by processes instead of threads, because the
+ * NetCDF library is not thread-safe. Workers read blocks of stations aligned
+ * to the chunks of the data variable, so that each chunk is decompressed by
+ * one process, and the master receives the blocks directly into its values.
+ */
+class AnEnReadNcdfMPI : public AnEnReadNcdf {
+
+public:
+    AnEnReadNcdfMPI();
+    AnEnReadNcdfMPI(const AnEnReadNcdfMPI& orig);
+    AnEnReadNcdfMPI(Verbose master_verbose);
+    AnEnReadNcdfMPI(Verbose master_verbose, Verbose worker_verbose);
+    virtual ~AnEnReadNcdfMPI();
+
+    /**
+     * Reads forecasts in parallel. All processes should call this function.
+     * @param file_path The NetCDF file
+     * @param forecasts Dimensions only on the master, or own stations on workers
+     */
+    void readForecasts(const std::string & file_path, Forecasts & forecasts) const;
+
+    /**
+     * Reads observations in parallel. All processes should call this function.
+     * @param file_path The NetCDF file
+     * @param observations Dimensions only on the master, or own stations on workers
+     */
+    void readObservations(const std::string & file_path, Observations & observations) const;
+
+    /**
+     * Reads all forecasts to the master in parallel. All processes should
+     * call this function.
+     * @param file_path The NetCDF file
+     * @param forecasts All forecasts on the master, or nothing on workers
+     */
+    void gatherForecasts(const std::string & file_path, Forecasts & forecasts) const;
+
+    /**
+     * Reads all observations to the master in parallel. All processes should
+     * call this function.
+     * @param file_path The NetCDF file
+     * @param observations All observations on the master, or nothing on workers
+     */
+    void gatherObservations(const std::string & file_path, Observations & observations) const;
+
+private:
+    Verbose worker_verbose_;
+
+    /**
+     * Reads parameters, stations, times, and lead times on the master.
+     * Lead times are only read for forecasts.
+     */
+    void readDimensions_(const std::string & file_path, FileType file_type,
+            Parameters & parameters, Stations & stations, Times & times, Times & flts) const;
+
+    /**
+     * Determines the stations to read by a worker for gathering. Chunks of
+     * stations are partitioned among workers.
+     * @return Whether the worker reads any stations
+     */
+    bool getChunkBlock_(std::size_t num_stations, std::size_t station_chunk, int num_procs,
+            int rank, std::size_t & station_start, std::size_t & station_count) const;
+
+    /**
+     * Sends blocks of workers to the master. Values are column-major arrays
+     * with parameters as the first and stations as the second dimension.
+     * @param values All values on the master
+     * @param shape The shape of all values
+     * @param block_values Values of the block read by this worker
+     */
+    void gatherValues_(double * values, const std::vector<std::size_t> & shape,
+            const double * block_values, std::size_t station_chunk) const;
+
+    /**
+     * Gets the chunk length of stations of the data variable. Variables that
+     * are not chunked are split by stations.
+     */
+    static std::size_t getStationChunk_(const std::string & file_path, const std::string & group_name);
+
+    /**
+     * Throws on all processes if any process has failed. Otherwise, other
+     * processes would wait for the failed process forever.
+     */
+    static void checkErrors_(const std::string & error_msg);
+
+    /**
+     * Broadcasts the number of stations from the master and determines the
+     * stations to read by this process.
+     * @return Whether this process reads any stations
+     */
+    bool getStationBlock_(const std::string & file_path, int world_rank,
+            int & station_start, int & station_count) const;
+};
+
+#endif /* AnEnREADNCDFMPI_H */
@@ -11,20 +11,37 @@
 #include "ForecastsPointer.h"
 #include "ObservationsPointer.h"
 
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+
 #if defined(_OPENMP)
 #include <omp.h>
 #endif
 
 using namespace std;
 
+static const int MPI_TAG_REQUEST = 6;
+static const int MPI_TAG_CHUNK = 7;
+static const int MPI_TAG_CHUNK_FCST = 8;
+static const int MPI_TAG_CHUNK_OBS = 9;
+static const int MPI_TAG_RESULT = 10;
+
 
-AnEnISMPI::AnEnISMPI() : AnEnIS() {
+AnEnISMPI::AnEnISMPI() : AnEnIS(), world_rank_(0), num_procs_(0), master_share_(true),
+gather_results_(true), station_start_(0), station_count_(0) {
+    Config config;
+    dynamic_chunks_ = config.dynamic_chunks;
 }
 
-AnEnISMPI::AnEnISMPI(const AnEnISMPI & orig) : AnEnIS(orig) {
+AnEnISMPI::AnEnISMPI(const AnEnISMPI & orig) : AnEnIS(orig),
+world_rank_(orig.world_rank_), num_procs_(orig.num_procs_), master_share_(orig.master_share_),
+dynamic_chunks_(orig.dynamic_chunks_), gather_results_(orig.gather_results_),
+station_start_(orig.station_start_), station_count_(orig.station_count_) {
 }
 
-AnEnISMPI::AnEnISMPI(const Config & config) : AnEnIS(config) {
+AnEnISMPI::AnEnISMPI(const Config & config) : AnEnIS(config), world_rank_(0), num_procs_(0), master_share_(true),
+dynamic_chunks_(config.dynamic_chunks), gather_results_(true), station_start_(0), station_count_(0) {
 }
 
 AnEnISMPI::~AnEnISMPI() {
@@ -34,59 +51,110 @@ void
 AnEnISMPI::compute(const Forecasts & forecasts, const Observations & observations,
             vector<size_t> & fcsts_test_index, vector<size_t> & fcsts_search_index) {
 
-    // Get the process ID and the number of worker processes
-    int world_rank, num_procs, num_workers;
-    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
-    FunctionsMPI::effective_num_procs(MPI_COMM_WORLD, &num_procs, world_rank, forecasts, verbose_);
+    // Get the process ID
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank_);
+
+    /*
+     * Forecasts and observations are scattered from the master, unless the
+     * master only has dimensions without values, e.g. read by AnEnReadNcdfMPI.
+     * In that case, each worker has already read its own stations.
+     *
+     * The master also computes a share of stations when it holds values,
+     * unless stations are dispatched dynamically. Dynamic load balancing
+     * needs at least 2 workers and the master holding all values.
+     */
+    int modes[2];
+
+    if (world_rank_ == 0) {
+        int world_size;
+        MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+        modes[0] = (forecasts.num_elements() != 0);
+        modes[1] = (modes[0] && dynamic_chunks_ > 0 && world_size > 2 && gather_results_);
+    }
+
+    MPI_Bcast(modes, 2, MPI_INT, 0, MPI_COMM_WORLD);
+
+    int scatter = modes[0];
+    bool dynamic = modes[1];
 
-    // The number of workers is the number of processes minus 1 because process #0 is the master
-    num_workers = num_procs - 1;
+    master_share_ = (scatter && !dynamic);
 
-    if (num_procs == 1) {
-        cerr << "Error: This is an MPI program. You need to launch this program with an MPI launcher, e.g. mpirun or mpiexec." << endl;
-        MPI_Finalize();
-        exit(1);
+    // Get the number of processes that are effectively working
+    FunctionsMPI::effective_num_procs(MPI_COMM_WORLD, &num_procs_, world_rank_, forecasts, verbose_, master_share_);
+
+    if (num_procs_ == 1) {
+        if (!master_share_) throw runtime_error("At least 2 processes are needed when the master only has dimensions of forecasts");
+
+        // The only process computes all stations
+        if (verbose_ >= Verbose::Progress) cout << "Start AnEnIS generation with a single MPI process ..." << endl;
+        AnEnIS::compute(forecasts, observations, fcsts_test_index, fcsts_search_index);
+
+        station_start_ = 0;
+        station_count_ = forecasts.getStations().size();
+        return;
     }
 
-    if (num_workers == 1) {
-        cerr << "Error: To take advantage of MPI, at least 3 processes (1 master + 2 workers) should be created. "
-            << "It is, however, better to have more worker processes." << endl;
-        MPI_Finalize();
-        exit(1);
+    if (dynamic) {
+        computeDynamic_(forecasts, observations, fcsts_test_index, fcsts_search_index);
+        return;
     }
 
-    if (world_rank == 0 && verbose_ >= Verbose::Progress) cout << "Start AnEnIS generation with MPI ..." << endl;
+    if (world_rank_ == 0 && verbose_ >= Verbose::Progress) cout << "Start AnEnIS generation with MPI ..." << endl;
 
-    // Scatter forecasts by stations
-    if (world_rank == 0 && verbose_ >= Verbose::Detail) cout << "Master process is scattering forecasts to workers ..." << endl;
     ForecastsPointer proc_forecasts;
-    FunctionsMPI::scatterForecasts(forecasts, proc_forecasts, num_procs, world_rank, verbose_);
-    if (world_rank == 0 && verbose_ >= Verbose::Detail) {
-        cout << "Forecasts have been scattered to workers." << endl;
-        profiler_.log_time_session("Master scattering forecasts (AnEnISMPI)");
-    }
-
-    // Scatter observations by stations
-    if (world_rank == 0 && verbose_ >= Verbose::Detail) cout << "Master process is scattering observations to workers ..." << endl;
     ObservationsPointer proc_observations;
-    FunctionsMPI::scatterObservations(observations, proc_observations, num_procs, world_rank, verbose_);
-    if (world_rank == 0 && verbose_ >= Verbose::Detail) {
-        cout << "Observations have been scattered to workers." << endl;
-        profiler_.log_time_session("Master scattering observations (AnEnISMPI)");
+
+    if (scatter) {
+
+        // Scatter forecasts by stations
+        if (world_rank_ == 0 && verbose_ >= Verbose::Detail) cout << "Master process is scattering forecasts to workers ..." << endl;
+        FunctionsMPI::scatterForecasts(forecasts, proc_forecasts, num_procs_, world_rank_, verbose_, master_share_);
+        if (world_rank_ == 0 && verbose_ >= Verbose::Detail) {
+            cout << "Forecasts have been scattered to workers." << endl;
+            profiler_.log_time_session("Master scattering forecasts (AnEnISMPI)");
+        }
+
+        // Scatter observations by stations
+        if (world_rank_ == 0 && verbose_ >= Verbose::Detail) cout << "Master process is scattering observations to workers ..." << endl;
+        FunctionsMPI::scatterObservations(observations, proc_observations, num_procs_, world_rank_, verbose_, master_share_);
+        if (world_rank_ == 0 && verbose_ >= Verbose::Detail) {
+            cout << "Observations have been scattered to workers." << endl;
+            profiler_.log_time_session("Master scattering observations (AnEnISMPI)");
+        }
+
+    } else {
+        if (world_rank_ == 0 && verbose_ >= Verbose::Detail) cout << "Workers use forecasts and observations read by themselves." << endl;
+        FunctionsMPI::checkWorkerStations(forecasts, observations, num_procs_, world_rank_, verbose_);
     }
 
+    const Forecasts & local_forecasts = (scatter ? static_cast<const Forecasts &> (proc_forecasts) : forecasts);
+    const Observations & local_observations = (scatter ? static_cast<const Observations &> (proc_observations) : observations);
+
     // Broadcast test and search
     vector<size_t> proc_test_index, proc_search_index;
-    FunctionsMPI::broadcastVector(fcsts_test_index, proc_test_index, world_rank, verbose_);
-    FunctionsMPI::broadcastVector(fcsts_search_index, proc_search_index, world_rank, verbose_);
-    if (world_rank == 0) profiler_.log_time_session("Master broadcasting configuration (AnEnISMPI)");
+    FunctionsMPI::broadcastVector(fcsts_test_index, proc_test_index, world_rank_, verbose_);
+    FunctionsMPI::broadcastVector(fcsts_search_index, proc_search_index, world_rank_, verbose_);
+    if (world_rank_ == 0) profiler_.log_time_session("Master broadcasting configuration (AnEnISMPI)");
 
-    if (world_rank == 0) {
-        // This is a master
+    bool is_owner = (world_rank_ < num_procs_ && (world_rank_ != 0 || master_share_));
+    double busy = 0, start_time = MPI_Wtime();
+
+    if (world_rank_ == 0 && !master_share_) {
+        // This is a master that does not compute
 
         // Preprocess to allocate memory
         preprocess_(forecasts, observations, fcsts_test_index, fcsts_search_index);
 
+        // Without gathering, only the shapes of results are kept
+        if (!gather_results_) {
+            for (auto & result : resultArrays_()) {
+                vector<size_t> dims(result.first->shape(), result.first->shape() + 4);
+                dims[result.second] = 0;
+                result.first->resize(dims[0], dims[1], dims[2], dims[3]);
+            }
+        }
+
         /*
          * Progress messages output
          */
@@ -98,89 +166,467 @@ AnEnISMPI::compute(const Forecasts & forecasts, const Observations & observation
 
         profiler_.log_time_session("Master preprocessing (AnEnISMPI)");
 
-    } else if (world_rank < num_procs) {
-        // This is a worker
+    } else if (is_owner) {
 
-#if defined(_OPENMP)
         /*
-         * Note that each worker should only use one thread. I'm explicitly setting the number of threads
-         * to spwan by each worker process to 1. Because the maximum number processes should have been
-         * created and it leaves no additional computation gain when multi-threading is used
+         * Each process uses as many OpenMP threads as configured, e.g. with
+         * OMP_NUM_THREADS, so that one process can be launched per node or
+         * per socket. Thread placement is controlled by the OpenMP runtime,
+         * e.g. OMP_PROC_BIND and OMP_PLACES, together with the binding
+         * options of the MPI launcher.
          */
-        int max_threads = omp_get_max_threads();
-        int max_dynamic = omp_get_dynamic();
+        if (verbose_ >= Verbose::Detail) {
+            cout << "Rank #" << world_rank_ << " computes " << local_forecasts.getStations().size() << " stations"
+#if defined(_OPENMP)
+                << " with " << omp_get_max_threads() << " threads"
+#endif
+                << endl;
+        }
 
-        // Explicitly disable dynamic teams
-        omp_set_dynamic(0);
+        // The master holds the original test and search indices
+        vector<size_t> & test_index = (world_rank_ == 0 ? fcsts_test_index : proc_test_index);
+        vector<size_t> & search_index = (world_rank_ == 0 ? fcsts_search_index : proc_search_index);
 
-        // Use 4 threads for all consecutive parallel regions
-        omp_set_num_threads(1);
-#endif
-        // Compute analogs
-        //
-        // Now the computation is serial because it is assumed that there are as many processes as possible.
-        //
-        AnEnIS::compute(proc_forecasts, proc_observations, proc_test_index, proc_search_index);
+        AnEnIS::compute(local_forecasts, local_observations, test_index, search_index);
+        busy = MPI_Wtime() - start_time;
 
-#if defined(_OPENMP)
-        // We need to revert to the old setting for multi-threading so it does not affect the rest of the program execution
-        omp_set_dynamic(max_dynamic);
-        omp_set_num_threads(max_threads);
-#endif
     } else {
-        if (verbose_ >= Verbose::Debug) cout << "Worker #" << world_rank << " is doing nothing because too many process have been created!" << endl;
+        if (verbose_ >= Verbose::Debug) cout << "Worker #" << world_rank_ << " is doing nothing because too many process have been created!" << endl;
     }
 
     MPI_Barrier(MPI_COMM_WORLD);
     profiler_.log_time_session("Master waiting for analog computation (AnEnISMPI)");
+    logRankTimes_(busy, MPI_Wtime() - start_time - busy);
+
+    if (!gather_results_) {
+
+        // Stations are owned in the order of ranks
+        unsigned long station_count = (is_owner ? local_forecasts.getStations().size() : 0), station_start = 0;
+        MPI_Exscan(&station_count, &station_start, 1, MPI_UNSIGNED_LONG, MPI_SUM, MPI_COMM_WORLD);
+        if (world_rank_ == 0) station_start = 0;
+
+        station_start_ = station_start;
+        station_count_ = station_count;
+
+        if (verbose_ >= Verbose::Detail && is_owner) cout << "Rank #" << world_rank_ << " keeps results of "
+                << station_count_ << " stations from #" << station_start_ << endl;
+
+        return;
+    }
 
     // Collect members in AnEnIS
-    if (world_rank == 0 && verbose_ >= Verbose::Detail) {
+    if (world_rank_ == 0 && verbose_ >= Verbose::Detail) {
         cout << "Master process is receiving analog results from workers ..." << endl;
     }
-    gather_(num_procs, world_rank);
-    if (world_rank == 0 && verbose_ >= Verbose::Detail) {
+
+    size_t num_total_stations = 0;
+    if (world_rank_ == 0) num_total_stations = forecasts.getStations().size();
+
+    gather_(num_total_stations);
+    if (world_rank_ == 0 && verbose_ >= Verbose::Detail) {
         cout << "Analog results have been collected at master." << endl;
         profiler_.log_time_session("Master receiving analogs (AnEnISMPI)");
     }
 
+    station_start_ = 0;
+    station_count_ = num_total_stations;
+    return;
+}
+
+void
+AnEnISMPI::computeDynamic_(const Forecasts & forecasts, const Observations & observations,
+        vector<size_t> & fcsts_test_index, vector<size_t> & fcsts_search_index) {
+
+    if (world_rank_ == 0 && verbose_ >= Verbose::Progress) cout << "Start AnEnIS generation with MPI and dynamic load balancing ..." << endl;
+
+    /*
+     * Workers only need the circular information of parameters and times to
+     * create their chunks. Stations are created for each chunk.
+     */
+    vector<bool> master_fcst_circulars, fcst_circulars, master_obs_circulars, obs_circulars;
+    vector<size_t> master_fcst_times, fcst_times, master_flts, flts, master_obs_times, obs_times;
+
+    if (world_rank_ == 0) {
+        forecasts.getParameters().getCirculars(master_fcst_circulars);
+        forecasts.getTimes().getTimestamps(master_fcst_times);
+        forecasts.getFLTs().getTimestamps(master_flts);
+        observations.getParameters().getCirculars(master_obs_circulars);
+        observations.getTimes().getTimestamps(master_obs_times);
+    }
+
+    FunctionsMPI::broadcastVector(master_fcst_circulars, fcst_circulars, world_rank_, verbose_);
+    FunctionsMPI::broadcastVector(master_fcst_times, fcst_times, world_rank_, verbose_);
+    FunctionsMPI::broadcastVector(master_flts, flts, world_rank_, verbose_);
+    FunctionsMPI::broadcastVector(master_obs_circulars, obs_circulars, world_rank_, verbose_);
+    FunctionsMPI::broadcastVector(master_obs_times, obs_times, world_rank_, verbose_);
+
+    // Broadcast test and search
+    vector<size_t> proc_test_index, proc_search_index;
+    FunctionsMPI::broadcastVector(fcsts_test_index, proc_test_index, world_rank_, verbose_);
+    FunctionsMPI::broadcastVector(fcsts_search_index, proc_search_index, world_rank_, verbose_);
+    if (world_rank_ == 0) profiler_.log_time_session("Master broadcasting configuration (AnEnISMPI)");
+
+    double busy = 0, start_time = MPI_Wtime();
+
+    if (world_rank_ == 0) {
+
+        // The master allocates memory for results of all stations
+        preprocess_(forecasts, observations, fcsts_test_index, fcsts_search_index);
+
+        if (verbose_ >= Verbose::Detail) {
+            cout << "********** AnEn Configuration Summary (Master) **********" << endl;
+            print(cout);
+            cout << "*********** End of AnEn Configuration Summary **********" << endl;
+        }
+
+        vector< pair<size_t, size_t> > chunks;
+        splitChunks_(forecasts, observations, chunks);
+        profiler_.log_time_session("Master preprocessing (AnEnISMPI)");
+
+        // Values of a view are not contiguous, so they are copied once
+        const Array4D * fcst_values = &forecasts;
+        Array4DPointer fcst_copy;
+
+        if (dynamic_cast<const Array4DPointer *>(&forecasts) == nullptr) {
+            vector<size_t> all_dim0(forecasts.shape()[0]), all_dim1(forecasts.shape()[1]);
+            vector<size_t> all_dim2(forecasts.shape()[2]), all_dim3(forecasts.shape()[3]);
+
+            iota(all_dim0.begin(), all_dim0.end(), 0);
+            iota(all_dim1.begin(), all_dim1.end(), 0);
+            iota(all_dim2.begin(), all_dim2.end(), 0);
+            iota(all_dim3.begin(), all_dim3.end(), 0);
+
+            fcst_values->subset(all_dim0, all_dim1, all_dim2, all_dim3, fcst_copy);
+            fcst_values = &fcst_copy;
+        }
+
+        vector<size_t> fcst_shape(fcst_values->shape(), fcst_values->shape() + 4);
+        vector<size_t> obs_shape = {observations.getParameters().size(),
+            observations.getStations().size(), observations.getTimes().size()};
+
+        auto results = resultArrays_();
+        vector<size_t> worker_chunks(num_procs_);
+        size_t next_chunk = 0;
+        int num_active = num_procs_ - 1;
+
+        while (num_active > 0) {
+
+            // Wait for a worker to ask for a chunk
+            int has_result;
+            MPI_Status status;
+            double wait_start = MPI_Wtime();
+            MPI_Recv(&has_result, 1, MPI_INT, MPI_ANY_SOURCE, MPI_TAG_REQUEST, MPI_COMM_WORLD, &status);
+            busy -= MPI_Wtime() - wait_start;
+
+            int worker_rank = status.MPI_SOURCE;
+
+            if (has_result) {
+
+                // Place results of the previous chunk of this worker
+                const auto & chunk = chunks[worker_chunks[worker_rank]];
+
+                for (auto & result : results) {
+                    vector<size_t> shape(result.first->shape(), result.first->shape() + 4);
+                    FunctionsMPI::recvStations(result.first->getValuesPtr(), shape, result.second,
+                            chunk.first, chunk.second, worker_rank, MPI_TAG_RESULT);
+                }
+            }
+
+            unsigned long message[2] = {0, 0};
+
+            if (next_chunk < chunks.size()) {
+                message[0] = chunks[next_chunk].first;
+                message[1] = chunks[next_chunk].second;
+                worker_chunks[worker_rank] = next_chunk;
+                ++next_chunk;
+            } else {
+                --num_active;
+            }
+
+            if (verbose_ >= Verbose::Detail) {
+                if (message[1] == 0) cout << "Master stopping worker #" << worker_rank << " ..." << endl;
+                else cout << "Master sending " << message[1] << " stations from #" << message[0]
+                        << " to worker #" << worker_rank << " (" << next_chunk << "/" << chunks.size() << ") ..." << endl;
+            }
+
+            MPI_Send(message, 2, MPI_UNSIGNED_LONG, worker_rank, MPI_TAG_CHUNK, MPI_COMM_WORLD);
+
+            if (message[1] != 0) {
+                FunctionsMPI::sendStations(fcst_values->getValuesPtr(), fcst_shape, 1,
+                        message[0], message[1], worker_rank, MPI_TAG_CHUNK_FCST);
+                FunctionsMPI::sendStations(observations.getValuesPtr(), obs_shape, 1,
+                        message[0], message[1], worker_rank, MPI_TAG_CHUNK_OBS);
+            }
+        }
+
+        // The master is busy while it is not waiting for requests
+        busy += MPI_Wtime() - start_time;
+        profiler_.log_time_session("Master dispatching chunks (AnEnISMPI)");
+
+    } else if (world_rank_ < num_procs_) {
+
+        Parameters fcst_parameters, obs_parameters;
+        for (size_t i = 0; i < fcst_circulars.size(); ++i) fcst_parameters.push_back(Parameter(string("Placeholder_") + to_string(i), fcst_circulars[i]));
+        for (size_t i = 0; i < obs_circulars.size(); ++i) obs_parameters.push_back(Parameter(string("Placeholder_") + to_string(i), obs_circulars[i]));
+
+        Times fcst_times_obj, flts_obj, obs_times_obj;
+        for (const auto & e : fcst_times) fcst_times_obj.push_back(e);
+        for (const auto & e : flts) flts_obj.push_back(e);
+        for (const auto & e : obs_times) obs_times_obj.push_back(e);
+
+        int has_result = 0;
+        size_t num_chunks = 0;
+
+        if (verbose_ >= Verbose::Detail) {
+            cout << "Worker #" << world_rank_ << " requests chunks"
+#if defined(_OPENMP)
+                << " and computes with " << omp_get_max_threads() << " threads"
+#endif
+                << endl;
+        }
+
+        while (true) {
+
+            // Ask for a chunk and send results of the previous one
+            MPI_Send(&has_result, 1, MPI_INT, 0, MPI_TAG_REQUEST, MPI_COMM_WORLD);
+
+            if (has_result) {
+                for (auto & result : resultArrays_()) {
+                    vector<size_t> shape(result.first->shape(), result.first->shape() + 4);
+                    FunctionsMPI::sendStations(result.first->getValuesPtr(), shape, result.second,
+                            0, shape[result.second], 0, MPI_TAG_RESULT);
+                }
+            }
+
+            unsigned long message[2];
+            MPI_Recv(message, 2, MPI_UNSIGNED_LONG, 0, MPI_TAG_CHUNK, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            if (message[1] == 0) break;
+
+            Stations stations;
+            for (size_t i = 0; i < message[1]; ++i) stations.push_back(Station(i, i));
+
+            ForecastsPointer chunk_forecasts;
+            ObservationsPointer chunk_observations;
+            chunk_forecasts.setDimensions(fcst_parameters, stations, fcst_times_obj, flts_obj);
+            chunk_observations.setDimensions(obs_parameters, stations, obs_times_obj);
+
+            vector<size_t> fcst_shape(chunk_forecasts.shape(), chunk_forecasts.shape() + 4);
+            vector<size_t> obs_shape = {obs_parameters.size(), stations.size(), obs_times_obj.size()};
+
+            FunctionsMPI::recvStations(chunk_forecasts.getValuesPtr(), fcst_shape, 1, 0, message[1], 0, MPI_TAG_CHUNK_FCST);
+            FunctionsMPI::recvStations(chunk_observations.getValuesPtr(), obs_shape, 1, 0, message[1], 0, MPI_TAG_CHUNK_OBS);
+
+            // Indices are changed in operational mode, so each chunk uses a copy
+            vector<size_t> test_index = proc_test_index, search_index = proc_search_index;
+
+            double compute_start = MPI_Wtime();
+            AnEnIS::compute(chunk_forecasts, chunk_observations, test_index, search_index);
+            busy += MPI_Wtime() - compute_start;
+
+            has_result = 1;
+            ++num_chunks;
+        }
+
+        if (verbose_ >= Verbose::Detail) cout << "Worker #" << world_rank_ << " computed " << num_chunks << " chunks" << endl;
+
+    } else {
+        if (verbose_ >= Verbose::Debug) cout << "Worker #" << world_rank_ << " is doing nothing because too many process have been created!" << endl;
+    }
+
+    logRankTimes_(busy, MPI_Wtime() - start_time - busy);
+
+    // All results are held by the master
+    station_start_ = 0;
+    station_count_ = (world_rank_ == 0 ? forecasts.getStations().size() : 0);
     return;
 }
 
 void
-AnEnISMPI::gather_(int num_procs, int rank) {
+AnEnISMPI::splitChunks_(const Forecasts & forecasts, const Observations & observations,
+        vector< pair<size_t, size_t> > & chunks) const {
+
+    size_t num_stations = forecasts.getStations().size();
+    size_t num_parameters = forecasts.getParameters().size();
+    size_t num_times = forecasts.getTimes().size();
+    size_t num_flts = forecasts.getFLTs().size();
+    size_t num_obs_times = observations.getTimes().size();
+
+    /*
+     * Only search entries with a valid observation are compared, and each
+     * comparison is cheaper with missing forecasts. The cost of a station is
+     * estimated as the number of valid observations scaled by the fraction
+     * of valid forecasts. One is added so that stations with all values
+     * missing still count.
+     */
+    vector<double> costs(num_stations);
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+    for (size_t station_i = 0; station_i < num_stations; ++station_i) {
+
+        size_t num_obs_valid = 0, num_fcst_valid = 0;
+
+        for (size_t time_i = 0; time_i < num_obs_times; ++time_i) {
+            if (!std::isnan(observations.getValue(obs_var_index_, station_i, time_i))) ++num_obs_valid;
+        }
+
+        for (size_t flt_i = 0; flt_i < num_flts; ++flt_i) {
+            for (size_t time_i = 0; time_i < num_times; ++time_i) {
+                for (size_t parameter_i = 0; parameter_i < num_parameters; ++parameter_i) {
+                    if (!std::isnan(forecasts.getValue(parameter_i, station_i, time_i, flt_i))) ++num_fcst_valid;
+                }
+            }
+        }
+
+        size_t num_fcst_total = num_parameters * num_times * num_flts;
+        costs[station_i] = 1 + num_obs_valid * (num_fcst_total == 0 ? 0 : num_fcst_valid / (double) num_fcst_total);
+    }
+
+    // Contiguous stations are accumulated until a chunk reaches the target cost
+    size_t num_chunks = min(num_stations, (num_procs_ - 1) * dynamic_chunks_);
+    double target = accumulate(costs.begin(), costs.end(), 0.0) / num_chunks;
+
+    vector<double> chunk_costs;
+    size_t chunk_start = 0;
+    double chunk_cost = 0;
+
+    chunks.clear();
+
+    for (size_t station_i = 0; station_i < num_stations; ++station_i) {
+        chunk_cost += costs[station_i];
+
+        if (chunk_cost >= target || station_i == num_stations - 1) {
+            chunks.push_back(make_pair(chunk_start, station_i + 1 - chunk_start));
+            chunk_costs.push_back(chunk_cost);
+            chunk_start = station_i + 1;
+            chunk_cost = 0;
+        }
+    }
+
+    // Expensive chunks are dispatched first so that cheap chunks fill the gaps at the end
+    vector<size_t> order(chunks.size());
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&chunk_costs](size_t lhs, size_t rhs) {
+        return chunk_costs[lhs] > chunk_costs[rhs];
+    });
+
+    vector< pair<size_t, size_t> > sorted_chunks(chunks.size());
+    for (size_t i = 0; i < order.size(); ++i) sorted_chunks[i] = chunks[order[i]];
+    chunks.swap(sorted_chunks);
+
+    if (verbose_ >= Verbose::Detail) cout << "Stations are split into " << chunks.size()
+            << " chunks with an estimated cost of " << target << " each" << endl;
+
+    return;
+}
+
+vector< pair<Array4DPointer *, size_t> >
+AnEnISMPI::resultArrays_() {
+
+    // The station dimension is the second dimension for standard deviation and the first for others
+    vector< pair<Array4DPointer *, size_t> > arrays = {make_pair(&sds_, 1)};
+
+    if (save_analogs_) arrays.push_back(make_pair(&analogs_value_, 0));
+    if (save_analogs_time_index_) arrays.push_back(make_pair(&analogs_time_index_, 0));
+    if (save_sims_) arrays.push_back(make_pair(&sims_metric_, 0));
+    if (save_sims_time_index_) arrays.push_back(make_pair(&sims_time_index_, 0));
+
+    return arrays;
+}
+
+void
+AnEnISMPI::logRankTimes_(double busy, double idle) {
+
+    int world_size;
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+    double times[2] = {busy, idle};
+    vector<double> all_times(world_rank_ == 0 ? 2 * world_size : 0);
+    MPI_Gather(times, 2, MPI_DOUBLE, all_times.data(), 2, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    if (world_rank_ == 0) {
+
+        // Idle processes created beyond the number of stations are not reported
+        vector<double> rank_busy(num_procs_), rank_idle(num_procs_);
+
+        for (int rank_i = 0; rank_i < num_procs_; ++rank_i) {
+            rank_busy[rank_i] = all_times[2 * rank_i];
+            rank_idle[rank_i] = all_times[2 * rank_i + 1];
+        }
+
+        profiler_.log_rank_times(rank_busy, rank_idle);
+    }
+
+    return;
+}
+
+void
+AnEnISMPI::setGatherResults(bool gather_results) {
+    gather_results_ = gather_results;
+    return;
+}
+
+size_t
+AnEnISMPI::getStationStart() const {
+    return station_start_;
+}
+
+size_t
+AnEnISMPI::getStationCount() const {
+    return station_count_;
+}
+
+void
+AnEnISMPI::gather_(size_t num_total_stations) {
 
     // The number 1 is because the station dimension is the second dimension
-    FunctionsMPI::gatherArray(sds_, 1, num_procs, rank, verbose_);
+    gatherArray_(sds_, 1, num_total_stations);
 
     // The number 0 is because the station dimension is the first dimension
-    if (save_analogs_) FunctionsMPI::gatherArray(analogs_value_, 0, num_procs, rank, verbose_);
-    if (save_analogs_time_index_) FunctionsMPI::gatherArray(analogs_time_index_, 0, num_procs, rank, verbose_);
-    if (save_sims_) FunctionsMPI::gatherArray(sims_metric_, 0, num_procs, rank, verbose_);
-    if (save_sims_time_index_) FunctionsMPI::gatherArray(sims_time_index_, 0, num_procs, rank, verbose_);
+    if (save_analogs_) gatherArray_(analogs_value_, 0, num_total_stations);
+    if (save_analogs_time_index_) gatherArray_(analogs_time_index_, 0, num_total_stations);
+    if (save_sims_) gatherArray_(sims_metric_, 0, num_total_stations);
+    if (save_sims_time_index_) gatherArray_(sims_time_index_, 0, num_total_stations);
 
     return;
 }
 
 void
-AnEnISMPI::computeSds_(const Forecasts & forecasts, const vector<size_t> & times_fixed_index, const vector<size_t> & times_accum_index) {
+AnEnISMPI::gatherArray_(Array4DPointer & arr, int station_dim_index, size_t num_total_stations) {
+
+    if (world_rank_ == 0 && master_share_) {
+
+        // Results of the master's own stations are expanded to all stations
+        Array4DPointer master_block = std::move(arr);
 
-    // Get the process ID and the number of worker processes
-    int world_rank, num_procs;
-    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
-    FunctionsMPI::effective_num_procs(MPI_COMM_WORLD, &num_procs, world_rank, forecasts, verbose_);
+        vector<size_t> dims(master_block.shape(), master_block.shape() + 4);
+        dims[station_dim_index] = num_total_stations;
+        arr.resize(dims[0], dims[1], dims[2], dims[3]);
 
-    if (world_rank == 0) {
+        FunctionsMPI::gatherArray(arr, station_dim_index, num_procs_, world_rank_, verbose_, &master_block);
+
+    } else {
+        FunctionsMPI::gatherArray(arr, station_dim_index, num_procs_, world_rank_, verbose_);
+    }
+
+    return;
+}
+
+void
+AnEnISMPI::computeSds_(const Forecasts & forecasts, const vector<size_t> & times_fixed_index, const vector<size_t> & times_accum_index) {
+
+    // The process ID and the number of processes have been determined in compute
+    if (world_rank_ == 0 && !master_share_) {
         if (verbose_ >= Verbose::Detail) cout << "Master process only allocate memory for standard deviation ..." << endl;
         AnEnIS::allocateSds_(forecasts, times_fixed_index, times_accum_index);
 
-    } else if (world_rank < num_procs) {
+    } else if (world_rank_ < num_procs_) {
         AnEnIS::computeSds_(forecasts, times_fixed_index, times_accum_index);
 
     } else {
-        if (verbose_ >= Verbose::Debug) cout << "Worker #" << world_rank << " is doing nothing because too many process have been created!" << endl;
+        if (verbose_ >= Verbose::Debug) cout << "Worker #" << world_rank_ << " is doing nothing because too many process have been created!" << endl;
     }
 
     return;
 }
-
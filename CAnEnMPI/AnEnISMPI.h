@@ -16,6 +16,34 @@
  * \class AnEnISMPI
  * 
  * \brief AnEnISMPI provides the functionality to perform AnEnIS with MPI
+ *
+ * By default, the master holds forecasts and observations and scatters them
+ * by stations. The master keeps the first block of stations and computes it
+ * together with workers. If the master only has dimensions without values,
+ * e.g. read by AnEnReadNcdfMPI, nothing is scattered. Each worker is then
+ * expected to have read its own stations, and the master does not compute.
+ *
+ * Each process computes its stations with OpenMP threads, so it is usually
+ * better to launch one process per node or per socket with OMP_NUM_THREADS
+ * set to the number of cores it owns, than one process per core. Metadata
+ * and standard deviation tables are then only replicated once per process.
+ * Threads should be pinned, e.g. with OMP_PROC_BIND=close and
+ * OMP_PLACES=cores, and the MPI launcher should bind each process to its
+ * socket or node, e.g. mpirun --map-by ppr:1:socket:pe=<cores> for Open MPI.
+ *
+ * Stations with fewer missing values take longer to compute, so a static
+ * partition can leave some processes waiting for others. If
+ * Config::dynamic_chunks is positive and the master holds values, stations
+ * are instead split into chunks of similar estimated cost, and the master
+ * hands out chunks to workers as they become free, largest first. The cost of
+ * a station is estimated from the numbers of valid observations and forecasts.
+ * The master then coordinates without computing.
+ *
+ * The busy and idle time of each process is recorded in the profiler.
+ *
+ * Results are gathered to the master by default. Otherwise, each process keeps
+ * the results of its own stations, e.g. to write them in parallel, and stations
+ * are always partitioned statically.
  */
 class AnEnISMPI : public AnEnIS {
 
@@ -37,12 +65,70 @@ public:
             std::vector<std::size_t> & fcsts_test_index,
             std::vector<std::size_t> & fcsts_search_index) override;
 
+    /**
+     * Sets whether results are gathered to the master after computation.
+     * All processes should set the same value.
+     */
+    void setGatherResults(bool gather_results);
+
+    /**
+     * The global index of the first station and the number of stations of
+     * the results held by this process. Only meaningful if results are not
+     * gathered.
+     */
+    std::size_t getStationStart() const;
+    std::size_t getStationCount() const;
+
 private:
-    void gather_(int num_procs, int rank);
+    int world_rank_;
+    int num_procs_;
+
+    /**
+     * Whether the master computes a share of stations
+     */
+    bool master_share_;
+
+    /**
+     * The number of station chunks per worker for dynamic load balancing
+     */
+    std::size_t dynamic_chunks_;
+
+    bool gather_results_;
+    std::size_t station_start_;
+    std::size_t station_count_;
+
+    void gather_(std::size_t num_total_stations);
+    void gatherArray_(Array4DPointer & arr, int station_dim_index, std::size_t num_total_stations);
+
+    /**
+     * Computes analogs with chunks of stations dispatched by the master
+     * to workers on request.
+     */
+    void computeDynamic_(const Forecasts & forecasts,
+            const Observations & observations,
+            std::vector<std::size_t> & fcsts_test_index,
+            std::vector<std::size_t> & fcsts_search_index);
+
+    /**
+     * Splits stations into contiguous chunks of similar estimated cost.
+     * Chunks are sorted by their cost in descending order.
+     */
+    void splitChunks_(const Forecasts & forecasts, const Observations & observations,
+            std::vector< std::pair<std::size_t, std::size_t> > & chunks) const;
+
+    /**
+     * Result arrays to be collected by the master with their station dimensions
+     */
+    std::vector< std::pair<Array4DPointer *, std::size_t> > resultArrays_();
+
+    /**
+     * Collects the busy and idle time of all processes into the master profiler
+     */
+    void logRankTimes_(double busy, double idle);
 
     /**
      * Overloads AnEnIS::computeSds_ so that master process does not compute
-     * any standard deviation. Only worker processes compute standard deviation.
+     * any standard deviation when it does not compute analogs.
      */
     virtual void computeSds_(const Forecasts & forecasts,
             const std::vector<std::size_t> & times_fixed_index,
@@ -0,0 +1,393 @@
+/*
+ * File:   AnEnSSEMPI.cpp
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#include "AnEnSSEMPI.h"
+#include "Functions.h"
+#include "FunctionsMPI.h"
+#include "ForecastsPointer.h"
+#include "ObservationsPointer.h"
+
+#include <numeric>
+#include <algorithm>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+using namespace std;
+
+
+AnEnSSEMPI::AnEnSSEMPI() : AnEnSSE(), world_rank_(0), num_procs_(0), station_start_(0) {
+}
+
+AnEnSSEMPI::AnEnSSEMPI(const AnEnSSEMPI & orig) : AnEnSSE(orig),
+world_rank_(orig.world_rank_), num_procs_(orig.num_procs_),
+station_start_(orig.station_start_), halo_(orig.halo_) {
+}
+
+AnEnSSEMPI::AnEnSSEMPI(const Config & config) : AnEnSSE(config), world_rank_(0), num_procs_(0), station_start_(0) {
+}
+
+AnEnSSEMPI::~AnEnSSEMPI() {
+}
+
+void
+AnEnSSEMPI::compute(const Forecasts & forecasts, const Observations & observations,
+            vector<size_t> & fcsts_test_index, vector<size_t> & fcsts_search_index) {
+
+    // Get the process ID
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank_);
+
+    /*
+     * Stations are partitioned by forecast stations, and search stations are
+     * mapped to observations with the same indices. Forecasts and
+     * observations with different stations (AnEnSSEMS) are not supported
+     * with MPI. All processes check this before anything is scattered.
+     */
+    unsigned long num_stations[2];
+
+    if (world_rank_ == 0) {
+        num_stations[0] = forecasts.getStations().size();
+        num_stations[1] = observations.getStations().size();
+    }
+
+    MPI_Bcast(num_stations, 2, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+
+    if (num_stations[0] != num_stations[1]) {
+        ostringstream msg;
+        msg << "AnEnSSEMPI needs the same stations in forecasts and observations but there are "
+                << num_stations[0] << " forecast stations and " << num_stations[1]
+                << " observation stations. Different stations are only supported by AnEnSSEMS without MPI";
+        throw runtime_error(msg.str());
+    }
+
+    // Get the number of processes that are effectively working
+    FunctionsMPI::effective_num_procs(MPI_COMM_WORLD, &num_procs_, world_rank_, forecasts, verbose_);
+
+    if (num_procs_ == 1) {
+        if (forecasts.num_elements() == 0) throw runtime_error("At least 2 processes are needed when the master only has dimensions of forecasts");
+
+        // The only process computes all stations
+        if (verbose_ >= Verbose::Progress) cout << "Start AnEnSSE generation with a single MPI process ..." << endl;
+
+        Functions::setSearchStations(forecasts.getStations(), search_stations_,
+                num_nearest_, distance_, exclude_closest_location_);
+        AnEnSSE::compute(forecasts, observations, fcsts_test_index, fcsts_search_index);
+        return;
+    }
+
+    if (world_rank_ == 0 && verbose_ >= Verbose::Progress) cout << "Start AnEnSSE generation with MPI ..." << endl;
+
+    /*
+     * Search stations are computed by the master because workers do not
+     * have station coordinates. Each worker receives search stations of its
+     * own stations with global station indices.
+     */
+    unsigned long num_total_stations;
+
+    if (world_rank_ == 0) {
+        num_total_stations = forecasts.getStations().size();
+
+        if (verbose_ >= Verbose::Progress) cout << "Computing search stations ..." << endl;
+        Functions::setSearchStations(forecasts.getStations(), search_stations_,
+                num_nearest_, distance_, exclude_closest_location_);
+    }
+
+    MPI_Bcast(&num_total_stations, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+
+    // Weights can be changed on the master only, e.g. after AI transformation
+    unsigned long num_weights = weights_.size();
+    MPI_Bcast(&num_weights, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+    weights_.resize(num_weights);
+    MPI_Bcast(weights_.data(), num_weights, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    Neighbors proc_search_stations;
+    FunctionsMPI::scatterNeighbors(search_stations_, proc_search_stations, num_procs_, world_rank_, verbose_);
+    if (world_rank_ == 0) profiler_.log_time_session("Master computing search stations (AnEnSSEMPI)");
+
+    /*
+     * Forecasts and observations are scattered from the master, unless the
+     * master only has dimensions without values. Unlike AnEnISMPI, the
+     * master never computes a share of stations. Halo stations are exchanged
+     * among workers, and the master is busy with search stations and results.
+     */
+    int scatter;
+    if (world_rank_ == 0) scatter = (forecasts.num_elements() != 0);
+    MPI_Bcast(&scatter, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    ForecastsPointer proc_forecasts;
+    ObservationsPointer proc_observations;
+
+    if (scatter) {
+
+        // Scatter forecasts by stations
+        if (world_rank_ == 0 && verbose_ >= Verbose::Detail) cout << "Master process is scattering forecasts to workers ..." << endl;
+        FunctionsMPI::scatterForecasts(forecasts, proc_forecasts, num_procs_, world_rank_, verbose_);
+        if (world_rank_ == 0 && verbose_ >= Verbose::Detail) {
+            cout << "Forecasts have been scattered to workers." << endl;
+            profiler_.log_time_session("Master scattering forecasts (AnEnSSEMPI)");
+        }
+
+        // Scatter observations by stations
+        if (world_rank_ == 0 && verbose_ >= Verbose::Detail) cout << "Master process is scattering observations to workers ..." << endl;
+        FunctionsMPI::scatterObservations(observations, proc_observations, num_procs_, world_rank_, verbose_);
+        if (world_rank_ == 0 && verbose_ >= Verbose::Detail) {
+            cout << "Observations have been scattered to workers." << endl;
+            profiler_.log_time_session("Master scattering observations (AnEnSSEMPI)");
+        }
+
+    } else {
+        if (world_rank_ == 0 && verbose_ >= Verbose::Detail) cout << "Workers use forecasts and observations read by themselves." << endl;
+        FunctionsMPI::checkWorkerStations(forecasts, observations, num_procs_, world_rank_, verbose_);
+    }
+
+    const Forecasts & local_forecasts = (scatter ? static_cast<const Forecasts &> (proc_forecasts) : forecasts);
+    const Observations & local_observations = (scatter ? static_cast<const Observations &> (proc_observations) : observations);
+
+    // Broadcast test and search
+    vector<size_t> proc_test_index, proc_search_index;
+    FunctionsMPI::broadcastVector(fcsts_test_index, proc_test_index, world_rank_, verbose_);
+    FunctionsMPI::broadcastVector(fcsts_search_index, proc_search_index, world_rank_, verbose_);
+    if (world_rank_ == 0) profiler_.log_time_session("Master broadcasting configuration (AnEnSSEMPI)");
+
+    /*
+     * Halo stations are search stations owned by other workers
+     */
+    bool is_worker = (world_rank_ > 0 && world_rank_ < num_procs_);
+    size_t num_own_stations = proc_search_stations.size();
+
+    station_start_ = 0;
+    halo_.clear();
+
+    if (is_worker) {
+        station_start_ = Functions::getStartIndex(num_total_stations, num_procs_, world_rank_);
+        size_t station_end = station_start_ + num_own_stations;
+
+        for (const auto & index : proc_search_stations.indices) {
+            if (index < station_start_ || index >= station_end) halo_.push_back(index);
+        }
+
+        sort(halo_.begin(), halo_.end());
+        halo_.erase(unique(halo_.begin(), halo_.end()), halo_.end());
+
+        if (verbose_ >= Verbose::Detail) cout << "Worker #" << world_rank_ << " owns " << num_own_stations
+                << " stations from #" << station_start_ << " and has " << halo_.size() << " halo stations" << endl;
+    }
+
+    // Exchange forecasts of halo stations
+    ForecastsPointer halo_forecasts;
+    FunctionsMPI::exchangeHalo(local_forecasts, halo_forecasts, num_total_stations, halo_, num_procs_, world_rank_, verbose_);
+
+    // Observations of halo stations are only needed when observations are extended
+    ObservationsPointer halo_observations;
+    if (extend_obs_) FunctionsMPI::exchangeHalo(local_observations, halo_observations,
+            num_total_stations, halo_, num_procs_, world_rank_, verbose_);
+
+    if (world_rank_ == 0) profiler_.log_time_session("Master waiting for halo exchange (AnEnSSEMPI)");
+
+    if (world_rank_ == 0) {
+        // This is a master
+
+        // Preprocess to allocate memory
+        preprocess_(forecasts, observations, fcsts_test_index, fcsts_search_index);
+
+        /*
+         * Progress messages output
+         */
+        if (verbose_ >= Verbose::Detail) {
+            cout << "********** AnEn Configuration Summary (Master) **********" << endl;
+            print(cout);
+            cout << "*********** End of AnEn Configuration Summary **********" << endl;
+        }
+
+        profiler_.log_time_session("Master preprocessing (AnEnSSEMPI)");
+
+    } else if (is_worker) {
+        // This is a worker
+
+        // Convert search stations to local indices. Own stations are
+        // followed by halo stations in forecasts with halo.
+        //
+        search_stations_ = std::move(proc_search_stations);
+        size_t station_end = station_start_ + num_own_stations;
+
+        for (auto & index : search_stations_.indices) {
+            if (index >= station_start_ && index < station_end) index -= station_start_;
+            else index = num_own_stations + (lower_bound(halo_.begin(), halo_.end(), index) - halo_.begin());
+        }
+
+        /*
+         * Like AnEnISMPI, each worker uses as many OpenMP threads as
+         * configured, e.g. with OMP_NUM_THREADS.
+         */
+        if (verbose_ >= Verbose::Detail) {
+            cout << "Worker #" << world_rank_ << " computes " << num_own_stations << " stations"
+#if defined(_OPENMP)
+                << " with " << omp_get_max_threads() << " threads"
+#endif
+                << endl;
+        }
+
+        // Compute analogs
+        if (extend_obs_) AnEnSSE::compute(halo_forecasts, halo_observations, proc_test_index, proc_search_index);
+        else AnEnSSE::compute(halo_forecasts, local_observations, proc_test_index, proc_search_index);
+    } else {
+        if (verbose_ >= Verbose::Debug) cout << "Worker #" << world_rank_ << " is doing nothing because too many process have been created!" << endl;
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    profiler_.log_time_session("Master waiting for analog computation (AnEnSSEMPI)");
+
+    // Collect members in AnEnSSE
+    if (world_rank_ == 0 && verbose_ >= Verbose::Detail) {
+        cout << "Master process is receiving analog results from workers ..." << endl;
+    }
+    gather_();
+    if (world_rank_ == 0 && verbose_ >= Verbose::Detail) {
+        cout << "Analog results have been collected at master." << endl;
+        profiler_.log_time_session("Master receiving analogs (AnEnSSEMPI)");
+    }
+
+    return;
+}
+
+void
+AnEnSSEMPI::gather_() {
+
+    if (world_rank_ > 0 && world_rank_ < num_procs_) {
+
+        size_t num_own_stations = search_stations_.size();
+
+        // Standard deviations of halo stations are not sent back
+        if (sds_.shape()[1] != num_own_stations) {
+            vector<size_t> parameters(sds_.shape()[0]), stations(num_own_stations), flts(sds_.shape()[2]), times(sds_.shape()[3]);
+            iota(parameters.begin(), parameters.end(), 0);
+            iota(stations.begin(), stations.end(), 0);
+            iota(flts.begin(), flts.end(), 0);
+            iota(times.begin(), times.end(), 0);
+
+            Array4DPointer own_sds;
+            sds_.subset(parameters, stations, flts, times, own_sds);
+            sds_ = std::move(own_sds);
+        }
+
+        // Convert similarity station indices back to global indices
+        if (save_sims_station_index_) {
+            double* ptr = sims_station_index_.getValuesPtr();
+            size_t num_elements = sims_station_index_.num_elements();
+
+            for (size_t i = 0; i < num_elements; ++i) {
+                if (std::isnan(ptr[i])) continue;
+
+                size_t index = ptr[i];
+                if (index < num_own_stations) ptr[i] = station_start_ + index;
+                else ptr[i] = halo_[index - num_own_stations];
+            }
+        }
+    }
+
+    // The number 1 is because the station dimension is the second dimension
+    FunctionsMPI::gatherArray(sds_, 1, num_procs_, world_rank_, verbose_);
+
+    // The number 0 is because the station dimension is the first dimension
+    if (save_analogs_) FunctionsMPI::gatherArray(analogs_value_, 0, num_procs_, world_rank_, verbose_);
+    if (save_analogs_time_index_) FunctionsMPI::gatherArray(analogs_time_index_, 0, num_procs_, world_rank_, verbose_);
+    if (save_sims_) FunctionsMPI::gatherArray(sims_metric_, 0, num_procs_, world_rank_, verbose_);
+    if (save_sims_time_index_) FunctionsMPI::gatherArray(sims_time_index_, 0, num_procs_, world_rank_, verbose_);
+    if (save_sims_station_index_) FunctionsMPI::gatherArray(sims_station_index_, 0, num_procs_, world_rank_, verbose_);
+
+    return;
+}
+
+void
+AnEnSSEMPI::preprocess_(const Forecasts & forecasts,
+        const Observations & observations,
+        vector<size_t> & fcsts_test_index,
+        vector<size_t> & fcsts_search_index) {
+
+    // Search stations have been set in compute
+    AnEnIS::preprocess_(forecasts, observations, fcsts_test_index, fcsts_search_index);
+    return;
+}
+
+void
+AnEnSSEMPI::allocateMemory_(const Forecasts & forecasts,
+        const vector<size_t> & fcsts_test_index, const vector<size_t> & fcsts_search_index) {
+
+    if (verbose_ >= Verbose::Progress) cout << "Allocating memory ..." << endl;
+
+    size_t num_stations = search_stations_.size();
+    size_t num_flts = forecasts.getFLTs().size();
+    size_t num_test_times_index = fcsts_test_index.size();
+    size_t num_search_times_index = fcsts_search_index.size();
+
+    // Check for the maximum number of values we can save
+    checkNumberOfMembers_(num_search_times_index);
+
+    if (save_analogs_) {
+        analogs_value_.resize(num_stations, num_test_times_index, num_flts, num_analogs_);
+        analogs_value_.initialize(NAN);
+    }
+
+    if (save_analogs_time_index_) {
+        analogs_time_index_.resize(num_stations, num_test_times_index, num_flts, num_analogs_);
+        analogs_time_index_.initialize(NAN);
+    }
+
+    if (save_sims_) {
+        sims_metric_.resize(num_stations, num_test_times_index, num_flts, num_sims_);
+        sims_metric_.initialize(NAN);
+    }
+
+    if (save_sims_time_index_) {
+        sims_time_index_.resize(num_stations, num_test_times_index, num_flts, num_sims_);
+        sims_time_index_.initialize(NAN);
+    }
+
+    if (save_sims_station_index_) {
+        sims_station_index_.resize(num_stations, num_test_times_index, num_flts, num_sims_);
+        sims_station_index_.initialize(NAN);
+    }
+
+    return;
+}
+
+void
+AnEnSSEMPI::computeSds_(const Forecasts & forecasts, const vector<size_t> & times_fixed_index, const vector<size_t> & times_accum_index) {
+
+    if (world_rank_ == 0 && num_procs_ > 1) {
+        if (verbose_ >= Verbose::Detail) cout << "Master process only allocate memory for standard deviation ..." << endl;
+        AnEnIS::allocateSds_(forecasts, times_fixed_index, times_accum_index);
+    } else {
+        AnEnIS::computeSds_(forecasts, times_fixed_index, times_accum_index);
+    }
+
+    return;
+}
+
+void
+AnEnSSEMPI::checkConsistency_(const Forecasts & forecasts,
+        const Observations & observations) const {
+
+    // Observations of workers only include halo stations when they are extended
+    size_t num_stations = (extend_obs_ ? forecasts.getStations().size() : search_stations_.size());
+
+    if (num_stations != observations.getStations().size()) {
+        ostringstream msg;
+        msg << "#stations (" << num_stations << ") != #observation stations ("
+                << observations.getStations().size() << ")";
+        throw runtime_error(msg.str());
+    }
+
+    if (obs_var_index_ >= observations.getParameters().size()) {
+        ostringstream msg;
+        msg << "Observation variable index is " << obs_var_index_
+                << " (counting from 0) but there are only "
+                << observations.getParameters().size() << " parameters";
+        throw runtime_error(msg.str());
+    }
+
+    return;
+}
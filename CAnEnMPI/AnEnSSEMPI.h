@@ -0,0 +1,104 @@
+/*
+ * File:   AnEnSSEMPI.h
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+
+#ifndef AnEnSSEMPI_H
+#define AnEnSSEMPI_H
+
+#include "AnEnSSE.h"
+#include <mpi.h>
+
+/**
+ * \class AnEnSSEMPI
+ *
+ * \brief AnEnSSEMPI provides the functionality to perform AnEnSSE with MPI.
+ *
+ * Stations are partitioned into contiguous blocks in the same way as
+ * AnEnISMPI. The master computes search stations and scatters forecasts and
+ * observations. Search stations of a worker that belong to other workers
+ * are halo stations. Workers exchange forecasts of halo stations, and also
+ * observations if observations are extended, before computing analogs.
+ * Results are gathered to the master. Like AnEnISMPI, nothing is scattered
+ * if the master only has dimensions, e.g. read by AnEnReadNcdfMPI, each
+ * worker uses as many OpenMP threads as configured, and a single process
+ * computes all stations by itself. Unlike AnEnISMPI, the master does not
+ * compute a share of stations.
+ *
+ * Forecasts and observations should have the same stations. AnEnSSEMS has
+ * no MPI counterpart.
+ *
+ * Blocks are only spatially compact when nearby stations have close
+ * indices. Reordering stations along a space-filling curve, e.g. with
+ * Functions::spaceFillingOrder, makes halos smaller.
+ */
+class AnEnSSEMPI : public AnEnSSE {
+
+public:
+    AnEnSSEMPI();
+    AnEnSSEMPI(const AnEnSSEMPI& orig);
+    AnEnSSEMPI(const Config &);
+
+    virtual ~AnEnSSEMPI();
+
+    // Using AnEnIS wrapper function compute
+    using AnEnSSE::compute;
+
+    /**
+     * Overloads AnEnSSE::compute with test and search indices
+     */
+    virtual void compute(const Forecasts & forecasts,
+            const Observations & observations,
+            std::vector<std::size_t> & fcsts_test_index,
+            std::vector<std::size_t> & fcsts_search_index) override;
+
+private:
+
+    int world_rank_;
+    int num_procs_;
+
+    /**
+     * The global index of the first station owned by this worker
+     */
+    std::size_t station_start_;
+
+    /**
+     * Sorted global indices of halo stations of this worker
+     */
+    std::vector<std::size_t> halo_;
+
+    void gather_();
+
+    /**
+     * Overloads AnEnSSE::preprocess_ so that search stations, which have
+     * been set before computation, are not computed again.
+     */
+    virtual void preprocess_(const Forecasts & forecasts,
+            const Observations & observations,
+            std::vector<std::size_t> & fcsts_test_index,
+            std::vector<std::size_t> & fcsts_search_index) override;
+
+    /**
+     * Overloads AnEnSSE::allocateMemory_ because forecasts of workers
+     * include halo stations. Results are only allocated for own stations.
+     */
+    virtual void allocateMemory_(const Forecasts & forecasts,
+            const std::vector<std::size_t> & fcsts_test_index,
+            const std::vector<std::size_t> & fcsts_search_index) override;
+
+    /**
+     * Overloads AnEnIS::computeSds_ so that master process does not compute
+     * any standard deviation unless it is the only process. Workers also
+     * compute standard deviation for halo stations because they are used to
+     * normalize search forecasts.
+     */
+    virtual void computeSds_(const Forecasts & forecasts,
+            const std::vector<std::size_t> & times_fixed_index,
+            const std::vector<std::size_t> & times_accum_index = {}) override;
+
+    virtual void checkConsistency_(const Forecasts & forecasts,
+            const Observations & observations) const override;
+};
+
+#endif /* AnEnSSEMPI_H */
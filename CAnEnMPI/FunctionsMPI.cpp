@@ -13,6 +13,8 @@
 #include <cmath>
 #include <numeric>
 #include <string>
+#include <sstream>
+#include <algorithm>
 #include <boost/numeric/conversion/cast.hpp>
 
 using namespace std;
@@ -20,22 +22,243 @@ using namespace std;
 static const int MPI_TAG_OBS = 4;
 static const int MPI_TAG_ARR = 5;
 
+/*
+ * Exchanges halo stations of an array with the layout [block, station, repeats]
+ * in column-major order. Values of a station are packed into a contiguous
+ * buffer so that each station is sent as a single element.
+ */
+static void
+exchangeStations_(const double * local, double * extended,
+        size_t block, size_t num_repeats, size_t num_local, size_t num_total_stations,
+        const vector<size_t> & halo, int num_procs, int rank, Verbose verbose) {
+
+    int world_size;
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+    size_t num_extended = num_local + halo.size();
+    size_t station_len = block * num_repeats;
+
+    // Copy own stations
+    for (size_t repeat_i = 0; repeat_i < num_repeats; ++repeat_i) {
+        copy_n(local + repeat_i * block * num_local, block * num_local, extended + repeat_i * block * num_extended);
+    }
+
+    // The end of stations owned by each worker process
+    vector<size_t> owner_ends(num_procs, 0);
+    for (int worker_rank = 1; worker_rank < num_procs; ++worker_rank) {
+        owner_ends[worker_rank] = Functions::getEndIndex(num_total_stations, num_procs, worker_rank);
+    }
+
+    size_t station_start = 0;
+    if (rank > 0 && rank < num_procs) station_start = Functions::getStartIndex(num_total_stations, num_procs, rank);
+
+    // Count how many halo stations are requested from each owner. Halo
+    // stations are sorted so that requests to an owner are contiguous.
+    vector<int> request_counts(world_size, 0), request_displs(world_size, 0);
+    for (const auto & station_i : halo) {
+        if (station_i >= num_total_stations) throw runtime_error("(FunctionsMPI::exchangeHalo) Halo station index out of range");
+        int owner = upper_bound(owner_ends.begin() + 1, owner_ends.end(), station_i) - owner_ends.begin();
+        ++request_counts[owner];
+    }
+    partial_sum(request_counts.begin(), request_counts.end() - 1, request_displs.begin() + 1);
+
+    // Let owners know how many stations to serve
+    vector<int> serve_counts(world_size, 0), serve_displs(world_size, 0);
+    MPI_Alltoall(request_counts.data(), 1, MPI_INT, serve_counts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    partial_sum(serve_counts.begin(), serve_counts.end() - 1, serve_displs.begin() + 1);
+    size_t num_serve = serve_displs.back() + serve_counts.back();
+
+    // Send requested station indices to owners
+    vector<unsigned long> request_stations(halo.begin(), halo.end()), serve_stations(num_serve);
+    MPI_Alltoallv(request_stations.data(), request_counts.data(), request_displs.data(), MPI_UNSIGNED_LONG,
+            serve_stations.data(), serve_counts.data(), serve_displs.data(), MPI_UNSIGNED_LONG, MPI_COMM_WORLD);
+
+    if (verbose >= Verbose::Debug) cout << "Rank #" << rank << " requests " << halo.size()
+        << " halo stations and serves " << num_serve << " stations" << endl;
+
+    // Pack requested stations
+    vector<double> send_buffer(num_serve * station_len), recv_buffer(halo.size() * station_len);
+
+    for (size_t serve_i = 0; serve_i < num_serve; ++serve_i) {
+        size_t station_i = serve_stations[serve_i] - station_start;
+        if (serve_stations[serve_i] < station_start || station_i >= num_local) throw runtime_error(
+                "(FunctionsMPI::exchangeHalo) A station is requested from a process that does not own it");
+
+        for (size_t repeat_i = 0; repeat_i < num_repeats; ++repeat_i) {
+            copy_n(local + repeat_i * block * num_local + station_i * block, block,
+                    send_buffer.begin() + serve_i * station_len + repeat_i * block);
+        }
+    }
+
+    // Exchange values. Each station is a single element so that counts stay small.
+    MPI_Datatype station_type;
+    MPI_Type_contiguous(boost::numeric_cast<int>(station_len), MPI_DOUBLE, &station_type);
+    MPI_Type_commit(&station_type);
+
+    int err = MPI_Alltoallv(send_buffer.data(), serve_counts.data(), serve_displs.data(), station_type,
+            recv_buffer.data(), request_counts.data(), request_displs.data(), station_type, MPI_COMM_WORLD);
+
+    MPI_Type_free(&station_type);
+
+    if (err != MPI_SUCCESS) {
+        char err_buffer[MPI_MAX_ERROR_STRING];
+        int err_len;
+        MPI_Error_string(err, err_buffer, &err_len);
+        throw runtime_error(string("Rank #") + to_string(rank) + string(" failed to exchange halo stations. MPI error: ") + string(err_buffer));
+    }
+
+    // Unpack halo stations after own stations
+    for (size_t halo_i = 0; halo_i < halo.size(); ++halo_i) {
+        for (size_t repeat_i = 0; repeat_i < num_repeats; ++repeat_i) {
+            copy_n(recv_buffer.begin() + halo_i * station_len + repeat_i * block, block,
+                    extended + repeat_i * block * num_extended + (num_local + halo_i) * block);
+        }
+    }
+
+    return;
+}
+
+/*
+ * Creates a datatype for a block of stations in a column-major array. The
+ * buffer should point to the first station of the block. Dimensions after the
+ * station dimension are nested as strided vectors so that a block is sent as
+ * a single element without packing, and the number of values is not limited
+ * by the int count of MPI calls.
+ */
+static MPI_Datatype
+createStationBlockType_(const vector<size_t> & shape, size_t station_dim, size_t num_block_stations) {
+
+    size_t inner = 1;
+    for (size_t dim_i = 0; dim_i < station_dim; ++dim_i) inner *= shape[dim_i];
+
+    MPI_Datatype station_type, block_type;
+    MPI_Type_contiguous(boost::numeric_cast<int>(inner), MPI_DOUBLE, &station_type);
+    MPI_Type_contiguous(boost::numeric_cast<int>(num_block_stations), station_type, &block_type);
+    MPI_Type_free(&station_type);
+
+    // Bytes between two consecutive indices of the next dimension
+    MPI_Aint stride = inner * shape[station_dim] * sizeof(double);
+
+    for (size_t dim_i = station_dim + 1; dim_i < shape.size(); ++dim_i) {
+        MPI_Datatype outer_type;
+        MPI_Type_create_hvector(boost::numeric_cast<int>(shape[dim_i]), 1, stride, block_type, &outer_type);
+        MPI_Type_free(&block_type);
+
+        block_type = outer_type;
+        stride *= shape[dim_i];
+    }
+
+    MPI_Type_commit(&block_type);
+    return block_type;
+}
+
+/*
+ * Copies a block of stations between two column-major arrays that only
+ * differ in the number of stations.
+ */
+static void
+copyStationBlock_(const double * src, size_t src_stations, size_t src_start,
+        double * dst, size_t dst_stations, size_t dst_start,
+        const vector<size_t> & shape, size_t station_dim, size_t num_block_stations) {
+
+    size_t inner = 1, outer = 1;
+    for (size_t dim_i = 0; dim_i < station_dim; ++dim_i) inner *= shape[dim_i];
+    for (size_t dim_i = station_dim + 1; dim_i < shape.size(); ++dim_i) outer *= shape[dim_i];
+
+    for (size_t outer_i = 0; outer_i < outer; ++outer_i) {
+        copy_n(src + (outer_i * src_stations + src_start) * inner, num_block_stations * inner,
+                dst + (outer_i * dst_stations + dst_start) * inner);
+    }
+
+    return;
+}
+
+/*
+ * Sends blocks of stations to all workers with non-blocking sends so that
+ * transfers to different workers overlap. If the master shares the
+ * computation, its own block is copied to the master block.
+ */
+static void
+sendStationBlocks_(const double * data_ptr, const vector<size_t> & shape, size_t station_dim,
+        int tag, int num_procs, Verbose verbose, double * master_block = nullptr) {
+
+    size_t num_total_stations = shape[station_dim];
+    bool master_share = (master_block != nullptr);
+
+    if (master_share) {
+        size_t master_stations_count = FunctionsMPI::getStationCount(num_total_stations, num_procs, 0, true);
+        if (verbose >= Verbose::Debug) cout << "Master keeping " << master_stations_count << " stations for itself ..." << endl;
+
+        copyStationBlock_(data_ptr, num_total_stations, 0, master_block, master_stations_count, 0,
+                shape, station_dim, master_stations_count);
+    }
+
+    if (num_procs <= 1) return;
+
+    size_t inner = 1;
+    for (size_t dim_i = 0; dim_i < station_dim; ++dim_i) inner *= shape[dim_i];
+
+    vector<MPI_Request> requests(num_procs - 1);
+    vector<MPI_Datatype> types(num_procs - 1);
+
+    for (int worker_rank = 1; worker_rank < num_procs; ++worker_rank) {
+
+        // Determine which stations to send to this worker process
+        size_t worker_station_start = FunctionsMPI::getStationStart(num_total_stations, num_procs, worker_rank, master_share);
+        size_t worker_stations_count = FunctionsMPI::getStationCount(num_total_stations, num_procs, worker_rank, master_share);
+
+        if (verbose >= Verbose::Detail) cout << "Master sending a subset of array [station start: "
+            << worker_station_start << " count: " << worker_stations_count << "] to worker #" << worker_rank << "..." << endl;
+
+        types[worker_rank - 1] = createStationBlockType_(shape, station_dim, worker_stations_count);
+        MPI_Isend(data_ptr + worker_station_start * inner, 1, types[worker_rank - 1],
+                worker_rank, tag, MPI_COMM_WORLD, &requests[worker_rank - 1]);
+    }
+
+    int err = MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    for (auto & type : types) MPI_Type_free(&type);
+
+    if (err != MPI_SUCCESS) {
+        char err_buffer[MPI_MAX_ERROR_STRING];
+        int err_len;
+        MPI_Error_string(err, err_buffer, &err_len);
+        throw runtime_error(string("Master failed to send data to workers. MPI error: ") + string(err_buffer));
+    }
+
+    return;
+}
+
+/*
+ * Receives the block of stations of this worker. Local values are contiguous.
+ */
+static void
+recvStationBlock_(double * data_ptr, const vector<size_t> & shape, size_t station_dim, int tag) {
+
+    MPI_Datatype type = createStationBlockType_(shape, station_dim, shape[station_dim]);
+    MPI_Recv(data_ptr, 1, type, 0, tag, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    MPI_Type_free(&type);
+
+    return;
+}
+
 void
-FunctionsMPI::effective_num_procs(MPI_Comm comm, int *num_procs, int world_rank, const Forecasts & forecasts, Verbose verbose) {
+FunctionsMPI::effective_num_procs(MPI_Comm comm, int *num_procs, int world_rank, const Forecasts & forecasts, Verbose verbose, bool master_share) {
 
-    // Deal with the situation when the number of processes is greater than the number of stations plus 1
+    // Deal with the situation when the number of processes is greater than the number of stations
+    // plus 1, or the number of stations if the master also computes a share.
     if (world_rank == 0) {
         MPI_Comm_size(MPI_COMM_WORLD, num_procs);
 
-        size_t num_stations = forecasts.getStations().size();
+        int num_stations = forecasts.getStations().size();
+        int max_procs = (master_share ? num_stations : num_stations + 1);
 
-        if (*num_procs > num_stations + 1) {
+        if (*num_procs > max_procs) {
             if (verbose >= Verbose::Warning) {
                 cerr << "Warning: There are only " << num_stations << " stations but " << *num_procs << " processes are created."
-                    << "Only " << num_stations + 1 << " processes will be effectively working" << endl;
+                    << "Only " << max_procs << " processes will be effectively working" << endl;
             }
 
-            *num_procs = num_stations + 1;
+            *num_procs = max_procs;
         }
     }
 
@@ -44,54 +267,43 @@ FunctionsMPI::effective_num_procs(MPI_Comm comm, int *num_procs, int world_rank,
     return;
 }
 
+size_t
+FunctionsMPI::getStationStart(size_t num_total_stations, int num_procs, int rank, bool master_share) {
+    // Functions assume that the master does not own any stations
+    if (master_share) return Functions::getStartIndex(num_total_stations, num_procs + 1, rank + 1);
+    if (rank == 0) return 0;
+    return Functions::getStartIndex(num_total_stations, num_procs, rank);
+}
+
+size_t
+FunctionsMPI::getStationCount(size_t num_total_stations, int num_procs, int rank, bool master_share) {
+    if (master_share) return Functions::getSubTotal(num_total_stations, num_procs + 1, rank + 1);
+    if (rank == 0) return 0;
+    return Functions::getSubTotal(num_total_stations, num_procs, rank);
+}
+
 void
-FunctionsMPI::scatterObservations(const Observations & send, Observations & recv, int num_procs, int rank, Verbose verbose) {
+FunctionsMPI::scatterObservations(const Observations & send, Observations & recv, int num_procs, int rank, Verbose verbose, bool master_share) {
 
     // Scatter the base class
-    scatterBasicData(send, recv, num_procs, rank, verbose);
+    scatterBasicData(send, recv, num_procs, rank, verbose, master_share);
 
     // Scatter array
-    if (rank == 0) {
+    vector<size_t> shape;
 
-        char err_buffer[MPI_MAX_ERROR_STRING];
-        int err_len;
-
-        ObservationsPointer obs_sub;
-
-        const Parameters & all_parameters = send.getParameters();
-        const Times & all_times = send.getTimes();
-
-        size_t num_total_stations = send.getStations().size();
-
-        for (int worker_rank = 1; worker_rank < num_procs; ++worker_rank) {
-
-            // Determine which stations to send to this worker process
-            int worker_station_start = Functions::getStartIndex(num_total_stations, num_procs, worker_rank);
-            int worker_station_end = Functions::getEndIndex(num_total_stations, num_procs, worker_rank);
-            int worker_stations_count = worker_station_end - worker_station_start;
-
-            Stations stations_subset;
-            const Stations & stations_all = send.getStations();
-            for (int station_i = worker_station_start; station_i < worker_station_end; ++station_i) {
-                stations_subset.push_back(stations_all.getStation(station_i));
-            }
+    if (rank == 0) {
 
-            // Subset
-            if (verbose >= Verbose::Debug) cout << "Master subseting observations along the station dimension for worker #" << worker_rank << "..." << endl;
-            send.subset(all_parameters, stations_subset, all_times, obs_sub);
+        shape = {send.getParameters().size(), send.getStations().size(), send.getTimes().size()};
 
-            // Send data
-            if (verbose >= Verbose::Detail) cout << "Master sending a subset of observations [stations start: "
-                << worker_station_start << " count: " << worker_stations_count <<"] to worker #" << worker_rank << "..." << endl;
+        double * master_block = nullptr;
+        if (master_share) {
+            recv.setDimensions(recv.getParameters(), recv.getStations(), recv.getTimes());
+            master_block = recv.getValuesPtr();
+        }
 
-            double * data_ptr = obs_sub.getValuesPtr();
-            int err = MPI_Send(data_ptr, obs_sub.num_elements(), MPI_DOUBLE, worker_rank, MPI_TAG_OBS, MPI_COMM_WORLD);
+        if (verbose >= Verbose::Debug) cout << "Master sending observations to all workers ..." << endl;
+        sendStationBlocks_(send.getValuesPtr(), shape, 1, MPI_TAG_OBS, num_procs, verbose, master_block);
 
-            if (err != MPI_SUCCESS) {
-                MPI_Error_string(err, err_buffer, &err_len);
-                throw runtime_error(string("Master failed to send observation data to worker #") + to_string(worker_rank) + string(". MPI error: ") + string(err_buffer));
-            }
-        }
     } else if (rank < num_procs) {
 
         recv.setDimensions(recv.getParameters(), recv.getStations(), recv.getTimes());
@@ -105,12 +317,10 @@ FunctionsMPI::scatterObservations(const Observations & send, Observations & recv
                 << num_parameters << " parameters, " << num_stations << " stations, " << num_times << " times]" << "..." << endl;
         }
 
-        // I need to make sure no numeric overflow when narrowing a size_t to an int
-        int count = boost::numeric_cast<int>(recv.num_elements());
-        if (count == 0) throw runtime_error("(FunctionsMPI::scatterObservations) A worker process is receiving array data without allocating memory");
+        if (recv.num_elements() == 0) throw runtime_error("(FunctionsMPI::scatterObservations) A worker process is receiving array data without allocating memory");
 
-        double *data_ptr = recv.getValuesPtr();
-        MPI_Recv(data_ptr, count, MPI_DOUBLE, 0, MPI_TAG_OBS, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        shape = {recv.getParameters().size(), recv.getStations().size(), recv.getTimes().size()};
+        recvStationBlock_(recv.getValuesPtr(), shape, 1, MPI_TAG_OBS);
     } else {
         if (verbose >= Verbose::Debug) cout << "Worker #" << rank << " is doing nothing because too many process have been created!" << endl;
     }
@@ -119,10 +329,10 @@ FunctionsMPI::scatterObservations(const Observations & send, Observations & recv
 }
 
 void
-FunctionsMPI::scatterForecasts(const Forecasts & send, Forecasts & recv, int num_procs, int rank, Verbose verbose) {
+FunctionsMPI::scatterForecasts(const Forecasts & send, Forecasts & recv, int num_procs, int rank, Verbose verbose, bool master_share) {
 
     // Scatter the base class
-    scatterBasicData(send, recv, num_procs, rank, verbose);
+    scatterBasicData(send, recv, num_procs, rank, verbose, master_share);
 
     // Scatter the private member of Forecasts: flts
     vector<size_t> master_flts, worker_flts;
@@ -136,6 +346,7 @@ FunctionsMPI::scatterForecasts(const Forecasts & send, Forecasts & recv, int num
 
     // Broadcast information (flts)
     broadcastVector(master_flts, worker_flts, rank, verbose);
+    if (rank == 0 && master_share) worker_flts = master_flts;
 
     if (rank < num_procs) {
         // I'm the worker
@@ -161,13 +372,13 @@ FunctionsMPI::scatterForecasts(const Forecasts & send, Forecasts & recv, int num
     }
 
     // Scatter array
-    scatterArray(send, recv, num_procs, rank, verbose);
+    scatterArray(send, recv, num_procs, rank, verbose, master_share);
 
     return;
 }
 
 void
-FunctionsMPI::scatterBasicData(const BasicData & send, BasicData & recv, int num_procs, int rank, Verbose verbose) {
+FunctionsMPI::scatterBasicData(const BasicData & send, BasicData & recv, int num_procs, int rank, Verbose verbose, bool master_share) {
 
     /*
     * For BasicData, I need to scatter the following members.
@@ -208,6 +419,12 @@ FunctionsMPI::scatterBasicData(const BasicData & send, BasicData & recv, int num
     // Broadcast all times
     broadcastVector(master_times, worker_times, rank, verbose);
 
+    // The master keeps its own copy when it shares the computation
+    if (rank == 0 && master_share) {
+        worker_circulars = master_circulars;
+        worker_times = master_times;
+    }
+
     if (rank < num_procs) {
         // I'm the worker
 
@@ -220,7 +437,7 @@ FunctionsMPI::scatterBasicData(const BasicData & send, BasicData & recv, int num
 
         // Create stations
         Stations stations;
-        int sub_total = Functions::getSubTotal(num_stations, num_procs, rank);
+        int sub_total = getStationCount(num_stations, num_procs, rank, master_share);
         for (int i = 0; i < sub_total; ++i) stations.push_back(Station(i, i));
 
         // Create times
@@ -241,65 +458,51 @@ FunctionsMPI::scatterBasicData(const BasicData & send, BasicData & recv, int num
 }
 
 void
-FunctionsMPI::scatterArray(const Array4D & send, Array4D & recv, int num_procs, int rank, Verbose verbose) {
+FunctionsMPI::scatterArray(const Array4D & send, Array4D & recv, int num_procs, int rank, Verbose verbose, bool master_share) {
 
     /*
      * Arrays will be scattered along the station dimension
      */
 
     if (rank == 0) {
-        Array4DPointer array_subset;
 
-        char err_buffer[MPI_MAX_ERROR_STRING];
-        int err_len;
+        const Array4D * values = &send;
+        Array4DPointer values_copy;
 
-        size_t num_total_stations = send.shape()[1];
+        // Values of a view are not contiguous, so they are copied once
+        if (dynamic_cast<const Array4DPointer *>(&send) == nullptr) {
+            vector<size_t> all_dim0(send.shape()[0]), all_dim1(send.shape()[1]);
+            vector<size_t> all_dim2(send.shape()[2]), all_dim3(send.shape()[3]);
 
-        vector<size_t> all_parameters(send.shape()[0]);
-        vector<size_t> subset_stations;
-        vector<size_t> all_times(send.shape()[2]);
-        vector<size_t> all_flts(send.shape()[3]);
+            iota(all_dim0.begin(), all_dim0.end(), 0);
+            iota(all_dim1.begin(), all_dim1.end(), 0);
+            iota(all_dim2.begin(), all_dim2.end(), 0);
+            iota(all_dim3.begin(), all_dim3.end(), 0);
 
-        // The master rank will broadcast all dimensions except for the station dimension
-        iota(all_parameters.begin(), all_parameters.end(), 0);
-        iota(all_times.begin(), all_times.end(), 0);
-        iota(all_flts.begin(), all_flts.end(), 0);
-        
-        for (int worker_rank = 1; worker_rank < num_procs; ++worker_rank) {
-
-            // Determine which stations to send to this worker process
-            int worker_station_start = Functions::getStartIndex(num_total_stations, num_procs, worker_rank);
-            int worker_stations_count = Functions::getSubTotal(num_total_stations, num_procs, worker_rank);
-
-            subset_stations.resize(worker_stations_count);
-            iota(subset_stations.begin(), subset_stations.end(), worker_station_start);
-
-            // Subset array for this woker process
-            if (verbose >= Verbose::Debug) cout << "Master subseting array along the station dimension for worker #" << worker_rank << "..." << endl;
-            send.subset(all_parameters, subset_stations, all_times, all_flts, array_subset);
+            if (verbose >= Verbose::Debug) cout << "Master copying array values from a view ..." << endl;
+            send.subset(all_dim0, all_dim1, all_dim2, all_dim3, values_copy);
+            values = &values_copy;
+        }
 
-            // Send data
-            if (verbose >= Verbose::Detail) cout << "Master sending a subset of array [station start: "
-                << worker_station_start << " count: " << worker_stations_count << "] to worker #" << worker_rank << "..." << endl;
+        double * master_block = nullptr;
+        if (master_share) {
+            if (recv.num_elements() == 0) throw runtime_error("(FunctionsMPI::scatterArray) Master process is keeping array data without allocating memory");
+            master_block = recv.getValuesPtr();
+        }
 
-            double *data_ptr = array_subset.getValuesPtr();
-            int err = MPI_Send(data_ptr, array_subset.num_elements(), MPI_DOUBLE, worker_rank, MPI_TAG_ARR, MPI_COMM_WORLD);
+        vector<size_t> shape(values->shape(), values->shape() + 4);
+        sendStationBlocks_(values->getValuesPtr(), shape, 1, MPI_TAG_ARR, num_procs, verbose, master_block);
 
-            if (err != MPI_SUCCESS) {
-                MPI_Error_string(err, err_buffer, &err_len);
-                throw runtime_error(string("Master failed to send array data to worker #") + to_string(worker_rank) + string(". MPI error: ") + string(err_buffer));
-            }
-        }
     } else if (rank < num_procs) {
 
-        // I need to make sure no numeric overflow when narrowing a size_t to an int
-        int count = boost::numeric_cast<int>(recv.num_elements());
-        if (count == 0) throw runtime_error("(FunctionsMPI::scatterArray) A worker process is receiving array data without allocating memory");
+        if (recv.num_elements() == 0) throw runtime_error("(FunctionsMPI::scatterArray) A worker process is receiving array data without allocating memory");
 
+        vector<size_t> shape(recv.shape(), recv.shape() + 4);
         double *data_ptr = recv.getValuesPtr();
+
         if (verbose >= Verbose::Debug) cout << "Worker #" << rank << " waiting for array data from master ..." << endl;
-        MPI_Recv(data_ptr, count, MPI_DOUBLE, 0, MPI_TAG_ARR, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-        if (verbose >= Verbose::Debug) cout << "Worker #" << rank << " received array data from master: " << Functions::format(data_ptr, count) << endl;
+        recvStationBlock_(data_ptr, shape, 1, MPI_TAG_ARR);
+        if (verbose >= Verbose::Debug) cout << "Worker #" << rank << " received array data from master: " << Functions::format(data_ptr, recv.num_elements()) << endl;
     
     } else {
         if (verbose >= Verbose::Debug) cout << "Worker #" << rank << " is doing nothing because too many process have been created!" << endl;
@@ -361,63 +564,72 @@ FunctionsMPI::broadcastVector(const vector<bool> & send, vector<bool> & recv, in
 }
 
 void
-FunctionsMPI::gatherArray(Array4D & arr, int station_dim_index, int num_procs, int rank, Verbose verbose) {
+FunctionsMPI::gatherArray(Array4D & arr, int station_dim_index, int num_procs, int rank, Verbose verbose, const Array4D * master_block) {
+
+    vector<size_t> shape(arr.shape(), arr.shape() + 4);
 
     if (rank == 0) {
 
-        vector<size_t> subset_dim(arr.shape(), arr.shape() + 4);
-        vector<size_t> subset_dim_end(subset_dim);
-        vector<size_t> subset_dim_start(4, 0);
+        if (arr.num_elements() == 0) throw runtime_error("(FunctionsMPI::gatherArray) Master process is trying to receive array without allocating memory");
 
-        int num_total_stations = arr.shape()[station_dim_index];
+        size_t num_total_stations = shape[station_dim_index];
 
-        if (arr.num_elements() == 0) throw runtime_error("(FunctionsMPI::gatherArray) Master process is trying to receive array without allocating memory");
+        size_t inner = 1;
+        for (int dim_i = 0; dim_i < station_dim_index; ++dim_i) inner *= shape[dim_i];
+
+        // I'm the master process. I post receives from all workers directly into the array.
+        double *data_ptr = arr.getValuesPtr();
+        vector<MPI_Request> requests(num_procs - 1);
+        vector<MPI_Datatype> types(num_procs - 1);
+
+        bool master_share = (master_block != nullptr);
+
+        if (master_share) {
+            size_t master_stations_count = getStationCount(num_total_stations, num_procs, 0, true);
+            if (master_block->shape()[station_dim_index] != master_stations_count) throw runtime_error(
+                    "(FunctionsMPI::gatherArray) The master block has an unexpected number of stations");
+
+            copyStationBlock_(master_block->getValuesPtr(), master_stations_count, 0, data_ptr, num_total_stations, 0,
+                    shape, station_dim_index, master_stations_count);
+        }
 
-        // I'm the master process. I receive data from workers.
         for (int worker_rank = 1; worker_rank < num_procs; ++worker_rank) {
-            if (verbose >= Verbose::Detail) cout << "Master receiving a subset of array from worker #" << worker_rank << " ..." << endl;
 
-            // Determine which stations to send to this worker process
-            int worker_station_start = Functions::getStartIndex(num_total_stations, num_procs, worker_rank);
-            int worker_stations_count = Functions::getSubTotal(num_total_stations, num_procs, worker_rank);
-
-            // Determine the start of station index
-            subset_dim[station_dim_index] = worker_stations_count;
-            subset_dim_start[station_dim_index] = worker_station_start;
-            subset_dim_end[station_dim_index] = worker_station_start + worker_stations_count;
-
-            // Calculate how many values to be expected
-            int subset_values_count = subset_dim[0] * subset_dim[1] * subset_dim[2] * subset_dim[3];
-
-            // Receive data from worker process
-            double *data_ptr = new double[subset_values_count];
-            MPI_Recv(data_ptr, subset_values_count, MPI_DOUBLE, worker_rank, MPI_TAG_ARR, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-            if (verbose >= Verbose::Debug) cout << "Master received (" << Functions::format(subset_dim)
-                << ") array values from worker #" << worker_rank << " starting from station " << worker_station_start << ": "
-                    << Functions::format(data_ptr, subset_values_count) << endl;
-            int ptr_i = 0;
-
-            for (size_t dim3_i = subset_dim_start[3]; dim3_i < subset_dim_end[3]; ++dim3_i)
-                for (size_t dim2_i = subset_dim_start[2]; dim2_i < subset_dim_end[2]; ++dim2_i)
-                    for (size_t dim1_i = subset_dim_start[1]; dim1_i < subset_dim_end[1]; ++dim1_i)
-                        for (size_t dim0_i = subset_dim_start[0]; dim0_i < subset_dim_end[0]; ++dim0_i, ++ptr_i)
-                            arr.setValue(data_ptr[ptr_i], dim0_i, dim1_i, dim2_i, dim3_i);
-
-            delete [] data_ptr;
+            // Determine which stations to receive from this worker process
+            size_t worker_station_start = getStationStart(num_total_stations, num_procs, worker_rank, master_share);
+            size_t worker_stations_count = getStationCount(num_total_stations, num_procs, worker_rank, master_share);
+
+            if (verbose >= Verbose::Detail) cout << "Master receiving a subset of array [station start: "
+                << worker_station_start << " count: " << worker_stations_count << "] from worker #" << worker_rank << " ..." << endl;
+
+            types[worker_rank - 1] = createStationBlockType_(shape, station_dim_index, worker_stations_count);
+            MPI_Irecv(data_ptr + worker_station_start * inner, 1, types[worker_rank - 1],
+                    worker_rank, MPI_TAG_ARR, MPI_COMM_WORLD, &requests[worker_rank - 1]);
+        }
+
+        int err = MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+        for (auto & type : types) MPI_Type_free(&type);
+
+        if (err != MPI_SUCCESS) {
+            char err_buffer[MPI_MAX_ERROR_STRING];
+            int err_len;
+            MPI_Error_string(err, err_buffer, &err_len);
+            throw runtime_error(string("Master failed to receive data from workers. MPI error: ") + string(err_buffer));
         }
 
+        if (verbose >= Verbose::Debug) cout << "Master received (" << Functions::format(shape) << ") array values from workers: "
+            << Functions::format(data_ptr, arr.num_elements()) << endl;
+
     } else if (rank < num_procs) {
 
         // I'm the worker process. I send data to the master.
         int err_len;
 
-        double * data_ptr = arr.getValuesPtr();
-
-        // I need to make sure no numeric overflow when narrowing a size_t to an int
-        int count = boost::numeric_cast<int>(arr.num_elements());
+        MPI_Datatype type = createStationBlockType_(shape, station_dim_index, shape[station_dim_index]);
 
-        if (verbose >= Verbose::Debug) cout << "Worker #" << rank << " sending " << count << " array values to master ..." << endl;
-        int err = MPI_Send(data_ptr, count, MPI_DOUBLE, 0, MPI_TAG_ARR, MPI_COMM_WORLD);
+        if (verbose >= Verbose::Debug) cout << "Worker #" << rank << " sending " << arr.num_elements() << " array values to master ..." << endl;
+        int err = MPI_Send(arr.getValuesPtr(), 1, type, 0, MPI_TAG_ARR, MPI_COMM_WORLD);
+        MPI_Type_free(&type);
 
         if (err != MPI_SUCCESS) {
             char err_buffer[MPI_MAX_ERROR_STRING];
@@ -431,3 +643,182 @@ FunctionsMPI::gatherArray(Array4D & arr, int station_dim_index, int num_procs, i
 
     return;
 }
+
+void
+FunctionsMPI::sendStations(const double * data_ptr, const vector<size_t> & shape, size_t station_dim,
+        size_t station_start, size_t station_count, int dest, int tag) {
+
+    size_t inner = 1;
+    for (size_t dim_i = 0; dim_i < station_dim; ++dim_i) inner *= shape[dim_i];
+
+    MPI_Datatype type = createStationBlockType_(shape, station_dim, station_count);
+    int err = MPI_Send(data_ptr + station_start * inner, 1, type, dest, tag, MPI_COMM_WORLD);
+    MPI_Type_free(&type);
+
+    if (err != MPI_SUCCESS) {
+        char err_buffer[MPI_MAX_ERROR_STRING];
+        int err_len;
+        MPI_Error_string(err, err_buffer, &err_len);
+        throw runtime_error(string("Failed to send stations to rank #") + to_string(dest) + string(". MPI error: ") + string(err_buffer));
+    }
+
+    return;
+}
+
+void
+FunctionsMPI::recvStations(double * data_ptr, const vector<size_t> & shape, size_t station_dim,
+        size_t station_start, size_t station_count, int source, int tag) {
+
+    size_t inner = 1;
+    for (size_t dim_i = 0; dim_i < station_dim; ++dim_i) inner *= shape[dim_i];
+
+    MPI_Datatype type = createStationBlockType_(shape, station_dim, station_count);
+    int err = MPI_Recv(data_ptr + station_start * inner, 1, type, source, tag, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    MPI_Type_free(&type);
+
+    if (err != MPI_SUCCESS) {
+        char err_buffer[MPI_MAX_ERROR_STRING];
+        int err_len;
+        MPI_Error_string(err, err_buffer, &err_len);
+        throw runtime_error(string("Failed to receive stations from rank #") + to_string(source) + string(". MPI error: ") + string(err_buffer));
+    }
+
+    return;
+}
+
+void
+FunctionsMPI::checkWorkerStations(const Forecasts & forecasts, const Observations & observations, int num_procs, int rank, Verbose verbose) {
+
+    unsigned long num_total_stations;
+    if (rank == 0) num_total_stations = forecasts.getStations().size();
+    MPI_Bcast(&num_total_stations, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+
+    ostringstream msg;
+
+    if (rank > 0 && rank < num_procs) {
+        size_t num_stations = Functions::getSubTotal(num_total_stations, num_procs, rank);
+
+        if (forecasts.getStations().size() != num_stations || observations.getStations().size() != num_stations) {
+            msg << "Worker #" << rank << " should have " << num_stations << " stations from #"
+                << Functions::getStartIndex(num_total_stations, num_procs, rank) << " but it has "
+                << forecasts.getStations().size() << " forecast stations and "
+                << observations.getStations().size() << " observation stations";
+        } else if (verbose >= Verbose::Debug) {
+            cout << "Worker #" << rank << " uses its own " << num_stations << " stations" << endl;
+        }
+    }
+
+    // All processes throw if any worker has wrong stations, because the
+    // master and the other workers would otherwise wait for it forever.
+    int failed = !msg.str().empty(), any_failed;
+    MPI_Allreduce(&failed, &any_failed, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
+
+    if (failed) throw runtime_error(msg.str());
+    if (any_failed) throw runtime_error("Process #" + to_string(rank) + " stopped because some workers do not have their own stations");
+
+    return;
+}
+
+void
+FunctionsMPI::scatterNeighbors(const Neighbors & send, Neighbors & recv, int num_procs, int rank, Verbose verbose) {
+
+    int world_size;
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+    vector<int> station_counts(world_size, 0), station_displs(world_size, 0);
+    vector<int> index_counts(world_size, 0), index_displs(world_size, 0);
+    vector<uint32_t> neighbor_counts;
+
+    if (rank == 0) {
+        if (verbose >= Verbose::Debug) cout << "Master scattering neighbors ..." << endl;
+
+        size_t num_total_stations = send.size();
+        neighbor_counts.resize(num_total_stations);
+        for (size_t station_i = 0; station_i < num_total_stations; ++station_i) neighbor_counts[station_i] = send.count(station_i);
+
+        for (int worker_rank = 1; worker_rank < num_procs; ++worker_rank) {
+            int worker_station_start = Functions::getStartIndex(num_total_stations, num_procs, worker_rank);
+            int worker_station_end = Functions::getEndIndex(num_total_stations, num_procs, worker_rank);
+
+            station_counts[worker_rank] = worker_station_end - worker_station_start;
+            station_displs[worker_rank] = worker_station_start;
+            index_counts[worker_rank] = boost::numeric_cast<int>(send.offsets[worker_station_end] - send.offsets[worker_station_start]);
+            index_displs[worker_rank] = boost::numeric_cast<int>(send.offsets[worker_station_start]);
+        }
+    }
+
+    // Scatter the number of neighbors of each station
+    int num_stations;
+    MPI_Scatter(station_counts.data(), 1, MPI_INT, &num_stations, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    vector<uint32_t> recv_counts(num_stations);
+    MPI_Scatterv(neighbor_counts.data(), station_counts.data(), station_displs.data(), MPI_UINT32_T,
+            recv_counts.data(), num_stations, MPI_UINT32_T, 0, MPI_COMM_WORLD);
+
+    // Scatter the neighbors
+    Neighbors neighbors;
+    neighbors.offsets.resize(num_stations + 1, 0);
+    partial_sum(recv_counts.begin(), recv_counts.end(), neighbors.offsets.begin() + 1);
+    neighbors.indices.resize(neighbors.offsets.back());
+
+    MPI_Scatterv(send.indices.data(), index_counts.data(), index_displs.data(), MPI_UINT32_T,
+            neighbors.indices.data(), boost::numeric_cast<int>(neighbors.indices.size()), MPI_UINT32_T, 0, MPI_COMM_WORLD);
+
+    // The master keeps all neighbors in the input
+    if (rank != 0) {
+        recv = std::move(neighbors);
+        if (verbose >= Verbose::Debug) cout << "Worker #" << rank << " received neighbors of " << recv.size() << " stations" << endl;
+    }
+
+    return;
+}
+
+void
+FunctionsMPI::exchangeHalo(const Forecasts & local, Forecasts & extended, size_t num_total_stations,
+        const vector<size_t> & halo, int num_procs, int rank, Verbose verbose) {
+
+    if (rank > 0 && rank < num_procs) {
+
+        // Own stations are followed by halo stations
+        size_t num_local = local.getStations().size();
+        Stations stations;
+        for (size_t i = 0; i < num_local + halo.size(); ++i) stations.push_back(Station(i, i));
+
+        extended.setDimensions(local.getParameters(), stations, local.getTimes(), local.getFLTs());
+
+        exchangeStations_(local.getValuesPtr(), extended.getValuesPtr(), local.getParameters().size(),
+                local.getTimes().size() * local.getFLTs().size(), num_local, num_total_stations,
+                halo, num_procs, rank, verbose);
+
+    } else {
+        if (!halo.empty()) throw runtime_error("(FunctionsMPI::exchangeHalo) Only workers can request halo stations");
+        exchangeStations_(nullptr, nullptr, 0, 0, 0, num_total_stations, halo, num_procs, rank, verbose);
+    }
+
+    return;
+}
+
+void
+FunctionsMPI::exchangeHalo(const Observations & local, Observations & extended, size_t num_total_stations,
+        const vector<size_t> & halo, int num_procs, int rank, Verbose verbose) {
+
+    if (rank > 0 && rank < num_procs) {
+
+        // Own stations are followed by halo stations
+        size_t num_local = local.getStations().size();
+        Stations stations;
+        for (size_t i = 0; i < num_local + halo.size(); ++i) stations.push_back(Station(i, i));
+
+        extended.setDimensions(local.getParameters(), stations, local.getTimes());
+
+        exchangeStations_(local.getValuesPtr(), extended.getValuesPtr(), local.getParameters().size(),
+                local.getTimes().size(), num_local, num_total_stations,
+                halo, num_procs, rank, verbose);
+
+    } else {
+        if (!halo.empty()) throw runtime_error("(FunctionsMPI::exchangeHalo) Only workers can request halo stations");
+        exchangeStations_(nullptr, nullptr, 0, 0, 0, num_total_stations, halo, num_procs, rank, verbose);
+    }
+
+    return;
+}
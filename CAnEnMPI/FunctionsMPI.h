@@ -13,21 +13,88 @@
 #include <mpi.h>
 
 #include "AnEnIS.h"
+#include "Neighbors.h"
 #include "Forecasts.h"
 #include "Observations.h"
 
 namespace FunctionsMPI {
 
-    void effective_num_procs(MPI_Comm comm, int *num_procs, int world_rank, const Forecasts & forecasts, Verbose verbose);
-    void scatterObservations(const Observations & send, Observations & recv, int num_procs, int rank, Verbose verbose);
-    void scatterForecasts(const Forecasts & send, Forecasts & recv, int num_procs, int rank, Verbose verbose);
-    void scatterBasicData(const BasicData & send, BasicData & recv, int num_procs, int rank, Verbose verbose);
-    void scatterArray(const Array4D & send, Array4D & recv, int num_procs, int rank, Verbose verbose);
+    /*
+     * When the master shares the computation (master_share), the master also
+     * owns a block of stations and receives its own block in scatter functions.
+     * Otherwise, only workers own stations.
+     */
+    void effective_num_procs(MPI_Comm comm, int *num_procs, int world_rank, const Forecasts & forecasts, Verbose verbose, bool master_share = false);
+    void scatterObservations(const Observations & send, Observations & recv, int num_procs, int rank, Verbose verbose, bool master_share = false);
+    void scatterForecasts(const Forecasts & send, Forecasts & recv, int num_procs, int rank, Verbose verbose, bool master_share = false);
+    void scatterBasicData(const BasicData & send, BasicData & recv, int num_procs, int rank, Verbose verbose, bool master_share = false);
+    void scatterArray(const Array4D & send, Array4D & recv, int num_procs, int rank, Verbose verbose, bool master_share = false);
+
+    /**
+     * Stations are partitioned into contiguous blocks in the order of ranks.
+     * The master owns the first block only if it shares the computation.
+     */
+    std::size_t getStationStart(std::size_t num_total_stations, int num_procs, int rank, bool master_share = false);
+    std::size_t getStationCount(std::size_t num_total_stations, int num_procs, int rank, bool master_share = false);
 
     void broadcastVector(const std::vector<std::size_t> & send, std::vector<std::size_t> & recv, int rank, Verbose verbose);
     void broadcastVector(const std::vector<bool> & send, std::vector<bool> & recv, int rank, Verbose verbose);
 
-    void gatherArray(Array4D & arr, int station_dim_index, int num_procs, int rank, Verbose verbose);
+    /**
+     * Gathers arrays from workers to the master along the station dimension.
+     * The master array should have been allocated for all stations.
+     * @param master_block Results of the master's own stations if the master
+     * shares the computation
+     */
+    void gatherArray(Array4D & arr, int station_dim_index, int num_procs, int rank, Verbose verbose,
+            const Array4D * master_block = nullptr);
+
+    /**
+     * Sends or receives a block of stations of a column-major array with a
+     * derived datatype, e.g. for point-to-point transfers between the master
+     * and a worker during dynamic load balancing.
+     * @param shape Shape of the array
+     * @param station_dim The station dimension
+     * @param station_start The first station of the block in the array
+     * @param station_count The number of stations in the block
+     */
+    void sendStations(const double * data_ptr, const std::vector<std::size_t> & shape, std::size_t station_dim,
+            std::size_t station_start, std::size_t station_count, int dest, int tag);
+    void recvStations(double * data_ptr, const std::vector<std::size_t> & shape, std::size_t station_dim,
+            std::size_t station_start, std::size_t station_count, int source, int tag);
+
+    /**
+     * Checks whether each worker holds its own stations when forecasts and
+     * observations have been read by each process instead of being scattered.
+     * Workers should have the stations that would have been scattered to them.
+     * This is collective. If any worker has wrong stations, all processes throw.
+     */
+    void checkWorkerStations(const Forecasts & forecasts, const Observations & observations, int num_procs, int rank, Verbose verbose);
+
+    /**
+     * Scatters neighbors by stations. Each worker receives the neighbors of
+     * its own stations with global station indices. Distances are not sent.
+     */
+    void scatterNeighbors(const Neighbors & send, Neighbors & recv, int num_procs, int rank, Verbose verbose);
+
+    /**
+     * Exchanges halo stations between workers. Each worker owns the stations
+     * scattered to it and requests the halo stations, in global station
+     * indices, from their owners. The extended data have own stations first,
+     * followed by halo stations in the same order as the halo indices.
+     *
+     * This is collective. All processes should call it. The master and idle
+     * processes do not own stations and should pass an empty halo.
+     *
+     * @param local Data of own stations
+     * @param extended Data of own and halo stations
+     * @param num_total_stations The total number of stations of all processes
+     * @param halo Sorted and unique global indices of halo stations
+     */
+    void exchangeHalo(const Forecasts & local, Forecasts & extended, std::size_t num_total_stations,
+            const std::vector<std::size_t> & halo, int num_procs, int rank, Verbose verbose);
+    void exchangeHalo(const Observations & local, Observations & extended, std::size_t num_total_stations,
+            const std::vector<std::size_t> & halo, int num_procs, int rank, Verbose verbose);
 };
 
 #endif /* FUNCTIONSMPI_H */
@@ -0,0 +1,144 @@
+/*
+ * File:   anen_concat.cpp
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+/** @file */
+
+// Needed for ifstream
+#include <fstream>
+#include <sstream>
+
+#include "boost/program_options.hpp"
+#include "boost/filesystem.hpp"
+
+#include "Config.h"
+#include "Profiler.h"
+#include "Functions.h"
+#include "AnEnWriteNcdf.h"
+
+using namespace std;
+using namespace boost::program_options;
+
+
+void runAnEnConcat(
+        const string & out_file,
+        const vector<string> & part_files,
+        Verbose verbose,
+        bool remove_parts,
+        bool profile) {
+
+    Profiler profiler;
+    profiler.start();
+
+    AnEnWriteNcdf anen_write(verbose);
+    anen_write.concatAnEnParts(out_file, part_files);
+    profiler.log_time_session("Concatenating parts");
+
+    if (remove_parts) {
+        for (const auto & part_file : part_files) boost::filesystem::remove(part_file);
+        profiler.log_time_session("Removing parts");
+    }
+
+    if (profile) profiler.summary(cout);
+
+    return;
+}
+
+
+int main(int argc, char** argv) {
+
+#ifdef NDEBUG
+    try {
+#endif
+
+    // Initialization
+    string out_file;
+    vector<string> config_files, part_files;
+    bool remove_parts, profile;
+    int verbose;
+
+    // Set up arguments
+    options_description desc("Available options");
+    desc.add_options()
+            ("help,h", "Print help information for options.")
+            ("config,c", value< vector<string> >(&config_files)->multitoken(), "Config files (.cfg). Command line options overwrite config files.")
+
+            ("out", value<string>(&out_file)->required(), "The output file created by anen_grib_mpi with --write-parts")
+            ("parts", value< vector<string> >(&part_files)->multitoken()->required(), "Part files to concatenate in any order")
+
+            ("remove-parts", bool_switch(&remove_parts)->default_value(false), "[Optional] Remove part files after concatenation")
+            ("profile", bool_switch(&profile)->default_value(false), "[Optional] Print profiler's report.")
+            ("verbose,v", value<int>(&verbose)->default_value(2), "[Optional] Verbose level (0 - 4)");
+
+    // Get all the available options
+    vector<string> available_options;
+    auto lambda = [&available_options](const boost::shared_ptr<boost::program_options::option_description> option) {
+        available_options.push_back("--" + option->long_name());
+    };
+    for_each(desc.options().begin(), desc.options().end(), lambda);
+
+    // Parse the command line first
+    variables_map vm;
+    parsed_options parsed = command_line_parser(argc, argv).options(desc).allow_unregistered().run();
+    store(parsed, vm);
+
+    if (vm.count("help") || argc == 1) {
+        // If help messages are requested or there are
+        // no extra arguments other than the command line itself
+        //
+        cout << "Parallel Analogs Ensemble -- anen_concat " << _APPVERSION << endl << _COPYRIGHT_MSG << endl << endl
+                << "Concatenates part files written by each process of anen_grib_mpi with --write-parts" << endl
+                << "into the output file. Parts are read one at a time to bound the memory usage." << endl << endl
+                << desc << endl;
+        return 0;
+    }
+
+    // Collect unregistered arguments and guess the intended options
+    auto unregistered_keys = collect_unrecognized(parsed.options, exclude_positional);
+    if (unregistered_keys.size() != 0) {
+        Functions::guess_arguments(unregistered_keys, available_options, cerr);
+        return 1;
+    }
+
+    // Then parse the configuration file
+    if (vm.count("config")) {
+        // If configuration file is specified, read it first.
+        // The variable won't be written until we call notify.
+        //
+        config_files = vm["config"].as< vector<string> >();
+    }
+
+    if (!config_files.empty()) {
+        for (const auto & config_file : config_files) {
+            ifstream ifs(config_file.c_str());
+            if (!ifs) {
+                cerr << "Error: Can't open configuration file " << config_file << endl;
+                return 1;
+            } else {
+                auto parsed_config = parse_config_file(ifs, desc, true);
+
+                auto unregistered_keys_config = collect_unrecognized(parsed_config.options, exclude_positional);
+                if (unregistered_keys_config.size() != 0) {
+                    Functions::guess_arguments(unregistered_keys_config, available_options, cout);
+                    return 1;
+                }
+
+                store(parsed_config, vm);
+            }
+        }
+    }
+
+    notify(vm);
+
+    runAnEnConcat(out_file, part_files, Functions::itov(verbose), remove_parts, profile);
+
+#ifdef NDEBUG
+    } catch (exception & e) {
+        cerr << "Caught error: " << e.what() << endl << "Program is terminated!" << endl;
+        return 1;
+    }
+#endif
+
+    return 0;
+}
@@ -24,6 +24,7 @@
 #if defined(_USE_MPI_EXTENSION)
 #include "AnEnReadGribMPI.h"
 #include "AnEnISMPI.h"
+#include "AnEnSSEMPI.h"
 #else 
 #include "AnEnReadGrib.h"
 #endif
@@ -32,6 +33,245 @@
 using namespace std;
 using namespace boost::program_options;
 
+#if defined(_USE_MPI_EXTENSION)
+/**
+ * Writes results of the stations of this process into a part file next to
+ * the output file, e.g. out.part3.nc for rank 3. This should be called by
+ * all processes. Names of the written parts are collected on the master.
+ */
+void writeParts(const AnEnISMPI & anen, const string & fileout, const Ncdf::Storage & storage,
+        Verbose verbose, bool overwrite, vector<string> & part_files) {
+
+    int world_rank, world_size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+    auto part_name = [&fileout](int rank) {
+        return fileout.substr(0, fileout.rfind('.')) + ".part" + to_string(rank) + ".nc";
+    };
+
+    int has_part = (anen.getStationCount() > 0);
+
+    if (has_part) {
+        AnEnWriteNcdf anen_write(verbose);
+        anen_write.setStorage(storage);
+        anen_write.writeAnEnPart(part_name(world_rank), anen, anen.getStationStart(), overwrite);
+    }
+
+    // The master waits until all parts have been written
+    vector<int> has_parts(world_rank == 0 ? world_size : 0);
+    MPI_Gather(&has_part, 1, MPI_INT, has_parts.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    part_files.clear();
+    for (int rank = 0; rank < (int) has_parts.size(); ++rank) {
+        if (has_parts[rank]) part_files.push_back(part_name(rank));
+    }
+
+    return;
+}
+#endif
+
+/**
+ * Computes the fingerprint of a run from the inputs and settings that change
+ * results. A run is only resumed with the same fingerprint.
+ */
+string runFingerprint(
+        const vector<string> & forecast_files,
+        const vector<string> & analysis_files,
+        const vector<ParameterGrib> & grib_parameters,
+        const Forecasts & forecasts,
+        const Times & test_times,
+        const Times & search_times,
+        const vector<size_t> & obs_id,
+        Config config,
+        const Ncdf::Storage & storage) {
+
+    ostringstream description;
+
+    // Verbosity does not change results
+    config.verbose = Verbose::Progress;
+    config.print(description);
+
+    vector<string> parameter_names;
+    forecasts.getParameters().getNames(parameter_names);
+
+    description << "parameters: " << Functions::format(parameter_names) << endl
+            << "obs_id: " << Functions::format(obs_id) << endl
+            << "significant_digits: " << storage.significant_digits << endl;
+
+    // Parameters are located in GRIB files by the ID, the level, and the type of level
+    description << "grib_parameters:";
+    for (const auto & parameter : grib_parameters) description << " " << parameter.getName() << ","
+            << parameter.getId() << "," << parameter.getLevel() << "," << parameter.getLevelType();
+
+    description << endl << "stations:";
+    for (const auto & station : forecasts.getStations().left) description << " " << station.second.getX() << "," << station.second.getY();
+    description << endl << "flts:";
+    for (const auto & time : forecasts.getFLTs().left) description << " " << time.second.timestamp;
+    description << endl << "test_times:";
+    for (const auto & time : test_times.left) description << " " << time.second.timestamp;
+    description << endl << "search_times:";
+    for (const auto & time : search_times.left) description << " " << time.second.timestamp;
+    description << endl;
+
+    vector<string> files(forecast_files);
+    files.insert(files.end(), analysis_files.begin(), analysis_files.end());
+
+    return FunctionsIO::fingerprint(description.str(), files);
+}
+
+/**
+ * Throws on all processes if the master has failed. Otherwise, workers
+ * would wait for the master forever.
+ */
+void checkMasterError(const string & error_msg) {
+
+#if defined(_USE_MPI_EXTENSION)
+    int world_rank, failed = !error_msg.empty();
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+    MPI_Bcast(&failed, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    if (failed) {
+        if (world_rank == 0) throw runtime_error(error_msg);
+        throw runtime_error("Worker stopped because the master has failed");
+    }
+#else
+    if (!error_msg.empty()) throw runtime_error(error_msg);
+#endif
+
+    return;
+}
+
+/**
+ * Computes and writes stations in blocks so that each written block is a
+ * checkpoint. If the output file exists and resume is set, stations that
+ * have been written are skipped. This should be called by all processes.
+ * Only the master needs input files, forecasts, and observations.
+ */
+void computeBlocks(
+        const vector<string> & forecast_files,
+        const vector<string> & analysis_files,
+        const vector<ParameterGrib> & grib_parameters,
+        const Forecasts & forecasts,
+        const Observations & observations,
+        const Times & test_times,
+        const Times & search_times,
+        const vector<size_t> & obs_id,
+        const string & fileout,
+        const Config & config,
+        size_t checkpoint_stations,
+        bool resume,
+        bool overwrite,
+        const Ncdf::Storage & storage) {
+
+    AnEnWriteNcdf anen_write(config.verbose);
+    anen_write.setStorage(storage);
+
+    const Stations & stations = forecasts.getStations();
+    unsigned long num_stations = stations.size(), first_station = 0;
+    bool resuming = false;
+
+    unordered_map<string, size_t> obs_map;
+    vector<string> multi_names;
+    string fingerprint, error_msg;
+
+#if defined(_USE_MPI_EXTENSION)
+    int world_rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
+
+    if (world_rank == 0) {
+#endif
+
+    try {
+        fingerprint = runFingerprint(forecast_files, analysis_files, grib_parameters,
+                forecasts, test_times, search_times, obs_id, config, storage);
+
+        resuming = (resume && boost::filesystem::exists(fileout));
+        if (resuming) first_station = anen_write.readCheckpoint(fileout, fingerprint);
+
+        if (obs_id.size() > 1) {
+            Functions::createObsMap(obs_map, obs_id, observations.getParameters());
+            for (const auto & pair : obs_map) multi_names.push_back(pair.first);
+        }
+    } catch (exception & e) {
+        error_msg = e.what();
+    }
+
+#if defined(_USE_MPI_EXTENSION)
+    }
+#endif
+
+    checkMasterError(error_msg);
+
+#if defined(_USE_MPI_EXTENSION)
+    // Workers compute the same blocks as the master
+    unsigned long progress[2] = {first_station, num_stations};
+    MPI_Bcast(progress, 2, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+    first_station = progress[0];
+    num_stations = progress[1];
+#endif
+
+    if (first_station >= num_stations && config.verbose >= Verbose::Progress)
+        cout << "All stations have been written. Nothing to resume." << endl;
+
+    for (size_t block_start = first_station; block_start < num_stations; block_start += checkpoint_stations) {
+
+        size_t block_count = min(checkpoint_stations, num_stations - block_start);
+
+        // Workers receive stations of the block from the master
+        ForecastsPointer block_forecasts;
+        ObservationsPointer block_observations;
+
+#if defined(_USE_MPI_EXTENSION)
+        if (world_rank == 0) {
+#endif
+
+        if (config.verbose >= Verbose::Progress) cout << "Computing block with " << block_count
+                << " stations from #" << block_start << " ..." << endl;
+
+        Stations block_stations;
+        for (size_t station_i = block_start; station_i < block_start + block_count; ++station_i) {
+            block_stations.push_back(stations.getStation(station_i));
+        }
+
+        forecasts.subset(forecasts.getParameters(), block_stations, forecasts.getTimes(), forecasts.getFLTs(), block_forecasts);
+        observations.subset(observations.getParameters(), block_stations, observations.getTimes(), block_observations);
+
+#if defined(_USE_MPI_EXTENSION)
+        }
+
+        AnEnISMPI anen(config);
+#else
+        AnEnIS anen(config);
+#endif
+
+        anen.compute(block_forecasts, block_observations, test_times, search_times);
+
+#if defined(_USE_MPI_EXTENSION)
+        if (world_rank == 0) {
+#endif
+
+        // The output file is created from the first block unless it is resumed
+        try {
+            if (block_start == first_station && !resuming) anen_write.createAnEn(fileout, anen, multi_names,
+                    test_times, search_times, forecasts.getFLTs(), forecasts.getParameters(), stations,
+                    forecasts.getTimes().size(), overwrite, fingerprint);
+
+            anen_write.writeAnEnStations(fileout, anen, obs_map, block_observations, block_start);
+        } catch (exception & e) {
+            error_msg = e.what();
+        }
+
+#if defined(_USE_MPI_EXTENSION)
+        }
+#endif
+
+        checkMasterError(error_msg);
+    }
+
+    return;
+}
+
 void runAnEnGrib(
         const vector<string> & forecast_files,
         const vector<string> & analysis_files,
@@ -55,6 +295,7 @@ void runAnEnGrib(
         bool profile,
         bool save_tests,
         bool unwrap_obs,
+        bool reorder_stations,
         bool convert_wind,
         const vector<string> & u_names,
         const vector<string> & v_names,
@@ -63,7 +304,13 @@ void runAnEnGrib(
         const string & embedding_model,
         const string & similarity_model,
         long int ai_flt_radius,
-        const string & fcst_grid_file) {
+        const string & fcst_grid_file,
+        int read_threads,
+        bool grib_index,
+        bool write_parts,
+        size_t checkpoint_stations,
+        bool resume,
+        const Ncdf::Storage & storage) {
 
 
     /**************************************************************************
@@ -119,6 +366,24 @@ void runAnEnGrib(
     if (test_start > test_end) throw runtime_error("Test start cannot be later than test end");
     if (search_start > search_end) throw runtime_error("Search start cannot be later than search end");
 
+    // Part files are only written by AnEnISMPI for univariate analogs in the original station order
+    if (write_parts) {
+        if (algorithm != "IS") throw runtime_error("Part files are only supported for IS");
+        if (obs_id.size() > 1) throw runtime_error("Part files are not supported for multivariate analogs");
+        if (reorder_stations) throw runtime_error("Part files cannot be used with reordered stations");
+    }
+
+    // Blocks are written in the original station order by the master
+    if (checkpoint_stations > 0) {
+        if (algorithm != "IS") throw runtime_error("--checkpoint-stations only supports the algorithm IS");
+        if (write_parts) throw runtime_error("--checkpoint-stations cannot be used with --write-parts");
+        if (reorder_stations) throw runtime_error("--checkpoint-stations cannot be used with --reorder-stations");
+        if (save_tests) throw runtime_error("--checkpoint-stations cannot be used with --save-tests");
+        if (!embedding_model.empty() || !similarity_model.empty()) throw runtime_error("--checkpoint-stations cannot be used with AI models");
+    }
+
+    if (resume && checkpoint_stations == 0) throw runtime_error("--resume requires --checkpoint-stations");
+
     if (!test_times_str.empty())
         if (test_times.size() != test_times_str.size())
             throw runtime_error("Duplicates found in test times");
@@ -136,9 +401,11 @@ void runAnEnGrib(
 
     AnEnReadGribMPI anen_read(config.verbose, config.worker_verbose);
 #else
-    AnEnReadGrib anen_read(config.verbose);
+    AnEnReadGrib anen_read(config.verbose, read_threads);
 #endif
 
+    anen_read.setIndex(grib_index);
+
     // Note that the backup forecasts are only used when forecasts are transformed by AI and save_test is true
     ForecastsPointer forecasts, forecasts_backup;
 
@@ -219,6 +486,33 @@ void runAnEnGrib(
 #endif
 
 
+    /*
+     * Reorder stations along a space-filling curve so that nearby stations
+     * are close in memory and each MPI worker receives a compact region.
+     * Forecasts and observations share the same stations.
+     */
+    vector<size_t> stations_order, stations_position;
+
+#if defined(_USE_MPI_EXTENSION)
+    if (reorder_stations && world_rank == 0) {
+#else
+    if (reorder_stations) {
+#endif
+
+        if (config.verbose >= Verbose::Progress) cout << "Reordering stations along a Hilbert curve ..." << endl;
+
+        Functions::spaceFillingOrder(forecasts.getStations(), stations_order);
+        Functions::reorderStations(forecasts, stations_order);
+        Functions::reorderStations(observations, stations_order);
+
+        // The position of each original station after reordering
+        stations_position.resize(stations_order.size());
+        for (size_t i = 0; i < stations_order.size(); ++i) stations_position[stations_order[i]] = i;
+
+        profiler.log_time_session("Reordering stations");
+    }
+
+
     /**************************************************************************
      *                       Generate Analogs Ensemble                        *
      **************************************************************************/
@@ -241,23 +535,52 @@ void runAnEnGrib(
     }
 
 
+    /*
+     * Generate and write analogs in blocks for checkpoints
+     */
+    if (checkpoint_stations > 0) {
+
+#if defined(_USE_MPI_EXTENSION)
+        if (world_rank != 0) config.verbose = config.worker_verbose;
+#endif
+
+        computeBlocks(forecast_files, analysis_files, grib_parameters, forecasts, observations,
+                test_times, search_times, obs_id, fileout, config, checkpoint_stations, resume, overwrite, storage);
+
+#if defined(_USE_MPI_EXTENSION)
+        if (world_rank != 0) return;
+#endif
+
+        profiler.log_time_session("Computing and writing blocks");
+
+        if (config.verbose >= Verbose::Progress) cout << "anen_grib complete!" << endl;
+        if (profile) profiler.summary(cout);
+
+        return;
+    }
+
+
     /*
      * Generate analogs
      */
-    AnEn* anen = nullptr;
+    AnEnIS* anen = nullptr;
 
     if (algorithm == "IS") {
 #if defined(_USE_MPI_EXTENSION)
         if (world_rank != 0) config.verbose = config.worker_verbose;
-        anen = new AnEnISMPI(config);
+        AnEnISMPI *anen_mpi = new AnEnISMPI(config);
+        anen_mpi->setGatherResults(!write_parts);
+        anen = anen_mpi;
 #else
         anen = new AnEnIS(config);
 #endif
     } else if (algorithm == "SSE") {
 #if defined(_USE_MPI_EXTENSION)
-        if (config.verbose >= Verbose::Warning) cerr << "Warning: AnEnSSE is only multi-threading, no MPI supported" << endl;
-#endif
+        if (world_rank != 0) config.verbose = config.worker_verbose;
+        anen = new AnEnSSEMPI(config);
+#else
         anen = new AnEnSSE(config);
+#endif
     } else {
         throw runtime_error("The algorithm is not recognized");
     }
@@ -269,6 +592,27 @@ void runAnEnGrib(
     anen->compute(forecasts, observations, test_times, search_times);
 
 #if defined(_USE_MPI_EXTENSION)
+    /*
+     * Results are not gathered if part files are written. Each process
+     * writes its own stations in parallel, and the master concatenates
+     * parts into the output file later.
+     */
+    vector<string> part_files;
+
+    if (write_parts) {
+
+        // The output file is created first so that parts can be concatenated with anen_concat if this run stops
+        if (world_rank == 0) {
+            AnEnWriteNcdf anen_write(config.verbose);
+            anen_write.setStorage(storage);
+            anen_write.createAnEn(fileout, *anen, {}, test_times, search_times,
+                    forecasts.getFLTs(), forecasts.getParameters(), forecasts.getStations(),
+                    forecasts.getTimes().size(), overwrite);
+        }
+
+        writeParts(*static_cast<AnEnISMPI *>(anen), fileout, storage, config.verbose, overwrite, part_files);
+    }
+
     // Terminate the process if this is not a master process.
     // Subsequent parallelization is done with multi-threading.
     //
@@ -280,6 +624,15 @@ void runAnEnGrib(
 
     profiler += anen->getProfile();
 
+    // Results, forecasts, and observations are put back in the original station order
+    if (!stations_order.empty()) {
+        anen->restoreStationOrder(stations_order);
+        Functions::reorderStations(forecasts, stations_position);
+        Functions::reorderStations(observations, stations_position);
+
+        profiler.log_time_session("Restoring station order");
+    }
+
 
     /**************************************************************************
      *                             Write Results                              *
@@ -289,12 +642,26 @@ void runAnEnGrib(
      * Write AnEn results to an NetCDF file
      */
     AnEnWriteNcdf anen_write(config.verbose);
+    anen_write.setStorage(storage);
 
     const auto & forecast_flts = forecasts.getFLTs();
     const auto & forecast_parameters = forecasts.getParameters();
     const auto & forecast_stations = forecasts.getStations();
 
-    if (obs_id.size() > 1) {
+    if (write_parts) {
+
+#if defined(_USE_MPI_EXTENSION)
+        /*
+         * If parts have been written by all processes
+         */
+        anen_write.concatAnEnParts(fileout, part_files);
+
+        for (const auto & part_file : part_files) boost::filesystem::remove(part_file);
+
+        profiler.log_time_session("Concatenating univariate analogs");
+#endif
+
+    } else if (obs_id.size() > 1) {
         
         /*
          * If we are generating multivariate analogs
@@ -427,7 +794,8 @@ int main(int argc, char** argv) {
 
     string forecast_folder, analysis_folder, test_start, test_end, search_start, search_end, embedding_model, similarity_model;
     string forecast_regex, analysis_regex, fileout, algorithm, fcst_grid_file;
-    bool delimited, overwrite, profile, save_tests, unwrap_obs, convert_wind;
+    string forecast_manifest, analysis_manifest;
+    bool delimited, overwrite, profile, save_tests, unwrap_obs, reorder_stations, convert_wind;
     size_t unit_in_seconds;
     int verbose;
     long int ai_flt_radius;
@@ -437,6 +805,12 @@ int main(int argc, char** argv) {
 #endif
 
     Config config;
+    Ncdf::Storage storage;
+    int read_threads = 1;
+    bool grib_index;
+    bool write_parts = false;
+    size_t checkpoint_stations;
+    bool resume;
 
     // Define available command line parameters
     options_description desc("Available options");
@@ -447,6 +821,8 @@ int main(int argc, char** argv) {
             ("analysis-folder", value<string>(&analysis_folder)->required(), "Folder containing analysis GRIB files. Or it can be a single txt file and each line is a file path.")
             ("forecast-regex", value<string>(&forecast_regex)->required(), "Regular expression for forecast file names. The expression should have named groups for 'day', 'flt', and 'cycle'. An example is '.*nam_218_(?P<day>\\d{8})_(?P<cycle>\\d{2})\\d{2}_(?P<flt>\\d{3})\\.grb2$'")
             ("analysis-regex", value<string>(&analysis_regex)->required(), "Regular expression for analysis file names with the same format as for forecasts.")
+            ("forecast-manifest", value<string>(&forecast_manifest)->default_value(""), "[Optional] A file to cache the list of forecast files. It is reused while the forecast folder is unchanged.")
+            ("analysis-manifest", value<string>(&analysis_manifest)->default_value(""), "[Optional] A file to cache the list of analysis files. It is reused while the analysis folder is unchanged.")
             ("pars-name", value< vector<string> >(&parameters_name)->multitoken()->required(), "Parameters name.")
             ("pars-circular", value < vector<bool> >(&parameters_circular)->multitoken(), "[Optional] 1 for circular parameters and 0 for linear circulars.")
             ("pars-id", value< vector<long> >(&parameters_id)->multitoken()->required(), "Parameters ID.")
@@ -465,11 +841,19 @@ int main(int argc, char** argv) {
             ("delimited", bool_switch(&delimited)->default_value(false), "[Optional] Date strings in forecasts and analysis have separators.")
             ("overwrite", bool_switch(&overwrite)->default_value(false), "[Optional] Overwrite files and variables.")
             ("profile", bool_switch(&profile)->default_value(false), "[Optional] Print profiler's report.")
+            ("checkpoint-stations", value<size_t>(&checkpoint_stations)->default_value(0), "[Optional] Number of stations in a checkpoint. If set, stations are computed in blocks, and each block is written to the output as soon as it is computed. Only IS is supported.")
+            ("resume", bool_switch(&resume)->default_value(false), "[Optional] Resume an interrupted run with --checkpoint-stations from its output file. Inputs and settings must be the same. Only stations that have not been written are computed.")
+            ("grib-index", bool_switch(&grib_index)->default_value(false), "[Optional] Save message index files next to GRIB files and use them in later runs to read messages directly.")
             ("unit-in-seconds", value<size_t>(&unit_in_seconds)->default_value(3600), "[Optional] The number of seconds for the unit of lead times. Usually lead times have hours as unit, so it defaults to 3600.")
             ("verbose,v", value<int>(&verbose), "[Optional] Verbose level (0 - 4).")
+#if !defined(_USE_MPI_EXTENSION)
+            ("read-threads", value<int>(&read_threads)->default_value(1), "[Optional] Number of threads to decode GRIB files. Values larger than 1 require Eccodes built with thread support.")
+#endif
 
 #if defined(_USE_MPI_EXTENSION)
             ("worker-verbose", value<int>(&worker_verbose), "[Optional] Verbose level for worker processes (0 - 4).")
+            ("write-parts", bool_switch(&write_parts)->default_value(false), "[Optional] Each process writes results of its own stations into a part file in parallel, instead of gathering all results to the master. The master then concatenates parts into the output. Only IS is supported. Parts can also be concatenated with anen_concat.")
+            ("dynamic-chunks", value<size_t>(&(config.dynamic_chunks))->default_value(config.dynamic_chunks), "[Optional] Number of station chunks per worker for dynamic load balancing with IS. Workers request chunks from the master as they finish. 0 partitions stations statically.")
 #endif
 
 #if defined(_ENABLE_AI)
@@ -498,12 +882,17 @@ int main(int argc, char** argv) {
             ("save-sims-station-index", bool_switch(&(config.save_sims_station_index))->default_value(config.save_sims_station_index), "[Optional] Save station indices of similarity.")
             ("save-tests", bool_switch(&save_tests)->default_value(false), "[Optional] Save test forecasts and observations if available")
             ("unwrap-test-obs", bool_switch(&unwrap_obs)->default_value(false), "[Optional] When saving test observations (--save-tests), unwrap observation time series to align it with forecasts")
+            ("reorder-stations", bool_switch(&reorder_stations)->default_value(false), "[Optional] Reorder stations along a Hilbert curve for better memory locality and more compact MPI partitions. Results are still written in the original station order.")
             ("quick-sort", bool_switch(&(config.quick_sort))->default_value(config.quick_sort), "[Optional] Use nth_element sort. Change this in *.cfg")
             ("convert-wind", bool_switch(&(convert_wind))->default_value(false), "[Optional] Use this option if your forecasts have only wind U and V components and you need to convert them to wind speed and direction. Please also specify --name-u --name-v --name-spd --name-dir. Wind speed and direction values will be calculated internally and replacing U and V components respectively.")
             ("name-u", value< vector<string> >(&u_names)->multitoken(), "[Optional] Parameter name(s) for U component of wind")
             ("name-v", value< vector<string> >(&v_names)->multitoken(), "[Optional] Parameter name(s) for V component of wind")
             ("name-spd", value< vector<string> >(&spd_names)->multitoken(), "[Optional] Parameter name(s) for wind speed")
             ("name-dir", value< vector<string> >(&dir_names)->multitoken(), "[Optional] Parameter name(s) for wind direction")
+            ("deflate-level", value<int>(&(storage.deflate_level))->default_value(storage.deflate_level), "[Optional] Deflate level (0 - 9) for output variables. 0 turns off compression.")
+            ("shuffle", bool_switch(&(storage.shuffle))->default_value(storage.shuffle), "[Optional] Use the shuffle filter before deflate for output variables.")
+            ("significant-digits", value<int>(&(storage.significant_digits))->default_value(storage.significant_digits), "[Optional] Number of significant digits to keep for analogs and similarity with bit grooming. 0 keeps all digits. This requires NetCDF 4.9.0 or later.")
+            ("chunk-stations", value<size_t>(&(storage.chunk_stations))->default_value(storage.chunk_stations), "[Optional] Number of stations in a chunk of output variables. Other dimensions are not split. 0 uses the library default.")
             ("fcst-grid", value<string>(&fcst_grid_file), "[Optional] A grid file to be associated with forecasts. Currently only used within the spatial metric with AI.");
 
 
@@ -645,8 +1034,8 @@ int main(int argc, char** argv) {
 
     // List files from folders
     vector<string> forecast_files, analysis_files;
-    FunctionsIO::listFiles(forecast_files, forecast_folder, forecast_regex);
-    FunctionsIO::listFiles(analysis_files, analysis_folder, analysis_regex);
+    FunctionsIO::listFiles(forecast_files, forecast_folder, forecast_regex, forecast_manifest, config.verbose);
+    FunctionsIO::listFiles(analysis_files, analysis_folder, analysis_regex, analysis_manifest, config.verbose);
     
     if (forecast_files.size() == 0) throw runtime_error("No forecast files detected. Check --forecasts-folder and --forecast-regex.");
     if (analysis_files.size() == 0) throw runtime_error("No analysis files detected. Check --analysis-folder and --analysis-regex.");
@@ -665,7 +1054,8 @@ int main(int argc, char** argv) {
             forecast_regex, analysis_regex,
             obs_id, grib_parameters, stations_index, test_start, test_end, test_times_str, search_start, search_end, search_times_str,
             fileout, algorithm, config, unit_in_seconds, delimited, overwrite, profile, save_tests, unwrap_obs, 
-            convert_wind, u_names, v_names, spd_names, dir_names, embedding_model, similarity_model, ai_flt_radius, fcst_grid_file);
+            reorder_stations, convert_wind, u_names, v_names, spd_names, dir_names, embedding_model, similarity_model, ai_flt_radius, fcst_grid_file, read_threads, grib_index, write_parts,
+            checkpoint_stations, resume, storage);
 
 #if defined(_USE_MPI_EXTENSION)
     MPI_Finalize();
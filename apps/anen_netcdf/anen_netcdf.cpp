@@ -11,6 +11,9 @@
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <future>
+#include <memory>
+#include <mutex>
 
 #include "boost/filesystem/convenience.hpp"
 #include "boost/program_options.hpp"
@@ -22,15 +25,19 @@
 #include "AnEnSSEMS.h"
 #include "Profiler.h"
 #include "AnEnReadNcdf.h"
+#include "AnEnReadBinary.h"
 #include "AnEnWriteNcdf.h"
+#include "AnEnWriteNcdfQueue.h"
+#include "FunctionsIO.h"
+#include "Ncdf.h"
+#include "ForecastsView.h"
 #include "ForecastsPointer.h"
 #include "ObservationsPointer.h"
 
 #if defined(_USE_MPI_EXTENSION)
 #include <mpi.h>
-
-// Ncdf is needed when MPI is used. Ncdf is used to read the length of dimensions
-#include "Ncdf.h"
+#include "AnEnSSEMPI.h"
+#include "AnEnReadNcdfMPI.h"
 #endif
 
 
@@ -38,47 +45,16 @@ using namespace std;
 using namespace boost::program_options;
 namespace fs = boost::filesystem;
 
-void runAnEnNcdf(
-        const string & forecast_file,
-        const string & observation_file,
-        int fcst_station_start, int fcst_station_count,
-        const vector<size_t> fcst_stations_subset,
-        int obs_station_start, int obs_station_count,
-        const vector<size_t> & obs_id,
+void parseTimes(
         const string & test_start_str,
         const string & test_end_str,
         const vector<string> & test_times_str,
         const string & search_start_str,
         const string & search_end_str,
         const vector<string> & search_times_str,
-        const string & fileout,
-        const string & algorithm,
-        Config & config,
-        bool overwrite,
-        bool profile,
-        bool save_tests,
-        bool unwrap_obs,
-        bool convert_wind,
-        const vector<string> & u_names,
-        const vector<string> & v_names,
-        const vector<string> & spd_names,
-        const vector<string> & dir_names,
-        const string & embedding_model,
-        const string & similarity_model,
-        long int ai_flt_radius,
-        const string & fcst_grid_file) {
-
-
-    /**************************************************************************
-     *                     Read Forecasts and Analysis                        *
-     **************************************************************************/
-
-    Profiler profiler;
-    profiler.start();
-
-    // Create times
-    Time test_start, test_end, search_start, search_end;
-    Times test_times, search_times;
+        bool operation,
+        Time & test_start, Time & test_end, Times & test_times,
+        Time & search_start, Time & search_end, Times & search_times) {
 
     try {
 
@@ -118,7 +94,7 @@ void runAnEnNcdf(
     }
 
     // Sanity checks for input times
-    if (config.operation && test_start <= search_end) throw runtime_error("Search end must be prior to test start in operation");
+    if (operation && test_start <= search_end) throw runtime_error("Search end must be prior to test start in operation");
     if (test_start > test_end) throw runtime_error("Test start cannot be later than test end");
     if (search_start > search_end) throw runtime_error("Search start cannot be later than search end");
 
@@ -130,36 +106,144 @@ void runAnEnNcdf(
         if (search_times.size() != search_times_str.size())
             throw runtime_error("Duplicates found in search times");
 
+    return;
+}
+
+void setObsID(Config & config, const vector<size_t> & obs_id) {
+
+    if (obs_id.size() == 0) {
+        // Use the default observation ID in config, Nothing is changed.
+    } else if (obs_id.size() == 1) {
+        // Use this observation ID
+        config.obs_var_index = obs_id[0];
+    } else {
+        // We have multiple observations ID. We are generating multivariate analogs.
+        if (config.verbose >= Verbose::Progress) cout << "Multi-analogs functionality ON" << endl;
+
+        config.save_analogs = false;
+        config.save_analogs_time_index = true;
+        config.save_sims_station_index = true;
+    }
+
+    return;
+}
+
+void runAnEnNcdf(
+        const string & forecast_file,
+        const string & observation_file,
+        int fcst_station_start, int fcst_station_count,
+        const vector<size_t> fcst_stations_subset,
+        int obs_station_start, int obs_station_count,
+        const vector<size_t> & obs_id,
+        const string & test_start_str,
+        const string & test_end_str,
+        const vector<string> & test_times_str,
+        const string & search_start_str,
+        const string & search_end_str,
+        const vector<string> & search_times_str,
+        const string & fileout,
+        const string & algorithm,
+        Config & config,
+        bool overwrite,
+        bool profile,
+        bool save_tests,
+        bool unwrap_obs,
+        bool reorder_stations,
+        bool convert_wind,
+        const vector<string> & u_names,
+        const vector<string> & v_names,
+        const vector<string> & spd_names,
+        const vector<string> & dir_names,
+        const string & embedding_model,
+        const string & similarity_model,
+        long int ai_flt_radius,
+        const string & fcst_grid_file,
+        bool read_by_ranks,
+        bool gather_by_ranks,
+        const Ncdf::Storage & storage) {
+
+
+    /**************************************************************************
+     *                     Read Forecasts and Analysis                        *
+     **************************************************************************/
+
+    Profiler profiler;
+    profiler.start();
+
+    // Create times
+    Time test_start, test_end, search_start, search_end;
+    Times test_times, search_times;
+
+    parseTimes(test_start_str, test_end_str, test_times_str,
+            search_start_str, search_end_str, search_times_str, config.operation,
+            test_start, test_end, test_times, search_start, search_end, search_times);
+
 
     /*
      * Read input data
      */
 
-    // Initialize a reader
+    // Initialize readers. Files in the native binary format are memory mapped.
     AnEnReadNcdf anen_read(config.verbose);
+    AnEnReadBinary anen_read_binary(config.verbose);
 
     // Read forecasts
     ForecastsPointer forecasts, forecasts_backup;
-    anen_read.readForecasts(forecast_file, forecasts, fcst_station_start, fcst_station_count);
+    if (read_by_ranks) {
+#if defined(_USE_MPI_EXTENSION)
+        // The master only reads dimensions. Workers read their own stations.
+        AnEnReadNcdfMPI(config.verbose, config.worker_verbose).readForecasts(forecast_file, forecasts);
+#endif
+    } else if (gather_by_ranks) {
+#if defined(_USE_MPI_EXTENSION)
+        // Workers read blocks of stations in parallel and send them to the master
+        AnEnReadNcdfMPI(config.verbose, config.worker_verbose).gatherForecasts(forecast_file, forecasts);
+#endif
+    } else if (AnEnReadBinary::isBinary(forecast_file)) {
+        anen_read_binary.readForecasts(forecast_file, forecasts, fcst_station_start, fcst_station_count);
+    } else {
+        anen_read.readForecasts(forecast_file, forecasts, fcst_station_start, fcst_station_count);
+    }
 
     profiler.log_time_session("Reading forecasts");
 
+    // A view is used for the station subset when forecast values are not modified
+    ForecastsView forecasts_view;
+    bool use_view = false;
+
     if (fcst_stations_subset.size() != 0) {
 
         Stations stations_subset;
         const Stations & stations = forecasts.getStations();
         for (const auto & i : fcst_stations_subset) stations_subset.push_back(stations.getStation(i));
 
-        ForecastsPointer forecasts_subset;
-        forecasts.subset(forecasts.getParameters(), stations_subset, forecasts.getTimes(), forecasts.getFLTs(), forecasts_subset);
+        if (convert_wind || !embedding_model.empty()) {
+            ForecastsPointer forecasts_subset;
+            forecasts.subset(forecasts.getParameters(), stations_subset, forecasts.getTimes(), forecasts.getFLTs(), forecasts_subset);
+            forecasts = std::move(forecasts_subset);
+        } else {
+            forecasts_view.view(forecasts, forecasts.getParameters(), stations_subset, forecasts.getTimes(), forecasts.getFLTs());
+            use_view = true;
+        }
 
-        forecasts = forecasts_subset;
         profiler.log_time_session("Subsetting forecasts");
     }
 
     // Read observations
     ObservationsPointer observations;
-    anen_read.readObservations(observation_file, observations, obs_station_start, obs_station_count);
+    if (read_by_ranks) {
+#if defined(_USE_MPI_EXTENSION)
+        AnEnReadNcdfMPI(config.verbose, config.worker_verbose).readObservations(observation_file, observations);
+#endif
+    } else if (gather_by_ranks) {
+#if defined(_USE_MPI_EXTENSION)
+        AnEnReadNcdfMPI(config.verbose, config.worker_verbose).gatherObservations(observation_file, observations);
+#endif
+    } else if (AnEnReadBinary::isBinary(observation_file)) {
+        anen_read_binary.readObservations(observation_file, observations, obs_station_start, obs_station_count);
+    } else {
+        anen_read.readObservations(observation_file, observations, obs_station_start, obs_station_count);
+    }
 
     profiler.log_time_session("Reading observations");
 
@@ -187,6 +271,9 @@ void runAnEnNcdf(
         // Set up the grid
         if (!fcst_grid_file.empty()) forecasts.setGrid(fcst_grid_file, config.verbose);
 
+        // The backup shares values with forecasts. No values are copied because
+        // the transformation below allocates new memory for the latent features.
+        //
         if (save_tests) forecasts_backup = forecasts;
         profiler.log_time_session("Backing up original forecasts");
 
@@ -219,6 +306,46 @@ void runAnEnNcdf(
         profiler.log_time_session("Calculating wind speed/direction");
     }
 
+
+    /*
+     * Reorder stations along a space-filling curve so that nearby stations
+     * are close in memory. This is done after AI transformation because the
+     * grid refers to stations with their original indices.
+     */
+    vector<size_t> stations_order, stations_position;
+
+    if (reorder_stations) {
+
+        size_t num_fcst_stations = (use_view ? forecasts_view.getStations().size() : forecasts.getStations().size());
+
+        if (num_fcst_stations != observations.getStations().size()) {
+            if (config.verbose >= Verbose::Warning) cerr << "Warning: Stations are not reordered because"
+                    << " forecasts and observations have different numbers of stations!" << endl;
+        } else {
+
+            if (config.verbose >= Verbose::Progress) cout << "Reordering stations along a Hilbert curve ..." << endl;
+
+            // Values are reordered in place, so the view is copied first
+            if (use_view) {
+                ForecastsPointer forecasts_subset;
+                forecasts_view.subset(forecasts_view.getParameters(), forecasts_view.getStations(),
+                        forecasts_view.getTimes(), forecasts_view.getFLTs(), forecasts_subset);
+                forecasts = std::move(forecasts_subset);
+                use_view = false;
+            }
+
+            Functions::spaceFillingOrder(forecasts.getStations(), stations_order);
+            Functions::reorderStations(forecasts, stations_order);
+            Functions::reorderStations(observations, stations_order);
+
+            // The position of each original station after reordering
+            stations_position.resize(stations_order.size());
+            for (size_t i = 0; i < stations_order.size(); ++i) stations_position[stations_order[i]] = i;
+
+            profiler.log_time_session("Reordering stations");
+        }
+    }
+
     
     /**************************************************************************
      *                       Generate Analogs Ensemble                        *
@@ -226,34 +353,34 @@ void runAnEnNcdf(
 
 
     /*
-     * Check for multivariate analog generation
+     * Forecasts from here on are not modified. They are either the full
+     * forecasts or a view of the subset stations.
      */
-    if (obs_id.size() == 0) {
-        // Use the default observation ID in config, Nothing is changed.
-    } else if (obs_id.size() == 1) {
-        // Use this observation ID
-        config.obs_var_index = obs_id[0];
-    } else {
-        // We have multiple observations ID. We are generating multivariate analogs.
-        if (config.verbose >= Verbose::Progress) cout << "Multi-analogs functionality ON" << endl;
+    const Forecasts & forecasts_to_use = use_view ? static_cast<const Forecasts &>(forecasts_view) : forecasts;
 
-        config.save_analogs = false;
-        config.save_analogs_time_index = true;
-        config.save_sims_station_index = true;
-    }
+
+    /*
+     * Check for multivariate analog generation
+     */
+    setObsID(config, obs_id);
 
 
     /*
      * Generate analogs
      */
-    AnEn* anen = nullptr;
+    AnEnIS* anen = nullptr;
 
     if (algorithm == "IS") {
         anen = new AnEnIS(config);
     } else if (algorithm == "SSE") {
 
-        if (forecasts.getStations().size() == observations.getStations().size()) anen = new AnEnSSE(config);
+#if defined(_USE_MPI_EXTENSION)
+        // Workers join the computation in runAnEnSSEWorker
+        anen = new AnEnSSEMPI(config);
+#else
+        if (forecasts_to_use.getStations().size() == observations.getStations().size()) anen = new AnEnSSE(config);
         else anen = new AnEnSSEMS(config);
+#endif
 
     } else {
         throw runtime_error("The algorithm is not recognized");
@@ -263,10 +390,19 @@ void runAnEnNcdf(
     if (!similarity_model.empty()) anen->load_similarity_model(similarity_model);
 #endif
 
-    anen->compute(forecasts, observations, test_times, search_times);
+    anen->compute(forecasts_to_use, observations, test_times, search_times);
 
     profiler += anen->getProfile();
 
+    // Results, forecasts, and observations are put back in the original station order
+    if (!stations_order.empty()) {
+        anen->restoreStationOrder(stations_order);
+        Functions::reorderStations(forecasts, stations_position);
+        Functions::reorderStations(observations, stations_position);
+
+        profiler.log_time_session("Restoring station order");
+    }
+
 
     /**************************************************************************
      *                             Write Results                              *
@@ -276,9 +412,10 @@ void runAnEnNcdf(
      * Write AnEn results to an NetCDF file
      */
     AnEnWriteNcdf anen_write(config.verbose);
+    anen_write.setStorage(storage);
 
-    const auto & forecast_flts = forecasts.getFLTs();
-    const auto & forecast_parameters = forecasts.getParameters();
+    const auto & forecast_flts = forecasts_to_use.getFLTs();
+    const auto & forecast_parameters = forecasts_to_use.getParameters();
     const auto & observation_stations = observations.getStations();
 
     if (obs_id.size() > 1) {
@@ -314,10 +451,10 @@ void runAnEnNcdf(
     if (save_tests) {
 
         // Create test forecasts
-        ForecastsPointer test_forecasts(forecasts.getParameters(), forecasts.getStations(), test_times, forecasts.getFLTs());
+        ForecastsPointer test_forecasts(forecasts_to_use.getParameters(), forecasts_to_use.getStations(), test_times, forecasts_to_use.getFLTs());
 
         // Copy subset values from original forecasts
-        forecasts.subset(test_forecasts);
+        forecasts_to_use.subset(test_forecasts);
 
         /*
          * Forecasts and observations are appended to the same file as AnEn
@@ -368,7 +505,7 @@ void runAnEnNcdf(
                 }
 
                 ForecastsPointer unwrapped_observations;
-                Functions::unwrapTimeSeries(unwrapped_observations, test_times, forecasts.getFLTs(), test_observations);
+                Functions::unwrapTimeSeries(unwrapped_observations, test_times, forecasts_to_use.getFLTs(), test_observations);
 
                 anen_write.writeForecasts(fileout, unwrapped_observations, false, true, "AlignedObservations");
 
@@ -392,6 +529,333 @@ void runAnEnNcdf(
     return;
 }
 
+#if defined(_USE_MPI_EXTENSION)
+void runAnEnSSEWorker(
+        const string & forecast_file,
+        const string & observation_file,
+        Config & config,
+        const vector<size_t> & obs_id,
+        const string & similarity_model,
+        bool read_by_ranks,
+        bool gather_by_ranks) {
+
+    /*
+     * Workers either read their own stations, or have forecasts and
+     * observations scattered from the master. Halo stations are exchanged
+     * between workers, and results are gathered to the master.
+     *
+     * When the master needs all values, workers still help the master read.
+     */
+    setObsID(config, obs_id);
+
+    ForecastsPointer forecasts;
+    ObservationsPointer observations;
+    vector<size_t> fcsts_test_index, fcsts_search_index;
+
+    if (read_by_ranks) {
+        AnEnReadNcdfMPI anen_read(config.verbose, config.worker_verbose);
+        anen_read.readForecasts(forecast_file, forecasts);
+        anen_read.readObservations(observation_file, observations);
+    } else if (gather_by_ranks) {
+        // Values are sent to the master. Workers still have nothing.
+        AnEnReadNcdfMPI anen_read(config.verbose, config.worker_verbose);
+        anen_read.gatherForecasts(forecast_file, forecasts);
+        anen_read.gatherObservations(observation_file, observations);
+    }
+
+    AnEnSSEMPI anen(config);
+
+#if defined(_ENABLE_AI)
+    if (!similarity_model.empty()) anen.load_similarity_model(similarity_model);
+#endif
+
+    anen.compute(forecasts, observations, fcsts_test_index, fcsts_search_index);
+
+    return;
+}
+#endif
+
+/**
+ * A block of stations that moves through the streaming pipeline
+ */
+struct StationBlock {
+    size_t start = 0;
+    size_t count = 0;
+    ForecastsPointer forecasts;
+    ObservationsPointer observations;
+    unique_ptr<AnEnIS> anen;
+};
+
+size_t estimateStationBytes(
+        const string & forecast_file,
+        const string & observation_file,
+        size_t num_test_times,
+        const Config & config,
+        size_t num_multi_analogs) {
+
+    size_t num_parameters = Ncdf::readDimLength(forecast_file, Config::_DIM_PARS);
+    size_t num_times = Ncdf::readDimLength(forecast_file, Config::_DIM_TIMES);
+    size_t num_flts = Ncdf::readDimLength(forecast_file, Config::_DIM_FLTS);
+    size_t num_obs_parameters = Ncdf::readDimLength(observation_file, Config::_DIM_PARS);
+    size_t num_obs_times = Ncdf::readDimLength(observation_file, Config::_DIM_TIMES);
+
+    // Forecasts, standard deviations, and observations
+    size_t num_values = 2 * num_parameters * num_times * num_flts + num_obs_parameters * num_obs_times;
+
+    // Results
+    size_t num_analogs_arrays = config.save_analogs + config.save_analogs_time_index + num_multi_analogs;
+    size_t num_sims_arrays = config.save_sims + config.save_sims_time_index;
+    num_values += num_test_times * num_flts * (
+            num_analogs_arrays * config.num_analogs + num_sims_arrays * config.num_sims);
+
+    return num_values * sizeof (double);
+}
+
+/**
+ * Computes the fingerprint of a streaming run from the inputs and settings
+ * that change results. A run is only resumed with the same fingerprint.
+ */
+string runFingerprint(
+        const string & forecast_file,
+        const string & observation_file,
+        size_t station_start, size_t station_count,
+        const vector<size_t> & obs_id,
+        const Times & test_times,
+        const Times & search_times,
+        Config config,
+        const vector<string> & wind_names,
+        const Ncdf::Storage & storage) {
+
+    ostringstream description;
+
+    // Verbosity does not change results
+    config.verbose = Verbose::Progress;
+    config.print(description);
+
+    description << "stations: " << station_start << " " << station_count << endl
+            << "obs_id: " << Functions::format(obs_id) << endl
+            << "wind: " << Functions::format(wind_names) << endl
+            << "significant_digits: " << storage.significant_digits << endl;
+
+    description << "test_times:";
+    for (const auto & time : test_times.left) description << " " << time.second.timestamp;
+    description << endl << "search_times:";
+    for (const auto & time : search_times.left) description << " " << time.second.timestamp;
+    description << endl;
+
+    return FunctionsIO::fingerprint(description.str(), {forecast_file, observation_file});
+}
+
+void runAnEnNcdfStream(
+        const string & forecast_file,
+        const string & observation_file,
+        int station_start, int station_count,
+        const vector<size_t> & obs_id,
+        const string & test_start_str,
+        const string & test_end_str,
+        const vector<string> & test_times_str,
+        const string & search_start_str,
+        const string & search_end_str,
+        const vector<string> & search_times_str,
+        const string & fileout,
+        Config & config,
+        bool overwrite,
+        bool profile,
+        bool convert_wind,
+        const vector<string> & u_names,
+        const vector<string> & v_names,
+        const vector<string> & spd_names,
+        const vector<string> & dir_names,
+        size_t memory_budget,
+        size_t checkpoint_stations,
+        bool resume,
+        const Ncdf::Storage & storage) {
+
+    /*
+     * Stations are processed in blocks. While a block is being computed, the
+     * next block is read in the background. Computed blocks are handed to a
+     * background writer and released after they are written. Only three
+     * blocks are kept in memory at any time.
+     *
+     * Written blocks are also checkpoints. The output file records the number
+     * of leading stations written and the fingerprint of the run, so a run
+     * that stops can be resumed from the first unwritten station.
+     */
+
+    Profiler profiler;
+    profiler.start();
+
+    // Create times
+    Time test_start, test_end, search_start, search_end;
+    Times test_times, search_times;
+
+    parseTimes(test_start_str, test_end_str, test_times_str,
+            search_start_str, search_end_str, search_times_str, config.operation,
+            test_start, test_end, test_times, search_start, search_end, search_times);
+
+    // Read stations and times without reading values
+    AnEnReadNcdf anen_read(config.verbose);
+
+    Ncdf::checkExists(forecast_file);
+    Ncdf::checkExists(observation_file);
+
+    if (station_start < 0 || station_count <= 0) {
+        station_start = 0;
+        station_count = Ncdf::readDimLength(forecast_file, Config::_DIM_STATIONS);
+    }
+
+    Stations stations;
+    Times forecast_times;
+
+    {
+        netCDF::NcFile nc(forecast_file, netCDF::NcFile::FileMode::read);
+        anen_read.read(nc, stations, station_start, station_count);
+        anen_read.read(nc, forecast_times, Config::_TIMES);
+    }
+
+    if (test_times_str.empty()) forecast_times(test_start, test_end, test_times);
+    if (search_times_str.empty()) forecast_times(search_start, search_end, search_times);
+
+    // Check for multivariate analog generation
+    setObsID(config, obs_id);
+    size_t num_multi_analogs = (obs_id.size() > 1 ? obs_id.size() : 0);
+
+    // Determine the number of stations in a block
+    size_t block_size = station_count;
+
+    if (memory_budget > 0) {
+        size_t station_bytes = estimateStationBytes(forecast_file, observation_file, test_times.size(), config, num_multi_analogs);
+        block_size = memory_budget * 1024 * 1024 / (3 * station_bytes);
+
+        if (block_size == 0) {
+            if (config.verbose >= Verbose::Warning) cerr << "Warning: A station needs " << station_bytes
+                    << " bytes which exceeds the memory budget. One station is processed at a time." << endl;
+            block_size = 1;
+        }
+    }
+
+    if (checkpoint_stations > 0) block_size = min(block_size, checkpoint_stations);
+
+    AnEnWriteNcdf anen_write(config.verbose);
+    anen_write.setStorage(storage);
+
+    // Wind conversion changes forecasts, so names are part of the fingerprint
+    vector<string> wind_names;
+    if (convert_wind) {
+        for (size_t name_index = 0; name_index < u_names.size(); name_index++) {
+            wind_names.push_back(u_names[name_index] + "," + v_names[name_index] + "," + spd_names[name_index] + "," + dir_names[name_index]);
+        }
+    }
+
+    string fingerprint = runFingerprint(forecast_file, observation_file, station_start, station_count,
+            obs_id, test_times, search_times, config, wind_names, storage);
+
+    // Skip stations that have been written by an interrupted run
+    size_t first_station = 0;
+    bool resuming = (resume && fs::exists(fileout));
+    if (resuming) first_station = anen_write.readCheckpoint(fileout, fingerprint);
+
+    if (first_station >= (size_t) station_count) {
+        if (config.verbose >= Verbose::Progress) cout << "All stations have been written. Nothing to resume." << endl;
+        return;
+    }
+
+    size_t num_blocks = (station_count - first_station + block_size - 1) / block_size;
+
+    if (config.verbose >= Verbose::Progress) cout << "Streaming " << station_count - first_station << " stations in "
+            << num_blocks << " blocks of at most " << block_size << " stations ..." << endl;
+
+    profiler.log_time_session("Preparing blocks");
+
+
+    /*
+     * Define the stages of the pipeline
+     */
+    Parameters forecast_parameters;
+    Times forecast_flts;
+    unordered_map<string, size_t> obs_map;
+
+    auto read_block = [&](size_t block_i) {
+        unique_ptr<StationBlock> block(new StationBlock);
+        block->start = first_station + block_i * block_size;
+        block->count = min(block_size, station_count - block->start);
+
+        // The NetCDF library is not thread-safe. Share the lock with the writer.
+        lock_guard<mutex> ncdf_lock(Ncdf::getMutex());
+        anen_read.readForecasts(forecast_file, block->forecasts, station_start + block->start, block->count);
+        anen_read.readObservations(observation_file, block->observations, station_start + block->start, block->count);
+        return block;
+    };
+
+    auto compute_block = [&](StationBlock & block) {
+
+        if (convert_wind) {
+            for (size_t name_index = 0; name_index < u_names.size(); name_index++) {
+                block.forecasts.windTransform(u_names[name_index], v_names[name_index], spd_names[name_index], dir_names[name_index]);
+            }
+        }
+
+        block.anen.reset(new AnEnIS(config));
+        block.anen->compute(block.forecasts, block.observations, test_times, search_times);
+
+        if (block.start == first_station) {
+            forecast_parameters = block.forecasts.getParameters();
+            forecast_flts = block.forecasts.getFLTs();
+            if (num_multi_analogs) Functions::createObsMap(obs_map, obs_id, block.observations.getParameters());
+        }
+
+        // Forecasts are no longer needed. Observations are kept for multivariate analogs.
+        block.forecasts = ForecastsPointer();
+        if (!num_multi_analogs) block.observations = ObservationsPointer();
+    };
+
+
+
+    /*
+     * Run the pipeline
+     */
+    AnEnWriteNcdfQueue anen_queue(anen_write, fileout);
+
+    unique_ptr<StationBlock> computing = read_block(0);
+    profiler.log_time_session("Reading the first block");
+
+    for (size_t block_i = 0; block_i < num_blocks; ++block_i) {
+
+        if (config.verbose >= Verbose::Progress) cout << "Processing block " << block_i + 1 << "/" << num_blocks
+                << " with " << computing->count << " stations from #" << station_start + computing->start << " ..." << endl;
+
+        future<unique_ptr<StationBlock> > io = async(launch::async, [&, block_i]() {
+            unique_ptr<StationBlock> next;
+            if (block_i + 1 < num_blocks) next = read_block(block_i + 1);
+            return next;
+        });
+
+        compute_block(*computing);
+
+        // The output file is created from the first block unless it is resumed
+        if (block_i == 0) {
+            if (resuming) anen_queue.resume(obs_map);
+            else anen_queue.create(*(computing->anen), obs_map, test_times, search_times,
+                    forecast_flts, forecast_parameters, stations, forecast_times.size(), overwrite, fingerprint);
+        }
+
+        // Wait if the writer still owns the previous block
+        anen_queue.push(computing->start, std::move(computing->anen), std::move(computing->observations));
+
+        computing = io.get();
+    }
+
+    profiler.log_time_session("Computing with overlapped I/O");
+
+    anen_queue.finish();
+    profiler.log_time_session("Writing remaining blocks");
+
+    if (config.verbose >= Verbose::Progress) cout << "anen_netcdf complete!" << endl;
+    if (profile) profiler.summary(cout);
+
+    return;
+}
+
 int main(int argc, char** argv) {
 
 #ifdef NDEBUG
@@ -416,10 +880,13 @@ int main(int argc, char** argv) {
     vector<size_t> obs_id, fcst_stations_subset;
     vector<string> config_files, u_names, v_names, spd_names, dir_names, test_times_str, search_times_str;
     int fcst_station_start, fcst_station_count, obs_station_start, obs_station_count;
-    bool overwrite, profile, save_tests, unwrap_obs, convert_wind;
+    bool overwrite, profile, save_tests, unwrap_obs, reorder_stations, convert_wind;
     long int ai_flt_radius;
+    size_t memory_budget, checkpoint_stations;
+    bool resume;
 
     Config config;
+    Ncdf::Storage storage;
 
     // Define available command line parameters
     options_description desc("Available options");
@@ -428,8 +895,8 @@ int main(int argc, char** argv) {
             ("config,c", value< vector<string> >(&config_files)->multitoken(), "Config files (.cfg). Command line options overwrite config files.")
 
             // Required arguments
-            ("forecast-file", value<string>(&forecast_file)->required(), "An NetCDF file for forecasts")
-            ("observation-file", value<string>(&observation_file)->required(), "An NetCDF file for observations")
+            ("forecast-file", value<string>(&forecast_file)->required(), "An NetCDF or binary (from binary_convert) file for forecasts")
+            ("observation-file", value<string>(&observation_file)->required(), "An NetCDF or binary (from binary_convert) file for observations")
             ("out", value<string>(&fileout)->required(), "Output file path.")
             ("test-start", value<string>(&test_start), "[Optional] Start date time for test with the format YYYY-mm-dd HH:MM:SS")
             ("test-end", value<string>(&test_end), "[Optional] End date time for test.")
@@ -455,6 +922,13 @@ int main(int argc, char** argv) {
             ("obs-id", value< vector<size_t> >(&obs_id)->multitoken(), "[Optional] Observation variable index. If multiple indices are provided, multivariate analogs will be generated.")
             ("overwrite", bool_switch(&overwrite)->default_value(false), "[Optional] Overwrite files and variables.")
             ("profile", bool_switch(&profile)->default_value(false), "[Optional] Print profiler's report.")
+            ("deflate-level", value<int>(&(storage.deflate_level))->default_value(storage.deflate_level), "[Optional] Deflate level (0 - 9) for output variables. 0 turns off compression.")
+            ("shuffle", bool_switch(&(storage.shuffle))->default_value(storage.shuffle), "[Optional] Use the shuffle filter before deflate for output variables.")
+            ("significant-digits", value<int>(&(storage.significant_digits))->default_value(storage.significant_digits), "[Optional] Number of significant digits to keep for analogs and similarity with bit grooming. 0 keeps all digits. This requires NetCDF 4.9.0 or later.")
+            ("chunk-stations", value<size_t>(&(storage.chunk_stations))->default_value(storage.chunk_stations), "[Optional] Number of stations in a chunk of output variables. Other dimensions are not split. 0 uses the library default.")
+            ("memory-budget", value<size_t>(&memory_budget)->default_value(0), "[Optional] Memory budget in MB. If set, stations are processed in blocks that fit in the budget, and reading and writing are overlapped with computation. Only IS is supported.")
+            ("checkpoint-stations", value<size_t>(&checkpoint_stations)->default_value(0), "[Optional] Number of stations in a checkpoint. If set, stations are processed in blocks like --memory-budget, and each block is written to the output as soon as it is computed. Only IS is supported.")
+            ("resume", bool_switch(&resume)->default_value(false), "[Optional] Resume an interrupted run with --memory-budget or --checkpoint-stations from its output file. Inputs and settings must be the same. Only stations that have not been written are computed.")
             ("weights", value< vector<double> >(&(config.weights))->multitoken(), "[Optional] Weight for each parameter ID.")
             ("analogs", value<size_t>(&(config.num_analogs)), "[Optional] Number of analogs members.")
             ("sims", value<size_t>(&(config.num_sims)), "[Optional] Number of similarity members.")
@@ -475,6 +949,7 @@ int main(int argc, char** argv) {
             ("save-sims-station-index", bool_switch(&(config.save_sims_station_index))->default_value(config.save_sims_station_index), "[Optional] Save station indices of similarity.")
             ("save-tests", bool_switch(&save_tests)->default_value(false), "[Optional] Save test forecasts and observations if available")
             ("unwrap-test-obs", bool_switch(&unwrap_obs)->default_value(false), "[Optional] When saving test observations (--save-tests), unwrap observation time series to align it with forecasts")
+            ("reorder-stations", bool_switch(&reorder_stations)->default_value(false), "[Optional] Reorder stations along a Hilbert curve for better memory locality during computation. Results are still written in the original station order.")
             ("quick-sort", bool_switch(&(config.quick_sort))->default_value(config.quick_sort), "[Optional] Use nth_element sort. Change this in *.cfg ")
             ("convert-wind", bool_switch(&(convert_wind))->default_value(false), "[Optional] Use this option if your forecasts have only wind U and V components and you need to convert them to wind speed and direction. Please also specify --name-u --name-v --name-spd --name-dir. Wind speed and direction values will be calculated internally and replacing U and V components respectively.")
             ("name-u", value< vector<string> >(&u_names)->multitoken(), "[Optional] Parameter name(s) for U component of wind")
@@ -603,6 +1078,22 @@ int main(int argc, char** argv) {
     }
 
 
+    // Check whether streaming is supported
+    bool stream = (memory_budget > 0 || checkpoint_stations > 0);
+
+    if (stream) {
+        if (algorithm != "IS") throw runtime_error("--memory-budget and --checkpoint-stations only support the algorithm IS");
+        if (fcst_stations_subset.size() != 0) throw runtime_error("--memory-budget and --checkpoint-stations cannot be used with --fcst-stations-subset");
+        if (save_tests) throw runtime_error("--memory-budget and --checkpoint-stations cannot be used with --save-tests");
+        if (!embedding_model.empty() || !similarity_model.empty()) throw runtime_error("--memory-budget and --checkpoint-stations cannot be used with AI models");
+        if (fcst_station_start != obs_station_start || fcst_station_count != obs_station_count) {
+            throw runtime_error("--memory-budget and --checkpoint-stations require the same subset of forecast and observation stations");
+        }
+    }
+
+    if (resume && !stream) throw runtime_error("--resume requires --memory-budget or --checkpoint-stations");
+
+
     /**************************************************************************
      *                     Run analog generation with NC files                *
      **************************************************************************/
@@ -610,11 +1101,9 @@ int main(int argc, char** argv) {
     forecast_file = fs::absolute(fs::path(forecast_file.c_str())).string();
     observation_file = fs::absolute(fs::path(observation_file.c_str())).string();
 
-#if defined(_USE_MPI_EXTENSION)
-    if (algorithm == "SSE") {
-        throw runtime_error("The MPI implementation for SSE is not provided yet.");
-    }
+    bool read_by_ranks = false, gather_by_ranks = false;
 
+#if defined(_USE_MPI_EXTENSION)
     if (fcst_stations_subset.size() != 0) {
         throw runtime_error("The MPI implementation for subsetting stations is not provided yet.");
     }
@@ -636,38 +1125,76 @@ int main(int argc, char** argv) {
     MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
     MPI_Comm_size(MPI_COMM_WORLD, &world_size);
 
-    if (fcst_station_count == -1) {
-        fcst_station_start = 0;
-        obs_station_start = 0;
+    if (algorithm == "SSE") {
 
-        fcst_station_count = Ncdf::readDimLength(forecast_file, Config::_DIM_STATIONS);
-        obs_station_count = fcst_station_count;
-    }
+        // Search stations can belong to other ranks, so ranks cannot process
+        // stations independently. The master writes a single file.
+        // AnEnSSEMPI exchanges halo stations between workers.
+        //
+        // Each worker reads its own stations unless the master needs all
+        // values, e.g. to save test forecasts or to transform forecasts.
+        //
+        read_by_ranks = (obs_id.size() <= 1 && !save_tests && !convert_wind && !reorder_stations &&
+                embedding_model.empty() && !AnEnReadBinary::isBinary(forecast_file) &&
+                !AnEnReadBinary::isBinary(observation_file));
+
+        // Otherwise, NetCDF files are still read by workers in parallel and
+        // gathered to the master. Binary files are memory mapped by the master.
+        gather_by_ranks = (!read_by_ranks && !AnEnReadBinary::isBinary(forecast_file) &&
+                !AnEnReadBinary::isBinary(observation_file));
+
+        if (world_rank != 0) {
+            runAnEnSSEWorker(forecast_file, observation_file, config, obs_id, similarity_model, read_by_ranks, gather_by_ranks);
+            MPI_Finalize();
+            return 0;
+        }
 
-    // Determine what stations to process for this rank. In this case, our master can
-    // also do work. So we need to add 1 to the world size when using the functions from
-    // Functions to take into consideration the fact that These functions assume that master 
-    // process does not do any work.
-    //
-    fcst_station_start += Functions::getStartIndex(fcst_station_count, world_size + 1, world_rank + 1);
-    fcst_station_count = Functions::getSubTotal(fcst_station_count, world_size + 1, world_rank + 1);
+    } else {
 
-    obs_station_start = fcst_station_start;
-    obs_station_count = fcst_station_count;
+        if (fcst_station_count == -1) {
+            fcst_station_start = 0;
+            obs_station_start = 0;
 
-    // Determine the new output file name
-    stringstream padded_rank;
-    padded_rank << "_Rank" << std::setw(to_string(world_size).length()) << std::setfill('0') << world_rank;
-    fileout = boost::filesystem::change_extension(fileout, "").string() + padded_rank.str() + string(".nc");
+            fcst_station_count = Ncdf::readDimLength(forecast_file, Config::_DIM_STATIONS);
+            obs_station_count = fcst_station_count;
+        }
 
-    if (config.verbose >= Verbose::Detail) cout << "Rank " << world_rank << "/" << world_size <<
-            " processes " << fcst_station_count << " stations [:] from #" << fcst_station_start << " will be writing to " << fileout << endl;
+        // Determine what stations to process for this rank. In this case, our master can
+        // also do work. So we need to add 1 to the world size when using the functions from
+        // Functions to take into consideration the fact that These functions assume that master 
+        // process does not do any work.
+        //
+        fcst_station_start += Functions::getStartIndex(fcst_station_count, world_size + 1, world_rank + 1);
+        fcst_station_count = Functions::getSubTotal(fcst_station_count, world_size + 1, world_rank + 1);
+
+        obs_station_start = fcst_station_start;
+        obs_station_count = fcst_station_count;
+
+        // Determine the new output file name
+        stringstream padded_rank;
+        padded_rank << "_Rank" << std::setw(to_string(world_size).length()) << std::setfill('0') << world_rank;
+        fileout = boost::filesystem::change_extension(fileout, "").string() + padded_rank.str() + string(".nc");
+
+        if (config.verbose >= Verbose::Detail) cout << "Rank " << world_rank << "/" << world_size <<
+                " processes " << fcst_station_count << " stations [:] from #" << fcst_station_start << " will be writing to " << fileout << endl;
+    }
 #endif
 
-    runAnEnNcdf(forecast_file, observation_file, fcst_station_start, fcst_station_count, fcst_stations_subset, obs_station_start, obs_station_count,
-            obs_id, test_start, test_end, test_times_str, search_start, search_end, search_times_str, fileout, 
-            algorithm, config, overwrite, profile, save_tests, unwrap_obs, convert_wind,
-            u_names, v_names, spd_names, dir_names, embedding_model, similarity_model, ai_flt_radius, fcst_grid_file);
+    if (stream) {
+        if (AnEnReadBinary::isBinary(forecast_file) || AnEnReadBinary::isBinary(observation_file)) {
+            throw invalid_argument("--memory-budget and --checkpoint-stations only support NetCDF files. Binary files are memory mapped and do not need it.");
+        }
+
+        runAnEnNcdfStream(forecast_file, observation_file, fcst_station_start, fcst_station_count,
+                obs_id, test_start, test_end, test_times_str, search_start, search_end, search_times_str, fileout,
+                config, overwrite, profile, convert_wind, u_names, v_names, spd_names, dir_names, memory_budget,
+                checkpoint_stations, resume, storage);
+    } else {
+        runAnEnNcdf(forecast_file, observation_file, fcst_station_start, fcst_station_count, fcst_stations_subset, obs_station_start, obs_station_count,
+                obs_id, test_start, test_end, test_times_str, search_start, search_end, search_times_str, fileout, 
+                algorithm, config, overwrite, profile, save_tests, unwrap_obs, reorder_stations, convert_wind,
+                u_names, v_names, spd_names, dir_names, embedding_model, similarity_model, ai_flt_radius, fcst_grid_file, read_by_ranks, gather_by_ranks, storage);
+    }
 
 #if defined(_USE_MPI_EXTENSION)
     MPI_Finalize();
@@ -0,0 +1,167 @@
+/*
+ * File:   binary_convert.cpp
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+/** @file */
+
+// Needed for ifstream
+#include <fstream>
+#include <sstream>
+
+#include "boost/program_options.hpp"
+
+#include "Config.h"
+#include "Profiler.h"
+#include "Functions.h"
+#include "AnEnReadNcdf.h"
+#include "AnEnWriteBinary.h"
+#include "ForecastsPointer.h"
+#include "ObservationsPointer.h"
+
+using namespace std;
+using namespace boost::program_options;
+
+
+void runBinaryConvert(
+        const string & file_type,
+        const string & in_file,
+        const string & out_file,
+        Verbose verbose,
+        bool overwrite,
+        bool profile) {
+
+    Profiler profiler;
+    profiler.start();
+
+    AnEnReadNcdf anen_read(verbose);
+    AnEnWriteBinary anen_write(verbose);
+
+    if (file_type == "Forecasts") {
+
+        ForecastsPointer forecasts;
+        anen_read.readForecasts(in_file, forecasts);
+        profiler.log_time_session("Reading forecasts");
+
+        anen_write.writeForecasts(out_file, forecasts, overwrite);
+        profiler.log_time_session("Writing forecasts");
+
+    } else if (file_type == "Observations") {
+
+        ObservationsPointer observations;
+        anen_read.readObservations(in_file, observations);
+        profiler.log_time_session("Reading observations");
+
+        anen_write.writeObservations(out_file, observations, overwrite);
+        profiler.log_time_session("Writing observations");
+
+    } else {
+        ostringstream msg;
+        msg << "Unknown file type " << file_type << ". Use Forecasts or Observations";
+        throw invalid_argument(msg.str());
+    }
+
+    profiler.log_time_session("Done");
+    if (profile) profiler.summary(cout);
+
+    return;
+}
+
+
+int main(int argc, char** argv) {
+
+#ifdef NDEBUG
+    try {
+#endif
+
+    // Initialization
+    string file_type, in_file, out_file;
+    vector<string> config_files;
+    bool overwrite, profile;
+    int verbose;
+
+    // Set up arguments
+    options_description desc("Available options");
+    desc.add_options()
+            ("help,h", "Print help information for options.")
+            ("config,c", value< vector<string> >(&config_files)->multitoken(), "Config files (.cfg). Command line options overwrite config files.")
+
+            ("type", value<string>(&file_type)->required(), "The type of the input file. Either Forecasts or Observations.")
+            ("in", value<string>(&in_file)->required(), "An NetCDF file to convert")
+            ("out", value<string>(&out_file)->required(), "Output binary file path")
+
+            ("overwrite", bool_switch(&overwrite)->default_value(false), "[Optional] Overwrite files")
+            ("profile", bool_switch(&profile)->default_value(false), "[Optional] Print profiler's report.")
+            ("verbose,v", value<int>(&verbose)->default_value(2), "[Optional] Verbose level (0 - 4)");
+
+    // Get all the available options
+    vector<string> available_options;
+    auto lambda = [&available_options](const boost::shared_ptr<boost::program_options::option_description> option) {
+        available_options.push_back("--" + option->long_name());
+    };
+    for_each(desc.options().begin(), desc.options().end(), lambda);
+
+    // Parse the command line first
+    variables_map vm;
+    parsed_options parsed = command_line_parser(argc, argv).options(desc).allow_unregistered().run();
+    store(parsed, vm);
+
+    if (vm.count("help") || argc == 1) {
+        // If help messages are requested or there are
+        // no extra arguments other than the command line itself
+        //
+        cout << "Parallel Analogs Ensemble -- binary_convert " << _APPVERSION << endl << _COPYRIGHT_MSG << endl << endl
+                << "Converts forecasts or observations from NetCDF to the native binary format. The binary" << endl
+                << "files are memory mapped by anen_netcdf so that large data sets are loaded instantly." << endl << endl
+                << desc << endl;
+        return 0;
+    }
+
+    // Collect unregistered arguments and guess the intended options
+    auto unregistered_keys = collect_unrecognized(parsed.options, exclude_positional);
+    if (unregistered_keys.size() != 0) {
+        Functions::guess_arguments(unregistered_keys, available_options, cerr);
+        return 1;
+    }
+
+    // Then parse the configuration file
+    if (vm.count("config")) {
+        // If configuration file is specified, read it first.
+        // The variable won't be written until we call notify.
+        //
+        config_files = vm["config"].as< vector<string> >();
+    }
+
+    if (!config_files.empty()) {
+        for (const auto & config_file : config_files) {
+            ifstream ifs(config_file.c_str());
+            if (!ifs) {
+                cerr << "Error: Can't open configuration file " << config_file << endl;
+                return 1;
+            } else {
+                auto parsed_config = parse_config_file(ifs, desc, true);
+
+                auto unregistered_keys_config = collect_unrecognized(parsed_config.options, exclude_positional);
+                if (unregistered_keys_config.size() != 0) {
+                    Functions::guess_arguments(unregistered_keys_config, available_options, cout);
+                    return 1;
+                }
+
+                store(parsed_config, vm);
+            }
+        }
+    }
+
+    notify(vm);
+
+    runBinaryConvert(file_type, in_file, out_file, Functions::itov(verbose), overwrite, profile);
+
+#ifdef NDEBUG
+    } catch (exception & e) {
+        cerr << "Caught error: " << e.what() << endl << "Program is terminated!" << endl;
+        return 1;
+    }
+#endif
+
+    return 0;
+}
@@ -46,7 +46,10 @@ void runGribConvert(
         const vector<string> & u_names,
         const vector<string> & v_names,
         const vector<string> & spd_names,
-        const vector<string> & dir_names) {
+        const vector<string> & dir_names,
+        int read_threads,
+        bool grib_index,
+        const Ncdf::Storage & storage) {
 
     /*
      * Read files
@@ -57,9 +60,11 @@ void runGribConvert(
 
     AnEnReadGribMPI anen_read(verbose, worker_verbose);
 #else
-    AnEnReadGrib anen_read(verbose);
+    AnEnReadGrib anen_read(verbose, read_threads);
 #endif
 
+    anen_read.setIndex(grib_index);
+
     ForecastsPointer forecasts;
     anen_read.readForecasts(forecasts, grib_parameters, forecast_files,
             regex_str, unit_in_seconds, delimited, stations_index);
@@ -89,6 +94,7 @@ void runGribConvert(
      * Write NetCDF
      */
     AnEnWriteNcdf anen_write(verbose);
+    anen_write.setStorage(storage);
     if (collapse_lead_times) anen_write.writeObservations(fileout, observations, overwrite);
     else anen_write.writeForecasts(fileout, forecasts, overwrite);
 
@@ -113,9 +119,12 @@ int main(int argc, char** argv) {
     vector<bool> parameters_circular;
     vector<int> stations_index;
 
-    string forecast_folder, regex_str, fileout; 
+    string forecast_folder, regex_str, fileout, manifest; 
     bool delimited, overwrite, collapse_lead_times, convert_wind;
+    Ncdf::Storage storage;
     size_t unit_in_seconds;
+    int read_threads = 1;
+    bool grib_index;
     Verbose verbose;
 
 #if defined(_USE_MPI_EXTENSION)
@@ -136,14 +145,22 @@ int main(int argc, char** argv) {
             ("level-types", value< vector<string> >(&parameters_level_type)->multitoken()->required(), "Level type for parameter ID.")
             ("out", value<string>(&fileout)->required(), "Output file path.")
             ("stations-index", value< vector<int> >(&stations_index)->multitoken(), "[Optional] Stations index to be read from files.")
+            ("manifest", value<string>(&manifest)->default_value(""), "[Optional] A file to cache the list of files in the forecast folder. It is reused while the folder is unchanged.")
             ("delimited", bool_switch(&delimited)->default_value(false), "[Optional] Date strings in forecasts and analysis have separators.")
             ("overwrite", bool_switch(&overwrite)->default_value(false), "[Optional] Overwrite files and variables.")
+            ("grib-index", bool_switch(&grib_index)->default_value(false), "[Optional] Save message index files next to GRIB files and use them in later runs to read messages directly.")
             ("collapse-lead-times", bool_switch(&collapse_lead_times)->default_value(false), "[Optional] Collapse forecast lead times. This is helpful when you are reading and converting model analysis files to observation NetCDF files.")
             ("unit-in-seconds", value<size_t>(&unit_in_seconds)->default_value(3600), "[Optional] The number of seconds for the unit of lead times. Usually lead times have hours as unit, so it defaults to 3600.")
             ("verbose,v", value<int>()->default_value(1), "[Optional] Verbose level (0 - 4).")
+#if !defined(_USE_MPI_EXTENSION)
+            ("read-threads", value<int>(&read_threads)->default_value(1), "[Optional] Number of threads to decode GRIB files. Values larger than 1 require Eccodes built with thread support.")
+#endif
 #if defined(_USE_MPI_EXTENSION)
             ("worker-verbose", value<int>()->default_value(1), "[Optional] Verbose level for worker processes (0 - 4).")
 #endif
+            ("deflate-level", value<int>(&(storage.deflate_level))->default_value(storage.deflate_level), "[Optional] Deflate level (0 - 9) for output variables. 0 turns off compression.")
+            ("shuffle", bool_switch(&(storage.shuffle))->default_value(storage.shuffle), "[Optional] Use the shuffle filter before deflate for output variables.")
+            ("chunk-stations", value<size_t>(&(storage.chunk_stations))->default_value(storage.chunk_stations), "[Optional] Number of stations in a chunk of output variables. Other dimensions are not split. 0 uses the library default.")
             ("convert-wind", bool_switch(&(convert_wind))->default_value(false), "[Optional] Use this option if your forecasts have only wind U and V components and you need to convert them to wind speed and direction. Please also specify --name-u --name-v --name-spd --name-dir. Wind speed and direction values will be calculated internally and replacing U and V components respectively.")
             ("name-u", value< vector<string> >(&u_names)->multitoken(), "[Optional] Parameter name(s) for U component of wind")
             ("name-v", value< vector<string> >(&v_names)->multitoken(), "[Optional] Parameter name(s) for V component of wind")
@@ -262,7 +279,7 @@ int main(int argc, char** argv) {
 
     // List files from folders
     vector<string> forecast_files, analysis_files;
-    FunctionsIO::listFiles(forecast_files, forecast_folder, regex_str);
+    FunctionsIO::listFiles(forecast_files, forecast_folder, regex_str, manifest, verbose);
 
     if (forecast_files.size() == 0) throw runtime_error("No forecast files detected. Check --forecasts-folder and --regex.");
     if (verbose >= Verbose::Detail) cout << forecast_files.size()
@@ -279,7 +296,7 @@ int main(int argc, char** argv) {
 #if defined(_USE_MPI_EXTENSION)
             worker_verbose,
 #endif
-            convert_wind, u_names, v_names, spd_names, dir_names);
+            convert_wind, u_names, v_names, spd_names, dir_names, read_threads, grib_index, storage);
 
 #if defined(_USE_MPI_EXTENSION)
     MPI_Finalize();
@@ -6,14 +6,21 @@
  */
 
 #include <cmath>
+#include <cstring>
+#include <boost/filesystem.hpp>
 
 #include "ForecastsPointer.h"
+#include "ObservationsPointer.h"
 #include "FunctionsIO.h"
 #include "AnEnReadGrib.h"
+#include "AnEnReadNcdfMPI.h"
+#include "AnEnWriteNcdf.h"
 #include "testAnEnIOMPI.h"
 
 using namespace std;
 
+namespace filesys = boost::filesystem;
+
 CPPUNIT_TEST_SUITE_REGISTRATION(testAnEnIOMPI);
 
 testAnEnIOMPI::testAnEnIOMPI() {
@@ -78,6 +85,94 @@ testAnEnIOMPI::tearDown() {
     return;
 }
 
+void
+testAnEnIOMPI::testGatherNcdf_() {
+
+    /*
+     * Forecasts and observations gathered to the master should be the same
+     * as those read in serial. Chunks of 3 stations do not divide the 10
+     * stations evenly.
+     */
+    ForecastsPointer forecasts;
+    ObservationsPointer observations;
+
+    Parameters parameters;
+    Stations stations;
+    Times forecast_times, observation_times, flts;
+
+    parameters.push_back(Parameter("temp", false));
+    parameters.push_back(Parameter("wdir", true));
+    for (int i = 0; i < 10; ++i) stations.push_back(Station(i, 2 * i));
+    for (int i = 0; i < 5; ++i) forecast_times.push_back(i * 100);
+    for (int i = 0; i < 20; ++i) observation_times.push_back(i * 10);
+    for (int i = 0; i < 3; ++i) flts.push_back(i * 10);
+
+    // The master writes files and shares the names
+    char file_stem[64] = {'\0'};
+
+    if (world_rank == 0) {
+        forecasts.setDimensions(parameters, stations, forecast_times, flts);
+        observations.setDimensions(parameters, stations, observation_times);
+
+        double *forecast_ptr = forecasts.getValuesPtr();
+        for (size_t i = 0; i < forecasts.num_elements(); ++i) forecast_ptr[i] = i;
+
+        double *observation_ptr = observations.getValuesPtr();
+        for (size_t i = 0; i < observations.num_elements(); ++i) observation_ptr[i] = i * 0.5;
+
+        string stem = (filesys::temp_directory_path() / filesys::unique_path("%%%%-%%%%")).string();
+        strncpy(file_stem, stem.c_str(), sizeof(file_stem) - 1);
+
+        Ncdf::Storage storage;
+        storage.chunk_stations = 3;
+
+        AnEnWriteNcdf anen_write(Verbose::Warning);
+        anen_write.setStorage(storage);
+        anen_write.writeForecasts(string(file_stem) + "_fcsts.nc", forecasts);
+        anen_write.writeObservations(string(file_stem) + "_obs.nc", observations);
+    }
+
+    MPI_Bcast(file_stem, sizeof(file_stem), MPI_CHAR, 0, MPI_COMM_WORLD);
+    string forecast_file = string(file_stem) + "_fcsts.nc";
+    string observation_file = string(file_stem) + "_obs.nc";
+
+    ForecastsPointer forecasts_mpi;
+    ObservationsPointer observations_mpi;
+
+    AnEnReadNcdfMPI anen_read_mpi(Verbose::Warning, Verbose::Warning);
+    anen_read_mpi.gatherForecasts(forecast_file, forecasts_mpi);
+    anen_read_mpi.gatherObservations(observation_file, observations_mpi);
+
+    if (world_rank == 0) {
+        CPPUNIT_ASSERT(forecasts_mpi.getStations() == stations);
+        CPPUNIT_ASSERT(forecasts_mpi.getFLTs() == flts);
+        CPPUNIT_ASSERT(observations_mpi.getTimes() == observation_times);
+        CPPUNIT_ASSERT(forecasts_mpi.num_elements() == forecasts.num_elements());
+        CPPUNIT_ASSERT(observations_mpi.num_elements() == observations.num_elements());
+
+        for (size_t i = 0; i < forecasts.num_elements(); ++i) {
+            CPPUNIT_ASSERT(forecasts_mpi.getValuesPtr()[i] == forecasts.getValuesPtr()[i]);
+        }
+
+        for (size_t i = 0; i < observations.num_elements(); ++i) {
+            CPPUNIT_ASSERT(observations_mpi.getValuesPtr()[i] == observations.getValuesPtr()[i]);
+        }
+
+        filesys::remove(forecast_file);
+        filesys::remove(observation_file);
+
+    } else {
+        // Workers do not keep any values
+        CPPUNIT_ASSERT(forecasts_mpi.num_elements() == 0);
+        CPPUNIT_ASSERT(observations_mpi.num_elements() == 0);
+    }
+
+    // A missing file fails on all processes
+    CPPUNIT_ASSERT_THROW(anen_read_mpi.gatherForecasts(forecast_file, forecasts_mpi), runtime_error);
+
+    return;
+}
+
 void
 testAnEnIOMPI::testReadGrib_() {
 
@@ -18,6 +18,8 @@
 class testAnEnIOMPI : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST_SUITE(testAnEnIOMPI);
 
+    // Workers exit after reading GRIB files, so NetCDF is tested first
+    CPPUNIT_TEST(testGatherNcdf_);
     CPPUNIT_TEST(testReadGrib_);
 
     CPPUNIT_TEST_SUITE_END();
@@ -47,6 +49,7 @@ public:
 
 
 private:
+    void testGatherNcdf_();
     void testReadGrib_();
 
 };
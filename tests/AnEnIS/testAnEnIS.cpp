@@ -8,7 +8,6 @@
 #include <numeric>
 
 #include "testAnEnIS.h"
-#include "boost/bimap/bimap.hpp"
 #include "boost/assign/list_of.hpp"
 #include "boost/assign/list_inserter.hpp"
 #include "ForecastsPointer.h"
@@ -20,7 +19,6 @@
 
 using namespace std;
 using namespace boost;
-using namespace boost::bimaps;
 
 CPPUNIT_TEST_SUITE_REGISTRATION(testAnEnIS);
 
@@ -6,11 +6,14 @@
  */
 #include "Profiler.h"
 #include "AnEnISMPI.h"
+#include "AnEnSSEMPI.h"
+#include "Functions.h"
 #include "testAnEnMPI.h"
 #include "ForecastsPointer.h"
 #include "ObservationsPointer.h"
 
 #include <stdlib.h>
+#include <cmath>
 
 using namespace std;
 
@@ -117,3 +120,422 @@ testAnEnMPI::testCompute_() {
 
     return;
 }
+
+void
+testAnEnMPI::testComputeSSE_() {
+
+    /*
+     * Compare the results from serial and MPI AnEnSSE. Search stations of
+     * a worker include halo stations from other workers.
+     */
+    Config config;
+    config.save_analogs = true;
+    config.save_analogs_time_index = true;
+    config.save_sims = true;
+    config.save_sims_time_index = true;
+    config.save_sims_station_index = true;
+    config.num_nearest = 5;
+    config.distance = 2.5;
+    config.verbose = Verbose::Warning;
+
+    for (int extend_obs = 0; extend_obs < 2; ++extend_obs) {
+
+        config.extend_obs = extend_obs;
+        AnEnSSE anen_serial(config);
+
+        ForecastsPointer forecasts;
+        ObservationsPointer observations;
+        Times test_times, search_times;
+
+        if (rank == 0) {
+
+            Parameters parameters;
+            Stations stations;
+            Times forecast_times, observation_times, flts;
+
+            parameters.push_back(Parameter("wspd", false));
+            parameters.push_back(Parameter("wdir", true));
+            parameters.push_back(Parameter("temp", false));
+
+            // Stations on a 6 x 5 grid
+            for (int i = 0; i < 6; ++i) for (int j = 0; j < 5; ++j) stations.push_back(Station(i, j));
+            for (int i = 0; i < 60; ++i) forecast_times.push_back(i * 10);
+            for (int i = 0; i < 700; ++i) observation_times.push_back(i);
+            for (int i = 0; i < 3; ++i) flts.push_back(i);
+
+            forecasts.setDimensions(parameters, stations, forecast_times, flts);
+            observations.setDimensions(parameters, stations, observation_times);
+
+            double *forecast_ptr = forecasts.getValuesPtr();
+            for (int i = 0; i < forecasts.num_elements(); ++i) forecast_ptr[i] = rand() / 100.0;
+
+            double *observation_ptr = observations.getValuesPtr();
+            for (int i = 0; i < observations.num_elements(); ++i) observation_ptr[i] = rand() / 100.0;
+
+            for (int i = 50; i < 60; ++i) test_times.push_back(i * 10);
+            for (int i = 0; i < 50; ++i) search_times.push_back(i * 10);
+
+            anen_serial.compute(forecasts, observations, test_times, search_times);
+        }
+
+        AnEnSSEMPI anen_mpi(config);
+        anen_mpi.compute(forecasts, observations, test_times, search_times);
+
+        if (rank == 0) {
+            CPPUNIT_ASSERT(anen_serial.search_stations() == anen_mpi.search_stations());
+            CPPUNIT_ASSERT(anen_serial.sds() == anen_mpi.sds());
+            CPPUNIT_ASSERT(anen_serial.sims_metric() == anen_mpi.sims_metric());
+            CPPUNIT_ASSERT(anen_serial.sims_time_index() == anen_mpi.sims_time_index());
+            CPPUNIT_ASSERT(anen_serial.sims_station_index() == anen_mpi.sims_station_index());
+            CPPUNIT_ASSERT(anen_serial.analogs_value() == anen_mpi.analogs_value());
+            CPPUNIT_ASSERT(anen_serial.analogs_time_index() == anen_mpi.analogs_time_index());
+        }
+    }
+
+    return;
+}
+
+void
+testAnEnMPI::testComputeSSEStations_() {
+
+    /*
+     * AnEnSSEMPI does not support different stations in forecasts and
+     * observations. All processes should throw before anything is scattered.
+     */
+    Config config;
+    config.num_nearest = 3;
+    config.verbose = Verbose::Warning;
+
+    ForecastsPointer forecasts;
+    ObservationsPointer observations;
+    Times test_times, search_times;
+
+    if (rank == 0) {
+
+        Parameters parameters;
+        Stations forecast_stations, observation_stations;
+        Times times, flts;
+
+        parameters.push_back(Parameter("temp", false));
+        for (int i = 0; i < 6; ++i) forecast_stations.push_back(Station(i, 0));
+        for (int i = 0; i < 5; ++i) observation_stations.push_back(Station(i, 0));
+        for (int i = 0; i < 10; ++i) times.push_back(i * 10);
+        flts.push_back(0);
+
+        forecasts.setDimensions(parameters, forecast_stations, times, flts);
+        observations.setDimensions(parameters, observation_stations, times);
+
+        test_times.push_back(90);
+        for (int i = 0; i < 9; ++i) search_times.push_back(i * 10);
+    }
+
+    AnEnSSEMPI anen_mpi(config);
+    CPPUNIT_ASSERT_THROW(anen_mpi.compute(forecasts, observations, test_times, search_times), runtime_error);
+
+    return;
+}
+
+void
+testAnEnMPI::testComputeDistributed_() {
+
+    /*
+     * Workers hold their own stations, as if read by AnEnReadNcdfMPI, and
+     * the master only holds dimensions. Results should be the same as
+     * the serial AnEn.
+     */
+    Config config;
+    config.save_analogs = true;
+    config.save_analogs_time_index = true;
+    config.save_sims = true;
+    config.save_sims_time_index = true;
+    config.verbose = Verbose::Warning;
+
+    Parameters parameters;
+    Stations stations;
+    Times forecast_times, observation_times, flts;
+
+    parameters.push_back(Parameter("wspd", false));
+    parameters.push_back(Parameter("wdir", true));
+    parameters.push_back(Parameter("temp", false));
+
+    for (int i = 0; i < 6; ++i) for (int j = 0; j < 5; ++j) stations.push_back(Station(i, j));
+    for (int i = 0; i < 60; ++i) forecast_times.push_back(i * 10);
+    for (int i = 0; i < 700; ++i) observation_times.push_back(i);
+    for (int i = 0; i < 3; ++i) flts.push_back(i);
+
+    // All processes generate the same values
+    ForecastsPointer all_forecasts;
+    ObservationsPointer all_observations;
+
+    all_forecasts.setDimensions(parameters, stations, forecast_times, flts);
+    all_observations.setDimensions(parameters, stations, observation_times);
+
+    srand(1);
+
+    double *forecast_ptr = all_forecasts.getValuesPtr();
+    for (int i = 0; i < all_forecasts.num_elements(); ++i) forecast_ptr[i] = rand() / 100.0;
+
+    double *observation_ptr = all_observations.getValuesPtr();
+    for (int i = 0; i < all_observations.num_elements(); ++i) observation_ptr[i] = rand() / 100.0;
+
+    ForecastsPointer forecasts;
+    ObservationsPointer observations;
+    Times test_times, search_times;
+
+    size_t num_stations = stations.size();
+    int num_working_procs = num_procs;
+    if (num_working_procs > (int) num_stations + 1) num_working_procs = num_stations + 1;
+
+    if (rank == 0) {
+        // The master only has dimensions
+        forecasts.setMembers(parameters, stations, forecast_times);
+        forecasts.getFLTs() = flts;
+        observations.setMembers(parameters, stations, observation_times);
+
+        for (int i = 50; i < 60; ++i) test_times.push_back(i * 10);
+        for (int i = 0; i < 50; ++i) search_times.push_back(i * 10);
+
+    } else if (rank < num_working_procs) {
+        // Workers have their own stations
+        Stations proc_stations;
+        size_t start = Functions::getStartIndex(num_stations, num_working_procs, rank);
+        size_t count = Functions::getSubTotal(num_stations, num_working_procs, rank);
+        for (size_t i = start; i < start + count; ++i) proc_stations.push_back(stations.getStation(i));
+
+        all_forecasts.subset(parameters, proc_stations, forecast_times, flts, forecasts);
+        all_observations.subset(parameters, proc_stations, observation_times, observations);
+    }
+
+    AnEnIS anen_serial(config);
+    if (rank == 0) anen_serial.compute(all_forecasts, all_observations, test_times, search_times);
+
+    AnEnISMPI anen_mpi(config);
+    anen_mpi.compute(forecasts, observations, test_times, search_times);
+
+    if (rank == 0) {
+        CPPUNIT_ASSERT(anen_serial.sds() == anen_mpi.sds());
+        CPPUNIT_ASSERT(anen_serial.sims_metric() == anen_mpi.sims_metric());
+        CPPUNIT_ASSERT(anen_serial.sims_time_index() == anen_mpi.sims_time_index());
+        CPPUNIT_ASSERT(anen_serial.analogs_value() == anen_mpi.analogs_value());
+        CPPUNIT_ASSERT(anen_serial.analogs_time_index() == anen_mpi.analogs_time_index());
+    }
+
+    return;
+}
+
+void
+testAnEnMPI::testComputeDistributedStations_() {
+
+    /*
+     * The first worker misses a station. All processes should throw,
+     * including the master and the workers with correct stations.
+     */
+    Config config;
+    config.verbose = Verbose::Warning;
+
+    Parameters parameters;
+    Stations stations;
+    Times forecast_times, observation_times, flts;
+
+    parameters.push_back(Parameter("temp", false));
+    for (int i = 0; i < 10; ++i) stations.push_back(Station(i, 0));
+    for (int i = 0; i < 20; ++i) forecast_times.push_back(i * 10);
+    for (int i = 0; i < 200; ++i) observation_times.push_back(i);
+    flts.push_back(0);
+
+    ForecastsPointer forecasts;
+    ObservationsPointer observations;
+    Times test_times, search_times;
+
+    size_t num_stations = stations.size();
+    int num_working_procs = num_procs;
+    if (num_working_procs > (int) num_stations + 1) num_working_procs = num_stations + 1;
+
+    if (rank == 0) {
+        forecasts.setMembers(parameters, stations, forecast_times);
+        forecasts.getFLTs() = flts;
+        observations.setMembers(parameters, stations, observation_times);
+
+        for (int i = 15; i < 20; ++i) test_times.push_back(i * 10);
+        for (int i = 0; i < 15; ++i) search_times.push_back(i * 10);
+
+    } else if (rank < num_working_procs) {
+        Stations proc_stations;
+        size_t start = Functions::getStartIndex(num_stations, num_working_procs, rank);
+        size_t count = Functions::getSubTotal(num_stations, num_working_procs, rank);
+        if (rank == 1) --count;
+        for (size_t i = start; i < start + count; ++i) proc_stations.push_back(stations.getStation(i));
+
+        forecasts.setDimensions(parameters, proc_stations, forecast_times, flts);
+        observations.setDimensions(parameters, proc_stations, observation_times);
+        forecasts.initialize(1);
+        observations.initialize(1);
+    }
+
+    AnEnISMPI anen_mpi(config);
+    CPPUNIT_ASSERT_THROW(anen_mpi.compute(forecasts, observations, test_times, search_times), runtime_error);
+
+    return;
+}
+
+void
+testAnEnMPI::testComputeDynamic_() {
+
+    /*
+     * Chunks of stations are dispatched to workers on request. Some stations
+     * have many missing observations so that chunks have different sizes.
+     */
+    Config config;
+    config.save_analogs = true;
+    config.save_analogs_time_index = true;
+    config.save_sims = true;
+    config.save_sims_time_index = true;
+    config.dynamic_chunks = 3;
+    config.verbose = Verbose::Warning;
+
+    for (int operation = 0; operation < 2; ++operation) {
+
+        config.operation = operation;
+        AnEnIS anen_serial(config);
+
+        ForecastsPointer forecasts;
+        ObservationsPointer observations;
+        Times test_times, search_times;
+
+        if (rank == 0) {
+
+            Parameters parameters;
+            Stations stations;
+            Times forecast_times, observation_times, flts;
+
+            parameters.push_back(Parameter("wspd", false));
+            parameters.push_back(Parameter("wdir", true));
+            parameters.push_back(Parameter("temp", false));
+
+            for (int i = 0; i < 25; ++i) stations.push_back(Station(i, i));
+            for (int i = 0; i < 60; ++i) forecast_times.push_back(i * 10);
+            for (int i = 0; i < 700; ++i) observation_times.push_back(i);
+            for (int i = 0; i < 3; ++i) flts.push_back(i);
+
+            forecasts.setDimensions(parameters, stations, forecast_times, flts);
+            observations.setDimensions(parameters, stations, observation_times);
+
+            double *forecast_ptr = forecasts.getValuesPtr();
+            for (int i = 0; i < forecasts.num_elements(); ++i) forecast_ptr[i] = rand() / 100.0;
+
+            double *observation_ptr = observations.getValuesPtr();
+            for (int i = 0; i < observations.num_elements(); ++i) observation_ptr[i] = rand() / 100.0;
+
+            // The first 10 stations miss most observations
+            for (int station_i = 0; station_i < 10; ++station_i) {
+                for (int time_i = 0; time_i < 700; ++time_i) {
+                    if (time_i % 4 != 0) observations.setValue(NAN, 0, station_i, time_i);
+                }
+            }
+
+            for (int i = 50; i < 60; ++i) test_times.push_back(i * 10);
+            for (int i = 0; i < 50; ++i) search_times.push_back(i * 10);
+
+            anen_serial.compute(forecasts, observations, test_times, search_times);
+        }
+
+        AnEnISMPI anen_mpi(config);
+        anen_mpi.compute(forecasts, observations, test_times, search_times);
+
+        if (rank == 0) {
+            CPPUNIT_ASSERT(anen_serial.sds() == anen_mpi.sds());
+            CPPUNIT_ASSERT(anen_serial.sims_metric() == anen_mpi.sims_metric());
+            CPPUNIT_ASSERT(anen_serial.sims_time_index() == anen_mpi.sims_time_index());
+            CPPUNIT_ASSERT(anen_serial.analogs_value() == anen_mpi.analogs_value());
+            CPPUNIT_ASSERT(anen_serial.analogs_time_index() == anen_mpi.analogs_time_index());
+
+            anen_mpi.getProfile().summary(cout);
+        }
+    }
+
+    return;
+}
+
+void
+testAnEnMPI::testComputeNoGather_() {
+
+    /*
+     * Results are not gathered. Each process should hold the results of
+     * its own stations, and stations of all processes should be contiguous.
+     */
+    Config config;
+    config.save_analogs = true;
+    config.save_analogs_time_index = true;
+    config.save_sims = true;
+    config.verbose = Verbose::Warning;
+
+    Parameters parameters;
+    Stations stations;
+    Times forecast_times, observation_times, flts;
+
+    parameters.push_back(Parameter("wspd", false));
+    parameters.push_back(Parameter("wdir", true));
+    parameters.push_back(Parameter("temp", false));
+
+    for (int i = 0; i < 23; ++i) stations.push_back(Station(i, i));
+    for (int i = 0; i < 60; ++i) forecast_times.push_back(i * 10);
+    for (int i = 0; i < 700; ++i) observation_times.push_back(i);
+    for (int i = 0; i < 3; ++i) flts.push_back(i);
+
+    // All processes generate the same values for the serial AnEn
+    ForecastsPointer forecasts(parameters, stations, forecast_times, flts);
+    ObservationsPointer observations(parameters, stations, observation_times);
+
+    double *forecast_ptr = forecasts.getValuesPtr();
+    for (int i = 0; i < forecasts.num_elements(); ++i) forecast_ptr[i] = i % 97 + i / 1000.0;
+
+    double *observation_ptr = observations.getValuesPtr();
+    for (int i = 0; i < observations.num_elements(); ++i) observation_ptr[i] = i % 89 + i / 500.0;
+
+    Times test_times, search_times;
+    for (int i = 50; i < 60; ++i) test_times.push_back(i * 10);
+    for (int i = 0; i < 50; ++i) search_times.push_back(i * 10);
+
+    AnEnIS anen_serial(config);
+    anen_serial.compute(forecasts, observations, test_times, search_times);
+
+    // Only the master passes data to AnEnISMPI
+    ForecastsPointer empty_forecasts;
+    ObservationsPointer empty_observations;
+    Times empty_times;
+
+    AnEnISMPI anen_mpi(config);
+    anen_mpi.setGatherResults(false);
+
+    if (rank == 0) anen_mpi.compute(forecasts, observations, test_times, search_times);
+    else anen_mpi.compute(empty_forecasts, empty_observations, empty_times, empty_times);
+
+    size_t station_start = anen_mpi.getStationStart();
+    size_t station_count = anen_mpi.getStationCount();
+
+    CPPUNIT_ASSERT(anen_mpi.analogs_value().shape()[0] == station_count);
+    CPPUNIT_ASSERT(anen_mpi.sims_metric().shape()[0] == station_count);
+
+    for (size_t station_i = 0; station_i < station_count; ++station_i) {
+        for (size_t test_i = 0; test_i < test_times.size(); ++test_i) {
+            for (size_t flt_i = 0; flt_i < flts.size(); ++flt_i) {
+                for (size_t member_i = 0; member_i < config.num_analogs; ++member_i) {
+                    double expected = anen_serial.analogs_value().getValue(station_start + station_i, test_i, flt_i, member_i);
+                    double actual = anen_mpi.analogs_value().getValue(station_i, test_i, flt_i, member_i);
+                    CPPUNIT_ASSERT(expected == actual || (std::isnan(expected) && std::isnan(actual)));
+
+                    expected = anen_serial.analogs_time_index().getValue(station_start + station_i, test_i, flt_i, member_i);
+                    actual = anen_mpi.analogs_time_index().getValue(station_i, test_i, flt_i, member_i);
+                    CPPUNIT_ASSERT(expected == actual || (std::isnan(expected) && std::isnan(actual)));
+                }
+            }
+        }
+    }
+
+    // All stations are covered exactly once
+    unsigned long total_count = 0, local_count = station_count;
+    MPI_Allreduce(&local_count, &total_count, 1, MPI_UNSIGNED_LONG, MPI_SUM, MPI_COMM_WORLD);
+    CPPUNIT_ASSERT(total_count == stations.size());
+
+    return;
+}
@@ -14,6 +14,12 @@ class testAnEnMPI : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST_SUITE(testAnEnMPI);
 
     CPPUNIT_TEST(testCompute_);
+    CPPUNIT_TEST(testComputeSSE_);
+    CPPUNIT_TEST(testComputeSSEStations_);
+    CPPUNIT_TEST(testComputeDistributed_);
+    CPPUNIT_TEST(testComputeDistributedStations_);
+    CPPUNIT_TEST(testComputeDynamic_);
+    CPPUNIT_TEST(testComputeNoGather_);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -28,6 +34,12 @@ public:
 
 private:
     void testCompute_();
+    void testComputeSSE_();
+    void testComputeSSEStations_();
+    void testComputeDistributed_();
+    void testComputeDistributedStations_();
+    void testComputeDynamic_();
+    void testComputeNoGather_();
 
 };
 
@@ -0,0 +1,164 @@
+/*
+ * File:   testAnEnReadBinary.cpp
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#include "testAnEnReadBinary.h"
+#include "AnEnReadBinary.h"
+#include "AnEnWriteBinary.h"
+#include "ForecastsPointer.h"
+#include "ObservationsPointer.h"
+
+#include <cmath>
+#include <boost/filesystem.hpp>
+#include <boost/assign/list_of.hpp>
+#include <boost/assign/list_inserter.hpp>
+
+using namespace std;
+using namespace boost;
+
+namespace filesys = boost::filesystem;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testAnEnReadBinary);
+
+testAnEnReadBinary::testAnEnReadBinary() {
+}
+
+testAnEnReadBinary::~testAnEnReadBinary() {
+}
+
+void
+testAnEnReadBinary::testForecasts_() {
+    /**
+     * Test that forecasts are the same after writing and mapping
+     */
+    Station s1, s2(10, 20, "Hunan"), s3(5, 5), s4(30, 40, "Guangdong");
+    Stations stations;
+    assign::push_back(stations.left)(0, s1)(1, s2)(2, s3)(3, s4);
+
+    Parameter p1, p2("temperature"), p3("wind direction", true);
+    Parameters parameters;
+    assign::push_back(parameters.left)(0, p1)(1, p2)(2, p3);
+
+    Times times;
+    for (size_t i = 0; i < 5; ++i) times.push_back(Time(i * 86400));
+
+    Times flts;
+    assign::push_back(flts.left)(0, Time(0))(1, Time(3600))(2, Time(7200));
+
+    ForecastsPointer forecasts(parameters, stations, times, flts);
+    double *ptr = forecasts.getValuesPtr();
+    for (size_t i = 0; i < forecasts.num_elements(); ++i) ptr[i] = i;
+    ptr[7] = NAN;
+
+    string file = (filesys::temp_directory_path() / filesys::unique_path("%%%%-%%%%.anb")).string();
+
+    AnEnWriteBinary anen_write(Verbose::Warning);
+    anen_write.writeForecasts(file, forecasts);
+
+    // Files are not overwritten by default
+    CPPUNIT_ASSERT_THROW(anen_write.writeForecasts(file, forecasts), runtime_error);
+    CPPUNIT_ASSERT(AnEnReadBinary::isBinary(file));
+
+    AnEnReadBinary anen_read(Verbose::Warning);
+
+    // Files with a different type are rejected
+    ObservationsPointer observations;
+    CPPUNIT_ASSERT_THROW(anen_read.readObservations(file, observations), runtime_error);
+
+    ForecastsPointer forecasts_read;
+    anen_read.readForecasts(file, forecasts_read);
+
+    CPPUNIT_ASSERT(forecasts_read.getParameters().size() == parameters.size());
+    for (size_t i = 0; i < parameters.size(); ++i)
+        CPPUNIT_ASSERT(forecasts_read.getParameters().getParameter(i) == parameters.getParameter(i));
+    CPPUNIT_ASSERT(forecasts_read.getParameters().getParameter(2).getCircular());
+
+    CPPUNIT_ASSERT(forecasts_read.getStations().size() == stations.size());
+    for (size_t i = 0; i < stations.size(); ++i)
+        CPPUNIT_ASSERT(forecasts_read.getStations().getStation(i) == stations.getStation(i));
+
+    CPPUNIT_ASSERT(forecasts_read.getTimes().size() == times.size());
+    for (size_t i = 0; i < times.size(); ++i)
+        CPPUNIT_ASSERT(forecasts_read.getTimes().getTime(i) == times.getTime(i));
+
+    CPPUNIT_ASSERT(forecasts_read.getFLTs().size() == flts.size());
+    for (size_t i = 0; i < flts.size(); ++i)
+        CPPUNIT_ASSERT(forecasts_read.getFLTs().getTime(i) == flts.getTime(i));
+
+    CPPUNIT_ASSERT(forecasts_read.Array4DPointer::operator==(forecasts));
+
+    // Values are modified in memory but the file stays the same
+    forecasts_read.setValue(-1, 0, 0, 0, 0);
+    CPPUNIT_ASSERT(forecasts_read.getValue(0, 0, 0, 0) == -1);
+
+    ForecastsPointer forecasts_again;
+    anen_read.readForecasts(file, forecasts_again);
+    CPPUNIT_ASSERT(forecasts_again.getValue(0, 0, 0, 0) == 0);
+
+    // Read a range of stations
+    ForecastsPointer forecasts_range;
+    anen_read.readForecasts(file, forecasts_range, 1, 2);
+    CPPUNIT_ASSERT(forecasts_range.getStations().size() == 2);
+    CPPUNIT_ASSERT(forecasts_range.getStations().getStation(0) == s2);
+
+    for (size_t parameter_i = 0; parameter_i < parameters.size(); ++parameter_i)
+        for (size_t station_i = 0; station_i < 2; ++station_i)
+            for (size_t time_i = 0; time_i < times.size(); ++time_i)
+                for (size_t flt_i = 0; flt_i < flts.size(); ++flt_i) {
+                    double value = forecasts.getValue(parameter_i, station_i + 1, time_i, flt_i);
+                    double value_range = forecasts_range.getValue(parameter_i, station_i, time_i, flt_i);
+                    CPPUNIT_ASSERT((std::isnan(value) && std::isnan(value_range)) || value == value_range);
+                }
+
+    CPPUNIT_ASSERT_THROW(anen_read.readForecasts(file, forecasts_range, 3, 2), range_error);
+
+    filesys::remove(file);
+}
+
+void
+testAnEnReadBinary::testObservations_() {
+    /**
+     * Test that observations are the same after writing and mapping
+     */
+    Station s1(1, 2, "a"), s2(3, 4, "b"), s3(5, 6, "c");
+    Stations stations;
+    assign::push_back(stations.left)(0, s1)(1, s2)(2, s3);
+
+    Parameter p1("temperature"), p2("humidity");
+    Parameters parameters;
+    assign::push_back(parameters.left)(0, p1)(1, p2);
+
+    Times times;
+    for (size_t i = 0; i < 10; ++i) times.push_back(Time(i * 3600));
+
+    ObservationsPointer observations(parameters, stations, times);
+    double *ptr = observations.getValuesPtr();
+    for (size_t i = 0; i < observations.num_elements(); ++i) ptr[i] = i * 0.5;
+
+    string file = (filesys::temp_directory_path() / filesys::unique_path("%%%%-%%%%.anb")).string();
+
+    AnEnWriteBinary anen_write(Verbose::Warning);
+    anen_write.writeObservations(file, observations);
+
+    AnEnReadBinary anen_read(Verbose::Warning);
+    ObservationsPointer observations_read, observations_range;
+    anen_read.readObservations(file, observations_read);
+    anen_read.readObservations(file, observations_range, 2, 1);
+
+    CPPUNIT_ASSERT(observations_read.getParameters().size() == parameters.size());
+    CPPUNIT_ASSERT(observations_read.getStations().size() == stations.size());
+    CPPUNIT_ASSERT(observations_read.getTimes().size() == times.size());
+    CPPUNIT_ASSERT(observations_range.getStations().getStation(0) == s3);
+    CPPUNIT_ASSERT(observations_range.getStations().size() == 1);
+
+    for (size_t parameter_i = 0; parameter_i < parameters.size(); ++parameter_i)
+        for (size_t station_i = 0; station_i < stations.size(); ++station_i)
+            for (size_t time_i = 0; time_i < times.size(); ++time_i) {
+                double value = observations.getValue(parameter_i, station_i, time_i);
+                CPPUNIT_ASSERT(observations_read.getValue(parameter_i, station_i, time_i) == value);
+                if (station_i == 2) CPPUNIT_ASSERT(observations_range.getValue(parameter_i, 0, time_i) == value);
+            }
+
+    filesys::remove(file);
+}
@@ -0,0 +1,30 @@
+/*
+ * File:   testAnEnReadBinary.h
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#ifndef TESTANENREADBINARY_H
+#define TESTANENREADBINARY_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class testAnEnReadBinary : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(testAnEnReadBinary);
+    
+    CPPUNIT_TEST(testForecasts_);
+    CPPUNIT_TEST(testObservations_);
+    
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    testAnEnReadBinary();
+    virtual ~testAnEnReadBinary();
+    
+    void testForecasts_();
+    void testObservations_();
+
+private:
+    
+};
+
+#endif /* TESTANENREADBINARY_H */
@@ -13,14 +13,12 @@
 #include "ForecastsPointer.h"
 #include "ObservationsPointer.h"
 
-#include "boost/bimap/bimap.hpp"
 #include "boost/assign/list_of.hpp"
 #include "boost/assign/list_inserter.hpp"
 #include "boost/numeric/ublas/matrix_proxy.hpp"
 
 using namespace std;
 using namespace boost;
-using namespace boost::bimaps;
 
 CPPUNIT_TEST_SUITE_REGISTRATION(testAnEnSSE);
 
@@ -293,3 +291,84 @@ testAnEnSSE::testMultiAnEn_() {
         CPPUNIT_ASSERT(analogs.getValuesPtr()[i] == analogs_queried.getValuesPtr()[i]);
     }
 }
+
+void
+testAnEnSSE::testRestoreStationOrder_() {
+
+    /*
+     * Test that results from reordered stations are the same as results
+     * from the original stations after the order is restored
+     */
+    Parameters parameters;
+    Stations stations;
+    Times fcst_times, flts, obs_times;
+
+    assign::push_back(parameters.left)(0, Parameter("par_1"))(1, Parameter("par_2", true));
+
+    // Create 25 stations on a grid
+    for (size_t i = 0; i < 25; ++i) stations.push_back(Station(i % 5, i / 5));
+
+    for (size_t i = 0; i < 20; ++i) fcst_times.push_back(i * 100);
+    assign::push_back(flts.left)(0, Time(0))(1, Time(50));
+    for (size_t i = 0; i < 50; ++i) obs_times.push_back(Time(i * 50));
+
+    ForecastsPointer fcsts(parameters, stations, fcst_times, flts);
+    ObservationsPointer obs(parameters, stations, obs_times);
+
+    for (size_t i = 0; i < fcsts.num_elements(); ++i) fcsts.getValuesPtr()[i] = (rand() % 10000) / 100.0;
+    for (size_t i = 0; i < obs.num_elements(); ++i) obs.getValuesPtr()[i] = (rand() % 10000) / 100.0;
+
+    // Reorder stations
+    vector<size_t> order;
+    Functions::spaceFillingOrder(stations, order);
+
+    ForecastsPointer fcsts_sorted(fcsts);
+    ObservationsPointer obs_sorted(obs);
+    Functions::reorderStations(fcsts_sorted, order);
+    Functions::reorderStations(obs_sorted, order);
+
+    Config config;
+    config.extend_obs = true;
+    config.num_analogs = 5;
+    config.num_sims = 5;
+    config.num_nearest = 9;
+    config.distance = 1;
+    config.save_sims_station_index = true;
+    config.save_analogs_time_index = true;
+
+    vector<size_t> fcsts_test_index = {18, 19};
+    vector<size_t> fcsts_search_index(18);
+    iota(fcsts_search_index.begin(), fcsts_search_index.end(), 0);
+
+    AnEnSSE anen(config), anen_sorted(config);
+    anen.compute(fcsts, obs, fcsts_test_index, fcsts_search_index);
+    anen_sorted.compute(fcsts_sorted, obs_sorted, fcsts_test_index, fcsts_search_index);
+    anen_sorted.restoreStationOrder(order);
+
+    // Compare results
+    const Array4DPointer & analogs = anen.analogs_value();
+    const Array4DPointer & analogs_sorted = anen_sorted.analogs_value();
+
+    for (size_t i = 0; i < analogs.num_elements(); ++i) {
+        CPPUNIT_ASSERT(analogs.getValuesPtr()[i] == analogs_sorted.getValuesPtr()[i]);
+        CPPUNIT_ASSERT(anen.analogs_time_index().getValuesPtr()[i] == anen_sorted.analogs_time_index().getValuesPtr()[i]);
+        CPPUNIT_ASSERT(anen.sims_station_index().getValuesPtr()[i] == anen_sorted.sims_station_index().getValuesPtr()[i]);
+    }
+
+    for (size_t i = 0; i < anen.sds().num_elements(); ++i) {
+        CPPUNIT_ASSERT(anen.sds().getValuesPtr()[i] == anen_sorted.sds().getValuesPtr()[i]);
+    }
+
+    // Equally distant neighbors can be listed in a different order
+    const Neighbors & neighbors = anen.search_stations();
+    const Neighbors & neighbors_sorted = anen_sorted.search_stations();
+    CPPUNIT_ASSERT(neighbors.offsets == neighbors_sorted.offsets);
+
+    for (size_t station_i = 0; station_i < neighbors.size(); ++station_i) {
+        vector<uint32_t> lhs(neighbors.begin(station_i), neighbors.end(station_i));
+        vector<uint32_t> rhs(neighbors_sorted.begin(station_i), neighbors_sorted.end(station_i));
+        sort(lhs.begin(), lhs.end());
+        sort(rhs.begin(), rhs.end());
+        CPPUNIT_ASSERT(lhs == rhs);
+    }
+}
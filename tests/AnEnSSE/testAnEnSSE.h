@@ -15,6 +15,7 @@ class testAnEnSSE : public CPPUNIT_NS::TestFixture {
 
     CPPUNIT_TEST(testCompute_);
     CPPUNIT_TEST(testMultiAnEn_);
+    CPPUNIT_TEST(testRestoreStationOrder_);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -25,6 +26,7 @@ public:
 private:
     void testCompute_();
     void testMultiAnEn_();
+    void testRestoreStationOrder_();
 };
 
 #endif /* TESTANEN_H */
@@ -13,14 +13,12 @@
 #include "ForecastsPointer.h"
 #include "ObservationsPointer.h"
 
-#include "boost/bimap/bimap.hpp"
 #include "boost/assign/list_of.hpp"
 #include "boost/assign/list_inserter.hpp"
 #include "boost/numeric/ublas/matrix_proxy.hpp"
 
 using namespace std;
 using namespace boost;
-using namespace boost::bimaps;
 
 CPPUNIT_TEST_SUITE_REGISTRATION(testAnEnSSEMS);
 
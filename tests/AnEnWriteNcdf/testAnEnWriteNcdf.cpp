@@ -0,0 +1,133 @@
+/*
+ * File:   testAnEnWriteNcdf.cpp
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#include "testAnEnWriteNcdf.h"
+#include "AnEnWriteNcdf.h"
+#include "AnEnReadNcdf.h"
+#include "AnEnIS.h"
+#include "Functions.h"
+#include "ForecastsPointer.h"
+#include "ObservationsPointer.h"
+
+#include <cmath>
+#include <numeric>
+#include <boost/filesystem.hpp>
+
+using namespace std;
+using namespace netCDF;
+
+namespace filesys = boost::filesystem;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testAnEnWriteNcdf);
+
+static bool
+sameIndices(const Array4D & lhs, const Array4D & rhs) {
+    if (lhs.num_elements() != rhs.num_elements()) return false;
+
+    const double *p_lhs = lhs.getValuesPtr(), *p_rhs = rhs.getValuesPtr();
+
+    for (size_t i = 0; i < lhs.num_elements(); ++i) {
+        if (std::isnan(p_lhs[i]) && std::isnan(p_rhs[i])) continue;
+        if (p_lhs[i] != p_rhs[i]) return false;
+    }
+
+    return true;
+}
+
+testAnEnWriteNcdf::testAnEnWriteNcdf() {
+}
+
+testAnEnWriteNcdf::~testAnEnWriteNcdf() {
+}
+
+void
+testAnEnWriteNcdf::testIndexRoundTrip_() {
+    /**
+     * Test that analog and similarity time indices are the same after
+     * writing AnEn by stations and reading it back. Similarity time indices
+     * point to forecast times, and there are more forecast times than an
+     * unsigned short can index. Analog time indices point to observation
+     * times which are much fewer.
+     */
+    Parameters parameters;
+    parameters.push_back(Parameter("temperature"));
+
+    Stations stations;
+    stations.push_back(Station(0, 0));
+    stations.push_back(Station(10, 10));
+
+    Times flts;
+    flts.push_back(Time(0));
+
+    size_t num_fcst_times = 70000, num_obs_times = 20;
+
+    // Observations are only available for the last forecast times
+    Times fcst_times, obs_times;
+    for (size_t i = 0; i < num_fcst_times; ++i) fcst_times.push_back(Time(i * 3600));
+    for (size_t i = num_fcst_times - num_obs_times; i < num_fcst_times; ++i) obs_times.push_back(Time(i * 3600));
+
+    ForecastsPointer forecasts(parameters, stations, fcst_times, flts);
+    ObservationsPointer observations(parameters, stations, obs_times);
+
+    Functions::randomizeForecasts(forecasts, 0);
+    Functions::randomizeObservations(observations, 0);
+
+    Config config;
+    config.num_analogs = 5;
+    config.num_sims = 5;
+    config.operation = false;
+    config.prevent_search_future = false;
+    config.quick_sort = false;
+    config.verbose = Verbose::Warning;
+    config.obs_var_index = 0;
+    config.save_sims = true;
+    config.save_sims_time_index = true;
+    config.save_analogs_time_index = true;
+
+    vector<size_t> fcsts_test_index = {num_fcst_times - 1};
+    vector<size_t> fcsts_search_index(num_fcst_times);
+    iota(fcsts_search_index.begin(), fcsts_search_index.end(), 0);
+
+    AnEnIS anen(config);
+    anen.compute(forecasts, observations, fcsts_test_index, fcsts_search_index);
+
+    Times test_times, search_times;
+    test_times.push_back(fcst_times.getTime(num_fcst_times - 1));
+    for (size_t i = 0; i < num_fcst_times; ++i) search_times.push_back(fcst_times.getTime(i));
+
+    string file = (filesys::temp_directory_path() / filesys::unique_path("%%%%-%%%%.nc")).string();
+
+    AnEnWriteNcdf anen_write(Verbose::Warning);
+    anen_write.createAnEn(file, anen, {}, test_times, search_times, flts,
+            parameters, stations, fcst_times.size(), true);
+    anen_write.writeAnEnStations(file, anen, {}, observations, 0);
+
+    // Analog time indices fit unsigned short but similarity time indices do not
+    NcFile nc(file, NcFile::FileMode::read);
+    CPPUNIT_ASSERT(nc.getVar(Config::_ANALOGS_TIME_IND).getType() == NcType::nc_USHORT);
+    CPPUNIT_ASSERT(nc.getVar(Config::_SIMS_TIME_IND).getType() == NcType::nc_UINT);
+
+    AnEnReadNcdf anen_read(Verbose::Warning);
+
+    Array4DPointer analogs_time_index;
+    anen_read.readAnalogs(file, analogs_time_index, Config::_ANALOGS_TIME_IND);
+    CPPUNIT_ASSERT(sameIndices(analogs_time_index, anen.analogs_time_index()));
+
+    const auto & shape = anen.sims_time_index().shape();
+    Array4DPointer sims_time_index(shape[0], shape[1], shape[2], shape[3]);
+    anen_read.read(nc, sims_time_index.getValuesPtr(), Config::_SIMS_TIME_IND);
+    Ncdf::fillIndexNAN(nc.getVar(Config::_SIMS_TIME_IND), sims_time_index.getValuesPtr(), sims_time_index.num_elements());
+    CPPUNIT_ASSERT(sameIndices(sims_time_index, anen.sims_time_index()));
+
+    // Similarity time indices point to forecast times with observations
+    const double *p_sims = sims_time_index.getValuesPtr();
+    for (size_t i = 0; i < sims_time_index.num_elements(); ++i) {
+        CPPUNIT_ASSERT(p_sims[i] >= num_fcst_times - num_obs_times);
+        CPPUNIT_ASSERT(p_sims[i] < num_fcst_times - 1);
+    }
+
+    nc.close();
+    filesys::remove(file);
+}
@@ -0,0 +1,28 @@
+/*
+ * File:   testAnEnWriteNcdf.h
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#ifndef TESTANENWRITENCDF_H
+#define TESTANENWRITENCDF_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class testAnEnWriteNcdf : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(testAnEnWriteNcdf);
+    
+    CPPUNIT_TEST(testIndexRoundTrip_);
+    
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    testAnEnWriteNcdf();
+    virtual ~testAnEnWriteNcdf();
+    
+    void testIndexRoundTrip_();
+
+private:
+    
+};
+
+#endif /* TESTANENWRITENCDF_H */
@@ -15,7 +15,6 @@
 #include <boost/assign/list_inserter.hpp>
 
 using namespace std;
-using namespace boost::bimaps;
 using namespace boost;
 
 CPPUNIT_TEST_SUITE_REGISTRATION(testForecastsPointer);
@@ -75,6 +74,54 @@ void testForecastsPointer::testCopy_() {
                     CPPUNIT_ASSERT(forecasts.getValue(i, j, k, m) == forecasts_copy.getValue(i, j, k, m));
 }
 
+void testForecastsPointer::testCopyOnWrite_() {
+    /**
+     * Test that copies share values until modified and that moves
+     * transfer values without copying
+     */
+
+    Parameters parameters;
+    assign::push_back(parameters.left)(0, Parameter("temperature"))(1, Parameter("humidity"));
+
+    Stations stations;
+    assign::push_back(stations.left)(0, Station(10, 20))(1, Station(30, 40))(2, Station(15, 23));
+
+    Times times, flts;
+    for (size_t i = 0; i < 5; ++i) times.push_back(Time(i + 1));
+    assign::push_back(flts.left)(0, Time(100))(1, Time(200));
+
+    ForecastsPointer forecasts(parameters, stations, times, flts);
+    iota(forecasts.getValuesPtr(), forecasts.getValuesPtr() + forecasts.num_elements(), 0);
+
+    // Copies share the same memory
+    const ForecastsPointer & forecasts_const = forecasts;
+    ForecastsPointer forecasts_copy = forecasts;
+    const ForecastsPointer & forecasts_copy_const = forecasts_copy;
+    CPPUNIT_ASSERT(forecasts_const.getValuesPtr() == forecasts_copy_const.getValuesPtr());
+
+    // Modifying the copy should not change the original
+    forecasts_copy.setValue(-1, 1, 2, 3, 1);
+    CPPUNIT_ASSERT(forecasts_const.getValuesPtr() != forecasts_copy_const.getValuesPtr());
+    CPPUNIT_ASSERT(forecasts.getValue(1, 2, 3, 1) != -1);
+    CPPUNIT_ASSERT(forecasts_copy.getValue(1, 2, 3, 1) == -1);
+    CPPUNIT_ASSERT(forecasts.getValue(0, 1, 2, 1) == forecasts_copy.getValue(0, 1, 2, 1));
+
+    // Moving should transfer the memory
+    const double * ptr = forecasts_const.getValuesPtr();
+    ForecastsPointer forecasts_moved = std::move(forecasts);
+    const ForecastsPointer & forecasts_moved_const = forecasts_moved;
+
+    CPPUNIT_ASSERT(forecasts_moved_const.getValuesPtr() == ptr);
+    CPPUNIT_ASSERT(forecasts_moved.getStations().size() == stations.size());
+    CPPUNIT_ASSERT(forecasts_const.getValuesPtr() == nullptr);
+    CPPUNIT_ASSERT(forecasts.num_elements() == 0);
+
+    // Dimensions are moved as well and the moved-from object is still usable
+    CPPUNIT_ASSERT(forecasts.getStations().size() == 0);
+    forecasts.getStations().push_back(Station(1, 1));
+    CPPUNIT_ASSERT(forecasts.getStations().size() == 1);
+}
+
 void testForecastsPointer::testForecastSetVectorValues_() {
 
     /**
@@ -17,6 +17,7 @@ class testForecastsPointer : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testSubset_);
     CPPUNIT_TEST(testWind_);
     CPPUNIT_TEST(testCopy_);
+    CPPUNIT_TEST(testCopyOnWrite_);
     
     CPPUNIT_TEST_SUITE_END();
 
@@ -28,6 +29,7 @@ public:
     void testSubset_();
     void testWind_();
     void testCopy_();
+    void testCopyOnWrite_();
 
 private:
     
@@ -0,0 +1,183 @@
+/*
+ * File:   testForecastsView.cpp
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#include "testForecastsView.h"
+#include "ForecastsView.h"
+#include "ForecastsPointer.h"
+#include "ObservationsPointer.h"
+#include "Functions.h"
+#include "AnEnIS.h"
+
+#include <cmath>
+#include <numeric>
+#include <boost/assign/list_of.hpp>
+#include <boost/assign/list_inserter.hpp>
+
+using namespace std;
+using namespace boost;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testForecastsView);
+
+testForecastsView::testForecastsView() {
+}
+
+testForecastsView::~testForecastsView() {
+}
+
+void
+testForecastsView::testView_() {
+    /**
+     * Test that a view has the same values as a materialized subset
+     */
+    Station s1, s2(10, 20, "Hunan"), s3(5, 5), s4(30, 40, "Guangdong"),
+            s5(15, 23), s6(30, 30, "Beijing");
+    Stations stations;
+    assign::push_back(stations.left)(0, s1)(1, s2)(2, s3)(3, s4)(4, s5)(5, s6);
+
+    Parameter p1, p2("temperature"), p3("humidity"), p4("wind direction", true);
+    Parameters parameters;
+    assign::push_back(parameters.left)(0, p1)(1, p2)(2, p3)(3, p4);
+
+    Times times;
+    for (size_t i = 0; i < 10; ++i) times.push_back(Time(i + 1));
+
+    Times flts;
+    assign::push_back(flts.left)(0, Time(100))(1, Time(200))(2, Time(300))(3, Time(400));
+
+    ForecastsPointer forecasts(parameters, stations, times, flts);
+    double *ptr = forecasts.getValuesPtr();
+    for (size_t i = 0; i < forecasts.num_elements(); ++i) ptr[i] = i;
+
+    // Stations are not contiguous. Other dimensions are contiguous.
+    Parameters parameters_subset;
+    assign::push_back(parameters_subset.left)(0, p2)(1, p3);
+
+    Stations stations_subset;
+    assign::push_back(stations_subset.left)(0, s2)(1, s4)(2, s5);
+
+    Times times_subset;
+    for (size_t i = 3; i < 8; ++i) times_subset.push_back(Time(i + 1));
+
+    Times flts_subset;
+    assign::push_back(flts_subset.left)(0, Time(200))(1, Time(300));
+
+    ForecastsView view(forecasts, parameters_subset, stations_subset, times_subset, flts_subset);
+
+    CPPUNIT_ASSERT(view.isStrided(0));
+    CPPUNIT_ASSERT(!view.isStrided(1));
+    CPPUNIT_ASSERT(view.isStrided(2));
+    CPPUNIT_ASSERT(view.isStrided(3));
+
+    ForecastsPointer forecasts_subset;
+    forecasts.subset(parameters_subset, stations_subset, times_subset, flts_subset, forecasts_subset);
+
+    CPPUNIT_ASSERT(view.getParameters() == forecasts_subset.getParameters());
+    CPPUNIT_ASSERT(view.getStations() == forecasts_subset.getStations());
+    CPPUNIT_ASSERT(view.getTimes() == forecasts_subset.getTimes());
+    CPPUNIT_ASSERT(view.getFLTs() == forecasts_subset.getFLTs());
+    CPPUNIT_ASSERT(view.num_elements() == forecasts_subset.num_elements());
+
+    for (size_t i = 0; i < view.shape()[0]; ++i)
+        for (size_t j = 0; j < view.shape()[1]; ++j)
+            for (size_t k = 0; k < view.shape()[2]; ++k)
+                for (size_t m = 0; m < view.shape()[3]; ++m)
+                    CPPUNIT_ASSERT(view.getValue(i, j, k, m) == forecasts_subset.getValue(i, j, k, m));
+
+    // Materialize the view
+    ForecastsPointer view_subset;
+    view.subset(view.getParameters(), view.getStations(), view.getTimes(), view.getFLTs(), view_subset);
+
+    for (size_t i = 0; i < view_subset.num_elements(); ++i)
+        CPPUNIT_ASSERT(view_subset.getValuesPtr()[i] == forecasts_subset.getValuesPtr()[i]);
+
+    // Values seen through the view should not change after the parent is modified
+    double value = view.getValue(0, 0, 0, 0);
+    forecasts.setValue(-1, 1, 1, 3, 1);
+    CPPUNIT_ASSERT(forecasts.getValue(1, 1, 3, 1) == -1);
+    CPPUNIT_ASSERT(view.getValue(0, 0, 0, 0) == value);
+
+    value = view.getValue(1, 2, 4, 1);
+    forecasts.getValuesPtr()[0] = -1;
+    forecasts.setValue(-2, 2, 4, 7, 2);
+    CPPUNIT_ASSERT(view.getValue(1, 2, 4, 1) == value);
+
+    // Views are read-only
+    CPPUNIT_ASSERT_THROW(view.setValue(0, 0, 0, 0, 0), runtime_error);
+    CPPUNIT_ASSERT_THROW(view.getValuesPtr(), runtime_error);
+}
+
+void
+testForecastsView::testCompute_() {
+    /**
+     * Test that analogs generated from a view are identical to analogs
+     * generated from a materialized subset.
+     */
+    Stations stations;
+    for (size_t i = 0; i < 8; ++i) stations.push_back(Station(i, i));
+
+    Parameters parameters;
+    for (size_t i = 0; i < 3; ++i) parameters.push_back(Parameter(to_string(i)));
+
+    Times fcst_times, obs_times, flts;
+    for (size_t i = 0; i < 20; ++i) fcst_times.push_back(Time(i * 86400));
+    for (size_t i = 0; i < 20 * 4; ++i) obs_times.push_back(Time(i * 21600));
+    for (size_t i = 0; i < 4; ++i) flts.push_back(Time(i * 21600));
+
+    ForecastsPointer fcsts(parameters, stations, fcst_times, flts);
+    ObservationsPointer obs(parameters, stations, obs_times);
+
+    Functions::randomizeForecasts(fcsts, 0.1);
+    Functions::randomizeObservations(obs, 0.1);
+
+    Stations stations_subset;
+    stations_subset.push_back(stations.getStation(1));
+    stations_subset.push_back(stations.getStation(4));
+    stations_subset.push_back(stations.getStation(5));
+    stations_subset.push_back(stations.getStation(7));
+
+    ForecastsView fcsts_view(fcsts, parameters, stations_subset, fcst_times, flts);
+
+    ForecastsPointer fcsts_subset;
+    fcsts.subset(parameters, stations_subset, fcst_times, flts, fcsts_subset);
+
+    ObservationsPointer obs_subset;
+    obs.subset(parameters, stations_subset, obs_times, obs_subset);
+
+    Config config;
+    config.num_analogs = 5;
+    config.operation = true;
+    config.obs_var_index = 1;
+    config.save_sims = true;
+    config.save_analogs_time_index = true;
+    config.max_par_nan = parameters.size();
+    config.max_flt_nan = flts.size();
+
+    // Indices are changed during computation so each run has its own copy
+    vector<size_t> fcsts_test_index = {17, 18, 19};
+    vector<size_t> fcsts_search_index(17);
+    iota(fcsts_search_index.begin(), fcsts_search_index.end(), 0);
+
+    vector<size_t> fcsts_test_index_copy = fcsts_test_index;
+    vector<size_t> fcsts_search_index_copy = fcsts_search_index;
+
+    AnEnIS anen_view(config), anen_subset(config);
+    anen_view.compute(fcsts_view, obs_subset, fcsts_test_index, fcsts_search_index);
+    anen_subset.compute(fcsts_subset, obs_subset, fcsts_test_index_copy, fcsts_search_index_copy);
+
+    const Array4DPointer & analogs_view = anen_view.analogs_value();
+    const Array4DPointer & analogs_subset = anen_subset.analogs_value();
+    CPPUNIT_ASSERT(analogs_view.num_elements() == analogs_subset.num_elements());
+
+    for (size_t i = 0; i < analogs_view.num_elements(); ++i) {
+        double lhs = analogs_view.getValuesPtr()[i], rhs = analogs_subset.getValuesPtr()[i];
+        CPPUNIT_ASSERT((std::isnan(lhs) && std::isnan(rhs)) || lhs == rhs);
+    }
+
+    const Array4DPointer & time_index_view = anen_view.analogs_time_index();
+    const Array4DPointer & time_index_subset = anen_subset.analogs_time_index();
+
+    for (size_t i = 0; i < time_index_view.num_elements(); ++i)
+        CPPUNIT_ASSERT(time_index_view.getValuesPtr()[i] == time_index_subset.getValuesPtr()[i]);
+}
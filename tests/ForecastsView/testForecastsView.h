@@ -0,0 +1,30 @@
+/*
+ * File:   testForecastsView.h
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#ifndef TESTFORECASTSVIEW_H
+#define TESTFORECASTSVIEW_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class testForecastsView : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(testForecastsView);
+    
+    CPPUNIT_TEST(testView_);
+    CPPUNIT_TEST(testCompute_);
+    
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    testForecastsView();
+    virtual ~testForecastsView();
+    
+    void testView_();
+    void testCompute_();
+
+private:
+    
+};
+
+#endif /* TESTFORECASTSVIEW_H */
@@ -14,7 +14,6 @@
 #include "ForecastsPointer.h"
 #include "ObservationsPointer.h"
 
-#include "boost/bimap/bimap.hpp"
 #include "boost/numeric/ublas/io.hpp"
 #include "boost/assign/list_of.hpp"
 #include "boost/assign/list_inserter.hpp"
@@ -22,7 +21,6 @@
 #include "boost/lambda/lambda.hpp"
 
 using namespace std;
-using namespace boost::bimaps;
 using namespace boost;
 
 CPPUNIT_TEST_SUITE_REGISTRATION(testFunctions);
@@ -122,7 +120,10 @@ testFunctions::testSearchStations_() {
     CPPUNIT_ASSERT(neighborExists_(table_ce, 0, 2));
     CPPUNIT_ASSERT(neighborExists_(table_ce, 0, 3));
     CPPUNIT_ASSERT(neighborExists_(table_ce, 5, 8));
-    CPPUNIT_ASSERT(neighborExists_(table_ce, 5, 7));
+    // Station 3, 7, and 9 are equally close to station 5. The one with
+    // the smallest index is chosen.
+    //
+    CPPUNIT_ASSERT(neighborExists_(table_ce, 5, 3));
     CPPUNIT_ASSERT(neighborExists_(table_ce, 11, 10));
     CPPUNIT_ASSERT(neighborExists_(table_ce, 11, 8));
     CPPUNIT_ASSERT(neighborExists_(table_ce, 2, 0));
@@ -165,6 +166,98 @@ testFunctions::testSearchStations_() {
     return;
 }
 
+void
+testFunctions::testNeighbors_() {
+
+    /**
+     * Tests that neighbor lists are compact and consistent with the table
+     */
+    Stations stations;
+    for (size_t i = 0; i < 30; ++i) stations.push_back(Station(i % 6, i / 6));
+
+    // Stations at corners have fewer neighbors within the distance
+    size_t num_nearest = 5;
+    double distance = 1;
+
+    Neighbors neighbors;
+    Functions::setSearchStations(stations, neighbors, num_nearest, distance,
+            false, StationsIndex::Metric::Euclidean, true);
+
+    CPPUNIT_ASSERT(neighbors.size() == stations.size());
+    CPPUNIT_ASSERT(neighbors.count(0) == 3);
+    CPPUNIT_ASSERT(neighbors.count(1) == 4);
+    CPPUNIT_ASSERT(neighbors.count(7) == 5);
+    CPPUNIT_ASSERT(neighbors.maxCount() == num_nearest);
+    CPPUNIT_ASSERT(neighbors.indices.size() == neighbors.offsets.back());
+    CPPUNIT_ASSERT(neighbors.distances.size() == neighbors.indices.size());
+
+    // The closest station is the station itself
+    CPPUNIT_ASSERT(*neighbors.begin(7) == 7);
+    CPPUNIT_ASSERT(neighbors.distances[neighbors.offsets[7]] == 0);
+
+    Functions::Matrix table(stations.size(), num_nearest);
+    auto & storage = table.data();
+    fill_n(storage.begin(), storage.size(), NAN);
+
+    Functions::setSearchStations(stations, table, distance);
+
+    for (size_t station_i = 0; station_i < stations.size(); ++station_i) {
+        size_t col_i = 0;
+
+        for (auto it = neighbors.begin(station_i); it != neighbors.end(station_i); ++it, ++col_i) {
+            CPPUNIT_ASSERT(table(station_i, col_i) == *it);
+        }
+
+        for (; col_i < num_nearest; ++col_i) CPPUNIT_ASSERT(std::isnan(table(station_i, col_i)));
+    }
+}
+
+void
+testFunctions::testSpaceFillingOrder_() {
+
+    /**
+     * Tests that stations on a regular grid are visited cell by cell and
+     * that the original order can be restored.
+     */
+    Stations stations;
+    for (size_t i = 0; i < 256; ++i) stations.push_back(Station(i % 16, i / 16));
+    stations.push_back(Station(NAN, NAN, "missing"));
+
+    vector<size_t> order;
+    Functions::spaceFillingOrder(stations, order);
+
+    // The order is a permutation with the invalid station at the end
+    CPPUNIT_ASSERT(order.size() == stations.size());
+    CPPUNIT_ASSERT(order.back() == 256);
+
+    vector<size_t> sorted(order);
+    sort(sorted.begin(), sorted.end());
+    for (size_t i = 0; i < sorted.size(); ++i) CPPUNIT_ASSERT(sorted[i] == i);
+
+    // Consecutive stations on the curve are adjacent cells
+    for (size_t i = 1; i < 256; ++i) {
+        const Station & prev = stations.getStation(order[i - 1]);
+        const Station & curr = stations.getStation(order[i]);
+        CPPUNIT_ASSERT(fabs(prev.getX() - curr.getX()) + fabs(prev.getY() - curr.getY()) == 1);
+    }
+
+    // Values of reordered stations are moved back to their original positions
+    Array4DPointer arr(2, stations.size(), 3, 1);
+    for (size_t i = 0; i < stations.size(); ++i) {
+        for (size_t j = 0; j < 2; ++j) {
+            for (size_t k = 0; k < 3; ++k) arr.setValue(order[i] * 10 + k, j, i, k, 0);
+        }
+    }
+
+    Functions::permute(arr, 1, order);
+
+    for (size_t i = 0; i < stations.size(); ++i) {
+        for (size_t j = 0; j < 2; ++j) {
+            for (size_t k = 0; k < 3; ++k) CPPUNIT_ASSERT(arr.getValue(j, i, k, 0) == i * 10 + k);
+        }
+    }
+}
+
 void
 testFunctions::testComputeObservationTimeIndices1_() {
 
@@ -243,6 +336,33 @@ testFunctions::testComputeObservationTimeIndices2_() {
     }
 }
 
+void
+testFunctions::testMapTimes_() {
+
+    /**
+     * Test the function of mapTimes() with missing observation times
+     * in both sorted and unsorted forecast times.
+     */
+    Times fcst_times, unsorted_times, flts, obs_times;
+    assign::push_back(fcst_times.left)(0, 0)(1, 10)(2, 20);
+    assign::push_back(unsorted_times.left)(0, 20)(1, 0)(2, 10);
+    assign::push_back(flts.left)(0, 0)(1, 1)(2, 2);
+    assign::push_back(obs_times.left)(0, 0)(1, 2)(2, 10)(3, 11)(4, 12)(5, 21);
+
+    vector<size_t> fcst_times_index = {0, 2}, mapping;
+    Functions::mapTimes(fcst_times, fcst_times_index, flts, obs_times, mapping);
+
+    size_t npos = Times::_NPOS;
+    vector<size_t> expected = {0, npos, 1, npos, 5, npos};
+    CPPUNIT_ASSERT(mapping == expected);
+
+    fcst_times_index = {0, 1};
+    Functions::mapTimes(unsorted_times, fcst_times_index, flts, obs_times, mapping);
+
+    expected = {npos, 5, npos, 0, npos, 1};
+    CPPUNIT_ASSERT(mapping == expected);
+}
+
 void
 testFunctions::testCollapseLeadTimes_() {
 
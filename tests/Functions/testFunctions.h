@@ -15,8 +15,11 @@ class testFunctions : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST_SUITE(testFunctions);
 
     CPPUNIT_TEST(testSearchStations_);
+    CPPUNIT_TEST(testNeighbors_);
+    CPPUNIT_TEST(testSpaceFillingOrder_);
     CPPUNIT_TEST(testComputeObservationTimeIndices1_);
     CPPUNIT_TEST(testComputeObservationTimeIndices2_);
+    CPPUNIT_TEST(testMapTimes_);
     CPPUNIT_TEST(testCollapseLeadTimes_);
     CPPUNIT_TEST(testUnwrapTimeSeries_);
     CPPUNIT_TEST(testConvertToIndex_);
@@ -40,8 +43,11 @@ public:
 private:
 
     void testSearchStations_();
+    void testNeighbors_();
+    void testSpaceFillingOrder_();
     void testComputeObservationTimeIndices1_();
     void testComputeObservationTimeIndices2_();
+    void testMapTimes_();
     void testCollapseLeadTimes_();
     void testUnwrapTimeSeries_();
     void testConvertToIndex_();
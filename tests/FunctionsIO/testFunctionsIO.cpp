@@ -5,7 +5,8 @@
  * Created on Feb 10, 2020, 12:19:11 PM
  */
 
-#include <boost/bimap/bimap.hpp>
+#include <fstream>
+#include <boost/filesystem.hpp>
 
 #include "FunctionsIO.h"
 #include "ForecastsPointer.h"
@@ -18,7 +19,6 @@ CPPUNIT_TEST_SUITE_REGISTRATION(testFunctionsIO);
 
 using namespace std;
 using namespace boost;
-using namespace boost::bimaps;
 using namespace boost::xpressive;
 
 testFunctionsIO::testFunctionsIO() {
@@ -66,3 +66,117 @@ testFunctionsIO::testParseFilename() {
     CPPUNIT_ASSERT(time.timestamp == 24 * 3600 + 11 * 3600);
     CPPUNIT_ASSERT(flt.timestamp == 2 * 3600);
 }
+
+void
+testFunctionsIO::testParseFilenames() {
+
+    /**
+     * This function tests whether unique times and lead times are extracted
+     * in order from a list of file names
+     */
+    string regex_str = ".*nam_218_(?P<day>\\d{8})_(?P<cycle>\\d{2})\\d{2}_(?P<flt>\\d{3})\\.grb2$";
+    vector<string> files = {
+        "Desktop/nam_218_19700102_0000_001.grb2",
+        "Desktop/nam_218_19700102_0000_000.grb2",
+        "Desktop/nam_218_19700102_1200_001.grb2",
+        "Desktop/nam_218_19700101_1200_000.grb2",
+        "Desktop/readme.txt"
+    };
+
+    sort(files.begin(), files.end());
+
+    // Check file-wise results
+    vector<Time> file_times, file_flts;
+    vector<char> parsed;
+    FunctionsIO::parseFilenames(file_times, file_flts, parsed, files, regex_str, 3600, false);
+
+    CPPUNIT_ASSERT(parsed.size() == files.size());
+    CPPUNIT_ASSERT(parsed[0] && parsed[1] && parsed[2] && parsed[3]);
+    CPPUNIT_ASSERT(!parsed[4]);
+    CPPUNIT_ASSERT(file_times[0].timestamp == 12 * 3600);
+    CPPUNIT_ASSERT(file_flts[2].timestamp == 3600);
+
+    // Check unique results
+    Times times, flts;
+    FunctionsIO::parseFilenames(times, flts, files, regex_str, 3600, false);
+
+    CPPUNIT_ASSERT(times.size() == 3);
+    CPPUNIT_ASSERT(times.getTime(0).timestamp == 12 * 3600);
+    CPPUNIT_ASSERT(times.getTime(1).timestamp == 24 * 3600);
+    CPPUNIT_ASSERT(times.getTime(2).timestamp == 36 * 3600);
+
+    CPPUNIT_ASSERT(flts.size() == 2);
+    CPPUNIT_ASSERT(flts.getTime(0).timestamp == 0);
+    CPPUNIT_ASSERT(flts.getTime(1).timestamp == 3600);
+}
+
+void
+testFunctionsIO::testFingerprint() {
+
+    /**
+     * Fingerprints should change with the description and the input files
+     */
+    string file = "fingerprint_test.txt";
+
+    ofstream ofs(file);
+    ofs << "forecasts" << endl;
+    ofs.close();
+
+    string fingerprint = FunctionsIO::fingerprint("num_analogs: 11", {file});
+
+    CPPUNIT_ASSERT(fingerprint.size() == 16);
+    CPPUNIT_ASSERT(fingerprint == FunctionsIO::fingerprint("num_analogs: 11", {file}));
+    CPPUNIT_ASSERT(fingerprint != FunctionsIO::fingerprint("num_analogs: 15", {file}));
+    CPPUNIT_ASSERT(fingerprint != FunctionsIO::fingerprint("num_analogs: 11"));
+
+    // The file size changes
+    ofs.open(file, ofstream::app);
+    ofs << "more forecasts" << endl;
+    ofs.close();
+
+    CPPUNIT_ASSERT(fingerprint != FunctionsIO::fingerprint("num_analogs: 11", {file}));
+
+    remove(file.c_str());
+    CPPUNIT_ASSERT_THROW(FunctionsIO::fingerprint("num_analogs: 11", {file}), runtime_error);
+}
+
+void
+testFunctionsIO::testManifest() {
+
+    /**
+     * Manifests should be used only when they are complete
+     */
+    string folder = "manifest_test", manifest = "manifest_test.txt";
+    boost::filesystem::create_directory(folder);
+
+    for (const string & name : {"a.grb2", "b.grb2", "c.txt"}) {
+        ofstream ofs(folder + "/" + name);
+        ofs << name << endl;
+    }
+
+    vector<string> files, cached;
+    FunctionsIO::listFiles(files, folder, ".*\\.grb2$", manifest);
+    CPPUNIT_ASSERT(files.size() == 2);
+
+    CPPUNIT_ASSERT(FunctionsIO::readManifest(cached, manifest, folder, ".*\\.grb2$"));
+    CPPUNIT_ASSERT(cached == files);
+    CPPUNIT_ASSERT(!FunctionsIO::readManifest(cached, manifest, folder, ".*\\.txt$"));
+
+    // Remove the last entry
+    vector<string> lines;
+    string line;
+    ifstream ifs(manifest);
+    while (getline(ifs, line)) lines.push_back(line);
+    ifs.close();
+
+    ofstream ofs(manifest);
+    for (size_t i = 0; i < lines.size() - 1; ++i) ofs << lines[i] << endl;
+    ofs.close();
+
+    cached.clear();
+    CPPUNIT_ASSERT(!FunctionsIO::readManifest(cached, manifest, folder, ".*\\.grb2$"));
+    CPPUNIT_ASSERT(cached.empty());
+
+    remove(manifest.c_str());
+    boost::filesystem::remove_all(folder);
+}
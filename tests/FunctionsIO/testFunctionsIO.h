@@ -20,6 +20,9 @@ class testFunctionsIO : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST_SUITE(testFunctionsIO);
 
     CPPUNIT_TEST(testParseFilename);
+    CPPUNIT_TEST(testParseFilenames);
+    CPPUNIT_TEST(testFingerprint);
+    CPPUNIT_TEST(testManifest);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -29,6 +32,9 @@ public:
 
 private:
     void testParseFilename();
+    void testParseFilenames();
+    void testFingerprint();
+    void testManifest();
 };
 
 #endif /* TESTFUNCTIONSIO_H */
@@ -0,0 +1,75 @@
+/*
+ * File:   testNcdf.cpp
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#include "testNcdf.h"
+#include "Ncdf.h"
+#include "Config.h"
+
+#include <boost/filesystem.hpp>
+
+using namespace std;
+using namespace netCDF;
+
+namespace filesys = boost::filesystem;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testNcdf);
+
+testNcdf::testNcdf() {
+}
+
+testNcdf::~testNcdf() {
+}
+
+void
+testNcdf::testChunkLimit_() {
+    /**
+     * Test that chunks along stations are split when they reach the 4 GiB
+     * limit of HDF5. Values are never written so the file stays small.
+     */
+    string file = (filesys::temp_directory_path() / filesys::unique_path("%%%%-%%%%.nc")).string();
+
+    Ncdf::Storage storage;
+    storage.chunk_stations = 10;
+
+    {
+        NcFile nc(file, NcFile::FileMode::newFile, NcFile::FileFormat::nc4);
+
+        // A chunk of 10 stations with all other values takes 80 GB
+        Ncdf::addArray4D(nc, Config::_DATA,
+                {Config::_DIM_PARS, Config::_DIM_STATIONS, Config::_DIM_TIMES, Config::_DIM_FLTS},
+                {10, 100, 100000, 1000}, {false, false, false, false}, storage);
+
+        // A chunk of 10 stations with all other values takes 80 MB
+        Ncdf::addArray4D(nc, "small",
+                {Config::_DIM_PARS, Config::_DIM_STATIONS, Config::_DIM_TIMES, "small_flts"},
+                {10, 100, 100000, 1}, {false, false, false, false}, storage);
+    }
+
+    NcFile nc(file, NcFile::FileMode::read);
+    NcVar::ChunkMode chunk_mode;
+    vector<size_t> chunk_sizes;
+
+    // Dimensions are reversed in the file: [flts, times, stations, parameters]
+    nc.getVar(Config::_DATA).getChunkingParameters(chunk_mode, chunk_sizes);
+    CPPUNIT_ASSERT(chunk_mode == NcVar::nc_CHUNKED);
+    CPPUNIT_ASSERT(chunk_sizes[0] == 1000);
+    CPPUNIT_ASSERT(chunk_sizes[1] < 100000);
+    CPPUNIT_ASSERT(chunk_sizes[2] == 10);
+    CPPUNIT_ASSERT(chunk_sizes[3] == 10);
+
+    size_t chunk_bytes = sizeof(double);
+    for (auto len : chunk_sizes) chunk_bytes *= len;
+    CPPUNIT_ASSERT(chunk_bytes < 4294967296);
+
+    // Small chunks are not changed
+    nc.getVar("small").getChunkingParameters(chunk_mode, chunk_sizes);
+    CPPUNIT_ASSERT(chunk_sizes[0] == 1);
+    CPPUNIT_ASSERT(chunk_sizes[1] == 100000);
+    CPPUNIT_ASSERT(chunk_sizes[2] == 10);
+    CPPUNIT_ASSERT(chunk_sizes[3] == 10);
+
+    nc.close();
+    filesys::remove(file);
+}
@@ -0,0 +1,28 @@
+/*
+ * File:   testNcdf.h
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#ifndef TESTNCDF_H
+#define TESTNCDF_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class testNcdf : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(testNcdf);
+    
+    CPPUNIT_TEST(testChunkLimit_);
+    
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    testNcdf();
+    virtual ~testNcdf();
+    
+    void testChunkLimit_();
+
+private:
+    
+};
+
+#endif /* TESTNCDF_H */
@@ -18,7 +18,6 @@
 #include <boost/assign/list_inserter.hpp>
 
 using namespace std;
-using namespace boost::bimaps;
 using namespace boost;
 
 CPPUNIT_TEST_SUITE_REGISTRATION(testObservationsPointer);
@@ -139,3 +138,39 @@ testObservationsPointer::testSubset_() {
                 CPPUNIT_ASSERT(subset_value == original_value);
             }
 }
+
+void
+testObservationsPointer::testCopyOnWrite_() {
+
+    /**
+     * Test that copies share memory until one of them is modified
+     */
+    Stations stations;
+    assign::push_back(stations.left)(0, Station(10, 20))(1, Station(30, 40));
+
+    Parameters parameters;
+    assign::push_back(parameters.left)(0, Parameter("temperature"))(1, Parameter("humidity"));
+
+    Times times;
+    for (size_t i = 0; i < 5; ++i) times.push_back(Time(i + 1));
+
+    ObservationsPointer observations(parameters, stations, times);
+    iota(observations.getValuesPtr(), observations.getValuesPtr() + observations.num_elements(), 0);
+
+    const ObservationsPointer & observations_const = observations;
+    ObservationsPointer observations_copy = observations;
+    const ObservationsPointer & observations_copy_const = observations_copy;
+    CPPUNIT_ASSERT(observations_const.getValuesPtr() == observations_copy_const.getValuesPtr());
+
+    // Modifying the copy should not change the original
+    observations_copy.setValue(-1, 1, 1, 3);
+    CPPUNIT_ASSERT(observations_const.getValuesPtr() != observations_copy_const.getValuesPtr());
+    CPPUNIT_ASSERT(observations.getValue(1, 1, 3) != -1);
+    CPPUNIT_ASSERT(observations_copy.getValue(1, 1, 3) == -1);
+
+    // Modifying the original should not change the copy
+    ObservationsPointer observations_copy2 = observations;
+    observations.setValue(-2, 0, 1, 4);
+    CPPUNIT_ASSERT(observations.getValue(0, 1, 4) == -2);
+    CPPUNIT_ASSERT(observations_copy2.getValue(0, 1, 4) != -2);
+}
@@ -15,6 +15,7 @@ class testObservationsPointer : public CPPUNIT_NS::TestFixture {
 
     CPPUNIT_TEST(testObservationValueSequence_);
     CPPUNIT_TEST(testSubset_);
+    CPPUNIT_TEST(testCopyOnWrite_);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -25,6 +26,7 @@ public:
 private:
     void testObservationValueSequence_();
     void testSubset_();
+    void testCopyOnWrite_();
 };
 
 #endif /* TESTOBSERVATIONSPOINTER_H */
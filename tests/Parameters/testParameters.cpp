@@ -12,7 +12,6 @@
 #include "boost/assign/list_inserter.hpp"
 
 using namespace std;
-using namespace boost::bimaps;
 using namespace boost;
 
 CPPUNIT_TEST_SUITE_REGISTRATION(testParameters);
@@ -17,7 +17,6 @@
 #include "boost/assign/list_inserter.hpp"
 
 using namespace std;
-using namespace boost::bimaps;
 using namespace boost;
 
 CPPUNIT_TEST_SUITE_REGISTRATION(testStations);
@@ -119,3 +118,42 @@ void testStations::testSubset_() {
     CPPUNIT_ASSERT(indices[0] == 0);
     CPPUNIT_ASSERT(indices[1] == 3);
 }
+
+void testStations::testFind_() {
+
+    /*
+     * Test looking up stations on a grid, including misses and shrinking.
+     */
+    Stations stations;
+    stations.reserve(10000);
+
+    for (size_t row = 0; row < 100; ++row)
+        for (size_t col = 0; col < 100; ++col)
+            stations.push_back(Station(col * 0.5, row * 0.25));
+
+    CPPUNIT_ASSERT(stations.size() == 10000);
+
+    // Duplicates are ignored
+    stations.push_back(Station(0, 0));
+    CPPUNIT_ASSERT(stations.size() == 10000);
+
+    for (size_t i = 0; i < stations.size(); i += 37) {
+        CPPUNIT_ASSERT(stations.find(stations.getStation(i)) == i);
+        CPPUNIT_ASSERT(stations.getIndex(stations.getStation(i)) == i);
+    }
+
+    // Stations at the same location with different names are different
+    CPPUNIT_ASSERT(stations.find(Station(0.5, 0.25, "other")) == Stations::_NPOS);
+    CPPUNIT_ASSERT(stations.find(Station(-0.0, 0.0)) == 0);
+    CPPUNIT_ASSERT(stations.find(Station(1000, 1000)) == Stations::_NPOS);
+    CPPUNIT_ASSERT_THROW(stations.getIndex(Station(1000, 1000)), range_error);
+
+    // Shrinking removes stations from lookup
+    Station last = stations.getStation(9999);
+    stations.resize(10);
+    CPPUNIT_ASSERT(stations.find(last) == Stations::_NPOS);
+    CPPUNIT_ASSERT(stations.find(stations.getStation(9)) == 9);
+
+    stations.clear();
+    CPPUNIT_ASSERT(stations.find(last) == Stations::_NPOS);
+}
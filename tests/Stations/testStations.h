@@ -16,6 +16,7 @@ class testStations : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST(testShift_);
     CPPUNIT_TEST(testUnique_);
     CPPUNIT_TEST(testSubset_);
+    CPPUNIT_TEST(testFind_);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -27,6 +28,7 @@ private:
     void testShift_();
     void testUnique_();
     void testSubset_();
+    void testFind_();
 };
 
 #endif /* TESTSTATIONS_H */
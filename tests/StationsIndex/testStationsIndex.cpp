@@ -0,0 +1,137 @@
+/*
+ * File:   testStationsIndex.cpp
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#include <cppunit/TestAssert.h>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+
+#include "testStationsIndex.h"
+#include "StationsIndex.h"
+
+using namespace std;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(testStationsIndex);
+
+testStationsIndex::testStationsIndex() {
+}
+
+testStationsIndex::~testStationsIndex() {
+}
+
+void
+testStationsIndex::testNearest_() {
+
+    /*
+     * Test finding the nearest stations with invalid coordinates,
+     * ties, and a distance threshold
+     */
+    Stations stations;
+    stations.push_back(Station(0, 0, "s0"));
+    stations.push_back(Station(1, NAN, "s1"));
+    stations.push_back(Station(2, 0, "s2"));
+    stations.push_back(Station(0, 2, "s3"));
+    stations.push_back(Station(5, 5, "s4"));
+
+    StationsIndex index(stations);
+    CPPUNIT_ASSERT(index.size() == 4);
+
+    CPPUNIT_ASSERT(index.nearest(Station(0.9, 0.1)) == 0);
+    CPPUNIT_ASSERT(index.nearest(Station(4, 4)) == 4);
+    CPPUNIT_ASSERT(index.nearest(Station(NAN, 0)) == StationsIndex::_NPOS);
+
+    // Station 0, 2, and 3 are equally close
+    vector<StationsIndex::Neighbor> neighbors;
+    index.nearest(Station(1, 1), 2, neighbors);
+
+    CPPUNIT_ASSERT(neighbors.size() == 2);
+    CPPUNIT_ASSERT(neighbors[0].second == 0);
+    CPPUNIT_ASSERT(neighbors[1].second == 2);
+    CPPUNIT_ASSERT(fabs(neighbors[0].first - sqrt(2)) < 1e-10);
+
+    // Only stations within the distance are returned
+    index.nearest(Station(0, 0), 10, neighbors, 2);
+
+    CPPUNIT_ASSERT(neighbors.size() == 3);
+    CPPUNIT_ASSERT(neighbors[0].second == 0);
+    CPPUNIT_ASSERT(neighbors[1].second == 2);
+    CPPUNIT_ASSERT(neighbors[2].second == 3);
+
+    // An empty index
+    StationsIndex empty_index;
+    CPPUNIT_ASSERT(empty_index.nearest(Station(0, 0)) == StationsIndex::_NPOS);
+}
+
+void
+testStationsIndex::testBruteForce_() {
+
+    /*
+     * Test the index against computing all distances on a regular grid
+     * with many equal distances
+     */
+    Stations stations;
+    for (size_t i = 0; i < 600; ++i) stations.push_back(Station(i % 23, i / 23));
+
+    StationsIndex index(stations);
+
+    srand(1);
+    vector<StationsIndex::Neighbor> neighbors, expected;
+
+    for (size_t query_i = 0; query_i < 200; ++query_i) {
+
+        Station query((rand() % 500) / 20.0, (rand() % 600) / 20.0);
+        size_t k = 1 + rand() % 12;
+
+        expected.clear();
+        for (size_t station_i = 0; station_i < stations.size(); ++station_i) {
+            const Station & station = stations.getStation(station_i);
+            double distance = sqrt(pow(station.getX() - query.getX(), 2) + pow(station.getY() - query.getY(), 2));
+            expected.push_back(make_pair(distance, station_i));
+        }
+
+        sort(expected.begin(), expected.end());
+        expected.resize(k);
+
+        index.nearest(query, k, neighbors);
+
+        CPPUNIT_ASSERT(neighbors.size() == k);
+        for (size_t i = 0; i < k; ++i) {
+            CPPUNIT_ASSERT(neighbors[i].second == expected[i].second);
+            CPPUNIT_ASSERT(fabs(neighbors[i].first - expected[i].first) < 1e-10);
+        }
+    }
+}
+
+void
+testStationsIndex::testGreatCircle_() {
+
+    /*
+     * Test the great circle metric across the date line and near the pole
+     */
+    Stations stations;
+    stations.push_back(Station(179.5, 0, "s0"));
+    stations.push_back(Station(-179.8, 0, "s1"));
+    stations.push_back(Station(0, 89.9, "s2"));
+    stations.push_back(Station(170, 0, "s3"));
+
+    StationsIndex index(stations, StationsIndex::Metric::GreatCircle);
+    CPPUNIT_ASSERT(index.getMetric() == StationsIndex::Metric::GreatCircle);
+
+    // Longitude wraps around, so station 1 is the closest
+    CPPUNIT_ASSERT(index.nearest(Station(-179.9, 0)) == 1);
+
+    // Meridians converge at the pole
+    CPPUNIT_ASSERT(index.nearest(Station(180, 89.95)) == 2);
+
+    // One degree on the equator is about 111 km
+    vector<StationsIndex::Neighbor> neighbors;
+    index.nearest(Station(-179, 0), 4, neighbors, 500);
+
+    CPPUNIT_ASSERT(neighbors.size() == 2);
+    CPPUNIT_ASSERT(neighbors[0].second == 1);
+    CPPUNIT_ASSERT(neighbors[1].second == 0);
+    CPPUNIT_ASSERT(fabs(neighbors[1].first - 1.5 * M_PI / 180 * StationsIndex::_EARTH_RADIUS) < 1e-6);
+}
@@ -0,0 +1,30 @@
+/*
+ * File:   testStationsIndex.h
+ * Author: Weiming Hu <weiming@psu.edu>
+ */
+
+#ifndef TESTSTATIONSINDEX_H
+#define TESTSTATIONSINDEX_H
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class testStationsIndex : public CPPUNIT_NS::TestFixture {
+    CPPUNIT_TEST_SUITE(testStationsIndex);
+
+    CPPUNIT_TEST(testNearest_);
+    CPPUNIT_TEST(testBruteForce_);
+    CPPUNIT_TEST(testGreatCircle_);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    testStationsIndex();
+    virtual ~testStationsIndex();
+
+private:
+    void testNearest_();
+    void testBruteForce_();
+    void testGreatCircle_();
+};
+
+#endif /* TESTSTATIONSINDEX_H */
@@ -15,7 +15,6 @@
 #include "Functions.h"
 
 using namespace std;
-using namespace boost::bimaps;
 using namespace boost;
 
 CPPUNIT_TEST_SUITE_REGISTRATION(testTimes);